@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+
+#include "GameCreator.hpp"
+#include "GameMatrix.hpp"
+#include "Tetromino.hpp"
+
+#include <array>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// same size as the boards of GameCreator
+static constexpr int BOARD_WIDTH = 10;
+static constexpr int BOARD_HEIGHT = 22;
+
+// a board in the middle of a game : the bottom half filled, one hole per line
+// so nothing gets cleared by accident
+static GameMatrix halfFilledMatrix() {
+    GameMatrix matrix(BOARD_WIDTH, BOARD_HEIGHT);
+    tetroMat &board = matrix.getBoard();
+    for (int y = BOARD_HEIGHT / 2; y < BOARD_HEIGHT; ++y) {
+        for (int x = 0; x < BOARD_WIDTH; ++x) {
+            board[y][x] = (x == y % BOARD_WIDTH) ? 0 : static_cast<int>(PieceType::Single);
+        }
+    }
+    return matrix;
+}
+
+static void BM_CanMove(benchmark::State &state) {
+    GameMatrix matrix = halfFilledMatrix();
+    const Tetromino piece({BOARD_WIDTH / 2 - 1, BOARD_HEIGHT / 2 - 3}, PieceType::T);
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(matrix.canMove(piece, 0, 1));
+    }
+}
+BENCHMARK(BM_CanMove);
+
+static void BM_InstantFall(benchmark::State &state) {
+    // from the top of the board to the stack, the piece is put back up for
+    // the next iteration (setCurrent is part of the measure)
+    GameMatrix matrix = halfFilledMatrix();
+    const Tetromino piece({BOARD_WIDTH / 2 - 1, 0}, PieceType::I);
+
+    for (auto _: state) {
+        matrix.setCurrent(piece);
+        benchmark::DoNotOptimize(matrix.tryInstantFall());
+    }
+}
+BENCHMARK(BM_InstantFall);
+
+static void BM_ClearFullLines(benchmark::State &state) {
+    // [range(0)] full lines at the bottom of a half filled board
+    const int fullLines = static_cast<int>(state.range(0));
+    GameMatrix reference = halfFilledMatrix();
+    for (int i = 0; i < fullLines; ++i) {
+        reference.getBoard()[BOARD_HEIGHT - 1 - i].assign(
+            BOARD_WIDTH, static_cast<int>(PieceType::Single));
+    }
+
+    GameMatrix matrix = reference;
+    for (auto _: state) {
+        state.PauseTiming();
+        matrix.getBoard() = reference.getBoard();
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(matrix.clearFullLines());
+    }
+}
+BENCHMARK(BM_ClearFullLines)->Arg(0)->Arg(1)->Arg(4);
+
+static void BM_PushPenaltyLines(benchmark::State &state) {
+    // the board stays full of penalty lines, every push shifts all of it
+    GameMatrix matrix = halfFilledMatrix();
+    const int lines = static_cast<int>(state.range(0));
+    std::mt19937 random(42);
+
+    for (auto _: state) {
+        matrix.pushPenaltyLinesAtBottom(lines, random);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_PushPenaltyLines)->Arg(1)->Arg(4);
+
+static void BM_TetrominoRotateShape(benchmark::State &state) {
+    const Tetromino piece(static_cast<PieceType>(state.range(0)));
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(piece.getRotateShape(Action::RotateRight));
+    }
+}
+BENCHMARK(BM_TetrominoRotateShape)
+    ->Arg(static_cast<int>(PieceType::I))
+    ->Arg(static_cast<int>(PieceType::T));
+
+static void BM_TryRotateCurrent(benchmark::State &state) {
+    // a T in the middle of an empty board, rotated one way then the other
+    GameMatrix matrix(BOARD_WIDTH, BOARD_HEIGHT);
+    matrix.setCurrent(Tetromino({BOARD_WIDTH / 2 - 1, BOARD_HEIGHT / 2}, PieceType::T));
+
+    bool clockwise = true;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(matrix.tryRotateCurrent(clockwise));
+        clockwise = !clockwise;
+    }
+}
+BENCHMARK(BM_TryRotateCurrent);
+
+static void BM_HandlingRoutine(benchmark::State &state) {
+    // one tick of a whole game : the engine runs once for every board, then
+    // the effects they had on each other are applied, like Game::updateGame
+    // does every GAME_UPDATE_INTERVAL. the players drop
+    // their pieces left and right. the games are started again as soon as a
+    // board tops out, so every measured tick has all the boards playing (a
+    // lost board costs nothing)
+
+    const auto gameMode = static_cast<GameMode>(state.range(0));
+    const int playerCount = static_cast<int>(state.range(1));
+
+    std::vector<std::string> players;
+    for (int i = 0; i < playerCount; ++i) {
+        players.push_back("player-" + std::to_string(i));
+    }
+
+    const std::shared_ptr<GameEngine> engine = GameCreator::createEngine(gameMode);
+    auto games = GameCreator::createGames(gameMode, players);
+
+    constexpr std::array actions = {
+        Action::MoveLeft, Action::MoveLeft, Action::RotateRight, Action::InstantFall,
+        Action::None, Action::MoveRight, Action::MoveRight, Action::InstantFall,
+    };
+    EffectQueue effects;
+    std::size_t tick = 0;
+
+    for (auto _: state) {
+        bool anyOver = false;
+        for (const auto &[token, game]: games) {
+            engine->handlingRoutine(*game, actions[tick % actions.size()]);
+            effects.collect(*game);
+        }
+        effects.apply();
+        for (const auto &[token, game]: games) {
+            anyOver = anyOver || game->isGameOver();
+        }
+        ++tick;
+
+        if (anyOver) {
+            state.PauseTiming();
+            games = GameCreator::createGames(gameMode, players);
+            state.ResumeTiming();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * playerCount);
+}
+BENCHMARK(BM_HandlingRoutine)
+    ->ArgNames({"mode", "players"})
+    ->Args({static_cast<int>(GameMode::ENDLESS), 1})
+    ->Args({static_cast<int>(GameMode::DUEL), DUAL_LOBBY_SIZE})
+    ->Args({static_cast<int>(GameMode::CLASSIC), MAX_LOBBY_SIZE})
+    ->Args({static_cast<int>(GameMode::ROYALE), MAX_LOBBY_SIZE});
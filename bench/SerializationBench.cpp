@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+
+#include "GameState.hpp"
+#include "KeyStroke.hpp"
+#include "ServerRequest.hpp"
+#include "ServerResponse.hpp"
+
+#include <string>
+
+// what a player gets every poll : both boards half full, a piece falling
+static PlayerState busyPlayerState() {
+    PlayerState state = PlayerState::generateEmptyState();
+    state.playerUsername = "player-0";
+    state.targetUsername = "player-1";
+    state.gameMode = GameMode::ROYALE;
+    state.playerGrid = tetroMat(22, std::vector<int>(10, 0));
+    for (int y = 11; y < 22; ++y) {
+        for (int x = 0; x < 10; ++x) {
+            state.playerGrid[y][x] = (x + y) % 8;
+        }
+    }
+    state.targetGrid = state.playerGrid;
+    state.currentTetro = PieceType::T;
+    state.currentPosition = {4, 2};
+    state.currentShape = {{false, true, false}, {true, true, true}, {false, false, false}};
+    state.playerScore = 12345;
+    state.playerLevel = 7;
+    state.playerLines = 64;
+    state.playerEnergy = 40;
+    state.lastInputSequence = 1024;
+    return state;
+}
+
+// what a player sends for every key press
+static ServerRequest keyStrokeRequest() {
+    KeyStrokePacket packet;
+    packet.action = Action::MoveLeft;
+    packet.token = "0123456789abcdef0123456789abcdef";
+    packet.sequence = 1024;
+
+    ServerRequest request;
+    request.id = 42;
+    request.method = ServerMethods::KEY_STROKE;
+    request.params["token"] = packet.token;
+    request.params["keystroke"] = packet.serialize();
+    return request;
+}
+
+static void BM_PlayerStateSerialize(benchmark::State &state) {
+    const PlayerState playerState = busyPlayerState();
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(playerState.serialize());
+    }
+}
+BENCHMARK(BM_PlayerStateSerialize);
+
+static void BM_PlayerStateDeserialize(benchmark::State &state) {
+    const std::string data = busyPlayerState().serialize();
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(PlayerState::deserialize(data));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_PlayerStateDeserialize);
+
+static void BM_GameStateResponseSerialize(benchmark::State &state) {
+    // the state goes out wrapped in a response, serialized a second time
+    const std::string gameState = busyPlayerState().serialize();
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(ServerResponse::SuccessResponse(
+            42, StatusCode::SUCCESS, {{"gamestate", gameState}}).serialize());
+    }
+}
+BENCHMARK(BM_GameStateResponseSerialize);
+
+static void BM_ServerRequestSerialize(benchmark::State &state) {
+    const ServerRequest request = keyStrokeRequest();
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(request.serialize());
+    }
+}
+BENCHMARK(BM_ServerRequestSerialize);
+
+static void BM_ServerRequestDeserialize(benchmark::State &state) {
+    const std::string data = keyStrokeRequest().serialize();
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(ServerRequest::deserialize(data));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_ServerRequestDeserialize);
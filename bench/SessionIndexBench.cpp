@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include "LobbyServer.hpp"
+#include "PresenceIndex.hpp"
+
+#include <string>
+#include <vector>
+
+// the lobby server with [count] sessions, none of them in a lobby yet. the
+// server is never started, the session calls don't need the socket
+static void fillSessions(LobbyServer &server, const int count) {
+    for (int i = 0; i < count; ++i) {
+        (void) server.addClientSession("token-" + std::to_string(i),
+                                       "player-" + std::to_string(i));
+    }
+}
+
+static void BM_AddClientSession(benchmark::State &state) {
+    const int sessions = static_cast<int>(state.range(0));
+    LobbyServer server("127.0.0.1", LOBBY_SERVER_PORT, sessions + 1);
+    fillSessions(server, sessions);
+
+    // the same user logging in again and again : the old session is replaced
+    int i = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(
+            server.addClientSession("relog-" + std::to_string(i++), "player-0"));
+    }
+}
+BENCHMARK(BM_AddClientSession)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_GetClientSessionUsername(benchmark::State &state) {
+    const int sessions = static_cast<int>(state.range(0));
+    LobbyServer server("127.0.0.1", LOBBY_SERVER_PORT, sessions);
+    fillSessions(server, sessions);
+
+    const std::string token = "token-" + std::to_string(sessions / 2);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(server.getClientSessionUsername(token));
+    }
+}
+BENCHMARK(BM_GetClientSessionUsername)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_GetClientSessionToken(benchmark::State &state) {
+    const int sessions = static_cast<int>(state.range(0));
+    LobbyServer server("127.0.0.1", LOBBY_SERVER_PORT, sessions);
+    fillSessions(server, sessions);
+
+    const std::string username = "player-" + std::to_string(sessions - 1);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(server.getClientSessionToken(username));
+    }
+}
+BENCHMARK(BM_GetClientSessionToken)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_GetStatusBatch(benchmark::State &state) {
+    // a friends list of MAX_STATUS_BATCH players among 10k sessions
+    PresenceIndex presence;
+    for (int i = 0; i < 10000; ++i) {
+        (void) presence.addSession("token-" + std::to_string(i),
+                                   "player-" + std::to_string(i), 10000);
+    }
+
+    std::vector<std::string> friends;
+    for (int i = 0; i < MAX_STATUS_BATCH; ++i) {
+        friends.push_back("player-" + std::to_string(i * 300));
+    }
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(presence.getStatuses(friends));
+    }
+}
+BENCHMARK(BM_GetStatusBatch);
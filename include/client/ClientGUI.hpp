@@ -2,6 +2,7 @@
 
 #include <iostream>
 
+#include "BackgroundCache.hpp"
 #include "LoginScreenGUI.hpp"
 #include <QApplication>
 
@@ -0,0 +1,152 @@
+#ifndef LOAD_GEN_HPP
+#define LOAD_GEN_HPP
+
+#include "Common.hpp"
+#include "GameRequestManager.hpp"
+#include "ServerResponse.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+// Headless clients for capacity planning : N bots connect to a local lobby
+// server, fill lobbies of every game mode, ready up and play (random or
+// scripted inputs) until the time is up. Every request is timed, the report
+// gives the latency percentiles per ServerMethods and how many requests were
+// dropped or timed out.
+
+struct LoadGenConfig
+{
+    std::string serverIP = "127.0.0.1";
+    int lobbyServerPort = LOBBY_SERVER_PORT;
+
+    int clients = 20;
+    int durationSec = 30;
+    // key strokes per minute, per bot
+    int apm = 120;
+    // seats of the classic and royale lobbies (duel and endless are fixed)
+    int lobbySize = 4;
+    std::vector<GameMode> gameModes = {GameMode::ENDLESS, GameMode::DUEL,
+                                       GameMode::CLASSIC, GameMode::ROYALE};
+
+    // played in a loop, random inputs if empty
+    std::vector<Action> script;
+    unsigned seed = 0;
+};
+
+// every request of the run, per method
+class LatencyRecorder
+{
+  public:
+    void record(ServerMethods method, std::chrono::microseconds latency,
+                StatusCode status);
+
+    // one line per method : count, percentiles, failures
+    void report(std::ostream& out, std::chrono::milliseconds elapsed) const;
+
+  private:
+    struct MethodStats
+    {
+        // answered requests only, the lost ones have no latency
+        std::vector<std::int64_t> latenciesUs;
+        int errors = 0;   // answered with an error status
+        int timedOut = 0; // sent, no answer in time
+        int dropped = 0;  // never sent
+    };
+
+    mutable std::mutex statsMutex;
+    std::map<ServerMethods, MethodStats> stats;
+};
+
+// the bots that sit at the same lobby. the first seat creates the lobby, the
+// others join it once its id is published. every new lobby gets a new
+// generation, so a bot never joins the same lobby twice
+class BotTable
+{
+  public:
+    BotTable(GameMode gameMode, int seats);
+
+    [[nodiscard]] GameMode getGameMode() const;
+    [[nodiscard]] int getSeats() const;
+
+    void publishLobby(const std::string& lobbyID);
+
+    // the id of a lobby newer than [generation] (which is updated), empty if
+    // none came in time
+    [[nodiscard]] std::string waitForLobby(int& generation,
+                                           std::chrono::milliseconds timeout);
+
+    // wakes up the bots that are waiting, the run is over
+    void close();
+
+  private:
+    GameMode gameMode;
+    int seats;
+
+    std::mutex lobbyMutex;
+    std::condition_variable lobbyCV;
+    std::string lobbyID;
+    int lobbyGeneration = 0;
+    bool closed = false;
+};
+
+class Bot
+{
+  public:
+    Bot(int id, const LoadGenConfig& config, std::shared_ptr<BotTable> table,
+        bool isHost, LatencyRecorder& recorder);
+
+    // until [running] goes false : connect, then lobby, game, lobby, game...
+    void run(const std::atomic_bool& running);
+
+    [[nodiscard]] int getGamesPlayed() const;
+
+  private:
+    // one lobby : create or join it, ready up, wait for the game to start
+    [[nodiscard]] bool playLobby(const std::atomic_bool& running);
+    // one game : inputs at the configured rate, state polls like the clients
+    void playGame(const std::atomic_bool& running);
+
+    [[nodiscard]] Action nextAction();
+
+    // calls the request manager and records how long it took
+    ServerResponse timed(ServerMethods method,
+                         const std::function<ServerResponse()>& request);
+
+    int id;
+    const LoadGenConfig& config;
+    std::shared_ptr<BotTable> table;
+    bool isHost;
+    LatencyRecorder& recorder;
+
+    GameRequestManager requestManager;
+    std::string username;
+    std::string token;
+
+    std::mt19937 random;
+    std::size_t scriptPosition = 0;
+    int sequence = 0;
+    int lobbyGeneration = 0;
+    int gamesPlayed = 0;
+
+    // the real clients poll the lobby and the game this often
+    static constexpr int POLL_INTERVAL_MS = 50;
+    // a lobby that doesn't start by then is left, and a new one is made
+    static constexpr int LOBBY_WAIT_MS = 10000;
+};
+
+// entry point of the load generator
+int main(int argc, char* argv[]);
+
+#endif
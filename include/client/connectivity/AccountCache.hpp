@@ -0,0 +1,52 @@
+#ifndef ACCOUNT_CACHE_HPP
+#define ACCOUNT_CACHE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// accountID <-> userName pairs we already asked the db server about, so the
+// friends list, the chat and the lobby don't look the same names up over and
+// over. it is bounded, the least recently used pair goes away first
+class AccountCache {
+public:
+    explicit AccountCache(std::size_t capacity = DEFAULT_CAPACITY);
+    ~AccountCache() = default;
+
+    [[nodiscard]] std::optional<std::string> findUserName(const std::string &accountID);
+
+    [[nodiscard]] std::optional<std::string> findAccountID(const std::string &userName);
+
+    // both directions are updated, a stale pair using either side is dropped
+    void put(const std::string &accountID, const std::string &userName);
+
+    // to call when a player changed its name
+    void invalidate(const std::string &accountID);
+
+    void clear();
+
+    [[nodiscard]] std::size_t size() const;
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+
+private:
+    using Entry = std::pair<std::string, std::string>; // accountID, userName
+    using EntryList = std::list<Entry>;
+
+    std::size_t capacity;
+
+    // most recently used in front
+    EntryList entries;
+    std::unordered_map<std::string, EntryList::iterator> byAccountID;
+    std::unordered_map<std::string, EntryList::iterator> byUserName;
+    mutable std::mutex cacheMutex;
+
+    void erase(EntryList::iterator it);
+};
+
+#endif // ACCOUNT_CACHE_HPP
@@ -0,0 +1,90 @@
+#ifndef CLIENT_CHANNEL_HPP
+#define CLIENT_CHANNEL_HPP
+
+#include "Common.hpp"
+#include "Fragmentation.hpp"
+#include "ServerRequest.hpp"
+#include "ServerResponse.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// one udp socket talking to one server endpoint (the lobby server, or the
+// lobby / game we are in), with its own receive thread and its own table of
+// requests in flight : answers are matched to requests by id, so traffic to
+// one endpoint can never be taken for an answer from another one
+class ClientChannel
+{
+  public:
+    ClientChannel(const std::string& serverIP, int port);
+    ~ClientChannel();
+
+    ClientChannel(const ClientChannel&) = delete;
+    ClientChannel& operator=(const ClientChannel&) = delete;
+
+    [[nodiscard]] StatusCode open();
+    void close();
+
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] int getPort() const;
+
+    // gives the request its id and sends it. the future is set with the
+    // answer, or with an error once every try timed out (the tries share
+    // CLIENT_TIMEOUT_SEC). only resend requests that don't change anything
+    [[nodiscard]] std::future<ServerResponse> send(ServerRequest& request,
+                                                   int retries = 0);
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    // a request sent and not answered yet
+    struct PendingRequest
+    {
+        std::promise<ServerResponse> promise;
+        std::string payload;
+        Clock::time_point deadline;
+        int attemptTimeoutMs;
+        int retriesLeft;
+    };
+
+    [[nodiscard]] StatusCode transmit(const std::string& payload);
+    void receiveLoop();
+    void expireRequests();
+    void completeRequest(int id, ServerResponse response);
+    void failPendingRequests(StatusCode status);
+    [[nodiscard]] int nextRequestID();
+
+    std::string serverIP;
+    int port;
+    int channelSocket = NO_FILE_DESCRIPTOR;
+
+    // messages too big for one datagram, both ways
+    FragmentReader fragmentReader;
+    FragmentWriter fragmentWriter;
+
+    // requests in flight, by id
+    std::unordered_map<int, PendingRequest> pendingRequests;
+    std::mutex pendingMutex;
+    int lastRequestID = 0;
+
+    std::thread receiveThread;
+    std::atomic_bool receiving{false};
+
+    // how long the receive thread waits for a packet before checking the
+    // timeouts (and whether it should stop)
+    static constexpr int RECEIVE_POLL_MS = 50;
+};
+
+#endif
@@ -1,17 +1,29 @@
 #ifndef CLIENT_SESSION_HPP
 #define CLIENT_SESSION_HPP
 
+#include "AccountCache.hpp"
 #include "Common.hpp"
 #include "DBRequestManager.hpp"
+#include "GameOverview.hpp"
 #include "GameRequestManager.hpp"
 #include "GameState.hpp"
 #include "Config.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <arpa/inet.h>
@@ -20,6 +32,8 @@
 
 class ClientSession {
 public:
+    using NotificationCallback = std::function<void(const Notification &)>;
+
     // public here
     ClientSession(const std::string &server_ip, int lobby_port, int db_port,
                   bool debug = false);
@@ -45,15 +59,17 @@ public:
 
     [[nodiscard]] int getBestScore() const;
 
-    void updateLocalMessages(const std::string &otherAccountID,
-                             const ChatMessage &message);
-
     [[nodiscard]] std::vector<std::string> &getFriendList();
 
     [[nodiscard]] std::vector<std::string> &getPendingFriendRequests();
 
     std::string getAccountIDFromUsername(const std::string &username) const;
 
+    // accountID -> userName for the whole list in one round trip at most, the
+    // ids that don't exist are not in the result
+    [[nodiscard]] std::unordered_map<std::string, std::string>
+    resolveUsernames(const std::vector<std::string> &accountIDs) const;
+
     std::string getFriendUsername(const std::string &friendID);
 
     std::string getRequestUsername(const std::string &requestID);
@@ -78,8 +94,14 @@ public:
 
     [[nodiscard]] std::vector<ChatMessage> getPlayerMessages(const std::string &otherAccountID);
 
+    [[nodiscard]] std::size_t syncMessages(const std::string &otherAccountID);
+
+    [[nodiscard]] std::vector<ChatMessage> getConversation(const std::string &otherAccountID);
+
     [[nodiscard]] std::vector<PlayerScore> getLeaderboard(int limit = 5) const;
 
+    [[nodiscard]] std::vector<PlayerScore> getLeaderboardAroundMe(int around = 2);
+
     [[nodiscard]] StatusCode fetchPlayerData();
 
     [[nodiscard]] StatusCode updatePlayer(const std::string &newName, const std::string &newPassword);
@@ -88,6 +110,13 @@ public:
 
     [[nodiscard]] StatusCode sendMessage(const std::string &receiverID, const std::string &messageContent);
 
+    // Notifications (pushed by the db server, no polling on the caller side)
+    // callbacks are called from the session's notification thread, they
+    // should only hand the notification over to their own thread
+    [[nodiscard]] int subscribeNotifications(NotificationCallback callback);
+
+    void unsubscribeNotifications(int subscriptionID);
+
     // Friend-related operations
     [[nodiscard]] StatusCode sendFriendRequest(const std::string &receiverID);
 
@@ -102,11 +131,19 @@ public:
 
     [[nodiscard]] ClientStatus getClientStatus(const std::string &username);
 
+    // USERNAME -> STATUS, in one round trip (offline when unknown)
+    [[nodiscard]] std::unordered_map<std::string, ClientStatus>
+    getClientStatuses(const std::vector<std::string> &usernames);
+
     [[nodiscard]] StatusCode startSession();
 
     [[nodiscard]] StatusCode endSession();
 
-    [[nodiscard]] std::unordered_map<std::string, std::string> getPublicLobbiesList();
+    // INDEX -> SERIALIZED LOBBY STATE, every page of the listing. the last
+    // listing is kept, so asking again costs a tiny "not modified" answer
+    // until a lobby changes
+    [[nodiscard]] std::unordered_map<std::string, std::string>
+    getPublicLobbiesList(std::optional<GameMode> gameMode = std::nullopt);
 
     [[nodiscard]] StatusCode createAndJoinLobby(GameMode gameMode, int maxPlayers, bool isPublic);
 
@@ -122,10 +159,24 @@ public:
 
     [[nodiscard]] StatusCode unreadyUp();
 
-    [[nodiscard]] StatusCode sendKeyStroke(const Action &action);
+    // the sequence numbers of the key strokes, they keep growing for the
+    // whole session : a game screen opened again must not reuse the numbers
+    // the game server already acknowledged
+    [[nodiscard]] int nextInputSequence();
+
+    // sequence is echoed back in PlayerState::lastInputSequence once applied
+    [[nodiscard]] StatusCode sendKeyStroke(const Action &action, int sequence = 0);
+
+    // all sent at once, then waits for every answer (sequence, action)
+    [[nodiscard]] StatusCode sendKeyStrokes(const std::vector<std::pair<int, Action>> &keyStrokes);
 
     [[nodiscard]] PlayerState getPlayerState();
 
+    [[nodiscard]] StatusCode fetchGameState(std::string &rawState);
+
+    // every board of the game, for the mini-map
+    [[nodiscard]] StatusCode fetchGameOverview(GameOverview &overview);
+
     [[nodiscard]] SpectatorState getSpectatorState();
 
     [[nodiscard]] StatusCode leaveGame();
@@ -135,13 +186,66 @@ private:
     std::string username_;
     std::string accountID_;
     std::string token_;
+    mutable std::mutex tokenMutex_; // the heartbeat thread clears it
     int bestScore_;
     std::vector<std::string> friendList_;
     std::vector<std::string> pendingFriendRequests_;
+    // both under friendNamesMutex_, the notification thread reads them
     std::unordered_map<std::string, std::string> friendIDToUsername;
     std::unordered_map<std::string, std::string> pendingRequestIDToUsername;
+    mutable std::mutex friendNamesMutex_;
+    mutable AccountCache accountCache_;
     std::unordered_map<std::string, std::vector<ChatMessage> > conversations_;
+    std::unordered_map<std::string, std::string> conversationCursors_;
+    std::mutex conversationsMutex_;
     bool debug_;
+
+    // last public lobby listing, per game mode filter (-1 for all of them)
+    struct LobbyListCache
+    {
+        int version = NO_LOBBY_LIST_VERSION;
+        std::unordered_map<std::string, std::string> lobbies;
+    };
+    std::unordered_map<int, LobbyListCache> lobbyListCache_;
+    std::mutex lobbyListMutex_;
+
+    // notification channel
+    std::map<int, NotificationCallback> notificationSubscribers_;
+    int nextSubscriptionID_ = 0;
+    std::mutex subscribersMutex_;
+    std::condition_variable subscribersCV_;
+    std::thread notificationThread_;
+    std::atomic_bool stopNotifications_{false};
+
+    std::atomic_int lastInputSequence_{0};
+
+    void notificationLoop();
+    // calls every subscriber with it
+    void publishNotification(const Notification &notification);
+
+    // heartbeat thread : started with the lobby server session, it sends a
+    // HEARTBEAT whenever no request with the token was sent for
+    // SESSION_HEARTBEAT_SEC (in a lobby / game, the polling already does it).
+    // if the server ended the session, the token is cleared and the
+    // subscribers get a "session_expired" notification (log in again)
+    std::thread heartbeatThread_;
+    std::mutex heartbeatMutex_;
+    std::condition_variable heartbeatCV_;
+    bool stopHeartbeats_ = false;
+
+    void startHeartbeats(const std::string &token);
+    void stopHeartbeats();
+    void heartbeatLoop(const std::string &token);
+
+    // how often a heartbeat waiting for its answer checks if it should stop
+    static constexpr int HEARTBEAT_STOP_CHECK_MS = 100;
+
+    // how long the server may hold a poll, and how long we wait after an error
+    static constexpr int NOTIFICATION_POLL_TIMEOUT_SEC = 20;
+    static constexpr int NOTIFICATION_RETRY_DELAY_MS = 1000;
+
+    // how many messages we ask the db server for at once when syncing
+    static constexpr int MESSAGES_PAGE_SIZE = 50;
 };
 
 #endif
@@ -1,6 +1,8 @@
 #ifndef DB_REQUEST_MANAGER_HPP
 #define DB_REQUEST_MANAGER_HPP
 
+#include "Common.hpp"
+
 #include <boost/asio/connect.hpp>
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/beast/core.hpp>
@@ -8,9 +10,17 @@
 #include <boost/beast/version.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <vector>
 
 struct DBResponse {
     boost::property_tree::ptree json;
@@ -24,6 +34,12 @@ public:
     DBResponse getAccountIDByUsername(const std::string& username) const;
     DBResponse getUsernameByAccountID(const std::string& accountID) const;
 
+    // resolves whole lists through /resolve_accounts, each response holds an
+    // "accounts" array of the pairs that exist. big lists are split in
+    // several requests, pipelined on the same connection
+    std::vector<DBResponse> resolveAccounts(const std::vector<std::string> &accountIDs,
+                                            const std::vector<std::string> &userNames = {}) const;
+
     DBRequestManager(const std::string &host, const int &port);
 
     ~DBRequestManager();
@@ -37,8 +53,18 @@ public:
 
     DBResponse getLeaderboard(int limit = 10) const;
 
+    DBResponse getRank(const std::string &accountID, int around = 2) const;
+
     DBResponse getMessages(const std::string &accountID,
-                           const std::string &otherAccountID) const;
+                           const std::string &otherAccountID,
+                           const std::string &since = "",
+                           int limit = -1) const;
+
+    // long-poll, returns when something happened for accountID after the
+    // cursor, on timeout, or as soon as abort is set
+    DBResponse pollNotifications(const std::string &accountID,
+                                 const std::string &since, int timeoutSec,
+                                 const std::atomic_bool &abort) const;
 
     // POST Requests
     DBResponse registerPlayer(const std::string &userName,
@@ -72,13 +98,61 @@ public:
     DBResponse deleteMessage(const std::string &messageID) const;
 
 private:
+    struct PendingRequest {
+        boost::beast::http::verb method;
+        std::string target;
+        std::string body;
+    };
+
+    using Connection = boost::asio::ip::tcp::socket;
+
+    struct IdleConnection {
+        std::unique_ptr<Connection> connection;
+        std::chrono::steady_clock::time_point since;
+    };
+
     std::string host_;
     int port_;
 
+    // keep-alive connections are kept here between requests, every request
+    // takes one out (or opens a new one) so concurrent callers never share
+    // a socket. the resolution is only done once
+    mutable boost::asio::io_context ioc_;
+    mutable std::mutex connectionsMutex_;
+    mutable std::vector<IdleConnection> idleConnections_; // the newest last
+    mutable std::optional<boost::asio::ip::tcp::resolver::results_type> endpoints_;
+
     static std::string toJSON(const boost::property_tree::ptree &pt);
 
     DBResponse sendRequest(boost::beast::http::verb method,
                            const std::string &target, const std::string &body) const;
+
+    // writes every request before reading the first response, so a batch
+    // costs one round trip instead of one per request
+    std::vector<DBResponse> sendPipelined(const std::vector<PendingRequest> &requests) const;
+
+    std::unique_ptr<Connection> acquireConnection(bool &reused) const;
+
+    void releaseConnection(std::unique_ptr<Connection> connection) const;
+
+    boost::beast::http::request<boost::beast::http::string_body>
+    makeRequest(const PendingRequest &request) const;
+
+    DBResponse sendAbortableGetRequest(const std::string &target,
+                                       const std::atomic_bool &abort) const;
+
+    // how often an abortable request checks its abort flag
+    static constexpr int ABORT_CHECK_INTERVAL_MS = 100;
+
+    // how many names or ids go in one /resolve_accounts (the server refuses more)
+    static constexpr std::size_t RESOLVE_BATCH_SIZE = 256;
+
+    // idle connections above this are closed instead of being kept
+    static constexpr std::size_t MAX_IDLE_CONNECTIONS = 4;
+
+    // the server closes a connection after HTTP_IDLE_TIMEOUT_SEC without a
+    // request, we stop using ours well before (and free its server thread)
+    static constexpr int MAX_IDLE_SEC = HTTP_IDLE_TIMEOUT_SEC / 2;
 };
 
 #endif // DB_REQUEST_MANAGER_HPP
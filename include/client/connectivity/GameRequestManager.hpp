@@ -2,22 +2,26 @@
 #ifndef GAME_REQUEST_MANAGER_HPP
 #define GAME_REQUEST_MANAGER_HPP
 
+#include "ClientChannel.hpp"
 #include "Common.hpp"
 #include "KeyStroke.hpp"
 #include "ServerRequest.hpp"
 #include "ServerResponse.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
-#include <arpa/inet.h>
-#include <sys/socket.h>
-#include <unistd.h>
-
 class GameRequestManager
 {
   public:
@@ -34,11 +38,28 @@ class GameRequestManager
 
     // status thing
     [[nodiscard]] ServerResponse getClientStatus(const std::string& username);
+    // one answer per MAX_STATUS_BATCH usernames, the batches are in flight at
+    // the same time
+    [[nodiscard]] std::vector<ServerResponse>
+    getClientStatuses(const std::vector<std::string>& usernames);
 
     // main menu stuff
     [[nodiscard]] ServerResponse startSession(const std::string& username);
     [[nodiscard]] ServerResponse endSession(const std::string& token);
-    [[nodiscard]] ServerResponse getPublicLobbiesList();
+    // keeps the session alive when nothing else was sent for a while
+    [[nodiscard]] std::future<ServerResponse>
+    heartbeatAsync(const std::string& token);
+    // since the last request with a token (any of them is a heartbeat)
+    [[nodiscard]] std::chrono::steady_clock::duration timeSinceTokenSent() const;
+    // one page of the listing, SUCCESS_NOT_MODIFIED if knownVersion is still
+    // the current version (no gameMode means every game mode)
+    [[nodiscard]] ServerResponse
+    getPublicLobbiesList(int knownVersion = NO_LOBBY_LIST_VERSION,
+                         std::optional<GameMode> gameMode = std::nullopt,
+                         int page = 0);
+    [[nodiscard]] std::future<ServerResponse>
+    getPublicLobbiesListAsync(int knownVersion, std::optional<GameMode> gameMode,
+                              int page);
     [[nodiscard]] ServerResponse createAndJoinLobby(const std::string& token,
                                                     GameMode gameMode,
                                                     int maxPlayers,
@@ -58,29 +79,51 @@ class GameRequestManager
     [[nodiscard]] ServerResponse
     sendKeyStroke(const std::string& token, const KeyStrokePacket& keyStroke);
     [[nodiscard]] ServerResponse getGameState(const std::string& token);
+    [[nodiscard]] ServerResponse getGameOverview(const std::string& token);
     [[nodiscard]] ServerResponse leaveGame(const std::string& token);
 
+    // same, but several of them can be in flight at once
+    [[nodiscard]] std::future<ServerResponse>
+    sendKeyStrokeAsync(const std::string& token, const KeyStrokePacket& keyStroke);
+    [[nodiscard]] std::future<ServerResponse>
+    getGameStateAsync(const std::string& token);
+
   private:
-    // private here
-    StatusCode sendRequest(const ServerRequest& request);
-    ServerResponse receiveResponse();
+    // which server a request goes to
+    enum class Endpoint
+    {
+        LobbyServer,
+        Lobby,
+        Game,
+    };
 
-    // socket management
-    StatusCode setSocketOptions();
-    int getCurrentPort();
-    StatusCode changePort(int newPort);
-    StatusCode restoreListeningPort();
+    // private here
+    [[nodiscard]] std::future<ServerResponse>
+    sendRequest(Endpoint endpoint, ServerRequest& request, int retries = 0);
+    [[nodiscard]] std::shared_ptr<ClientChannel> getChannel(Endpoint endpoint);
 
-    // utils
-    static int generateRequestID();
+    // channel management
+    [[nodiscard]] StatusCode openLobbyChannels(int port);
+    void closeLobbyChannels();
 
     // config
     std::string serverIP;
     int lobbyServerPort;
 
-    // network stuff
-    int clientSocket;
-    struct sockaddr_in serverAddress;
+    // network stuff : one channel per endpoint. the lobby and its game live on
+    // the same port, but get a socket each so a lobby poll never waits behind
+    // game traffic. shared so a request in flight keeps its channel alive
+    // while another thread leaves the lobby
+    std::shared_ptr<ClientChannel> lobbyServerChannel;
+    std::shared_ptr<ClientChannel> lobbyChannel;
+    std::shared_ptr<ClientChannel> gameChannel;
+    std::mutex channelsMutex;
+
+    // when the last request with a token was sent (steady clock ticks)
+    std::atomic<std::chrono::steady_clock::rep> lastTokenSent{0};
+
+    // requests that only read something can be sent again if they got lost
+    static constexpr int READ_RETRIES = 2;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+#ifndef GAME_STATE_FEED_HPP
+#define GAME_STATE_FEED_HPP
+
+#include "ClientSession.hpp"
+#include "Common.hpp"
+#include "GameOverview.hpp"
+#include "GameState.hpp"
+#include "PiecePredictor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// what the game screen draws, a copy of the last state the server sent us
+struct GameFrame {
+    std::uint64_t sequence = 0; // 0 until the first state arrived
+    bool isSpectator = false;
+    PlayerState playerState = PlayerState::generateEmptyState();
+    SpectatorState spectatorState = SpectatorState::generateEmptyState();
+    GameOverview overview; // every board of the game, royale only
+    StatusCode lastError = StatusCode::SUCCESS; // of the last failed request
+};
+
+// runs the in-game networking on its own thread : while a game screen is up
+// this thread is the only one talking to the game server, the ui thread only
+// queues things for it and reads the last frame, so it never waits on a
+// packet (a lost one used to freeze the screen for CLIENT_TIMEOUT_SEC)
+class GameStateFeed {
+public:
+    using Callback = std::function<void()>;
+    using Task = std::function<void(ClientSession &)>;
+
+    // onNewFrame is called every time the frame changed : from the feed thread
+    // for a new state, from the caller of sendAction for a predicted move
+    GameStateFeed(ClientSession &session, Callback onNewFrame);
+
+    ~GameStateFeed();
+
+    void start();
+
+    void stop();
+
+    // the key strokes are sent in order, before the next state poll. our own
+    // piece is moved in the front frame right away (see PiecePredictor)
+    void sendAction(Action action);
+
+    // anything else that needs the game server (leaving, posting a score...)
+    // runs on the feed thread, between two polls
+    void post(Task task);
+
+    // copy of the front buffer
+    [[nodiscard]] GameFrame getFrame();
+
+private:
+    ClientSession &session_;
+    Callback onNewFrame_;
+
+    // the feed thread fills backFrame_ without holding the lock, then swaps
+    // it with frontFrame_ which is all the readers ever see
+    GameFrame frontFrame_;
+    GameFrame backFrame_;
+    std::mutex frameMutex_;
+    std::string lastRawState_;
+
+    // under frameMutex_, the sequence numbers come from the session
+    PiecePredictor predictor_;
+
+    std::deque<std::pair<int, Action>> pendingActions_; // sequence, action
+    std::deque<Task> pendingTasks_;
+    std::mutex queueMutex_;
+    std::condition_variable queueCV_;
+
+    // the overview is asked for every OVERVIEW_UPDATE_INTERVAL, not every poll
+    std::chrono::steady_clock::time_point lastOverviewPoll_;
+
+    std::thread feedThread_;
+    std::atomic_bool running_{false};
+
+    void feedLoop();
+
+    void pollState();
+
+    void pollOverview();
+
+    void publish(StatusCode error);
+
+    // how often we ask for the state when nothing else is going on
+    static constexpr int POLL_INTERVAL_MS = 50;
+};
+
+#endif // GAME_STATE_FEED_HPP
@@ -0,0 +1,70 @@
+#ifndef PIECE_PREDICTOR_HPP
+#define PIECE_PREDICTOR_HPP
+
+#include "GameMatrix.hpp"
+#include "GameState.hpp"
+#include "Types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <optional>
+
+// moves our own piece right away instead of waiting for the server to answer :
+// every key stroke is applied on a local copy of the board and remembered
+// until the server says it applied it too (PlayerState::lastInputSequence).
+// when a state arrives we start again from it and replay what it doesn't
+// contain yet, so the server always has the last word. only the falling
+// piece is predicted : gravity, the next piece, the bag and the power-ups
+// come from the server alone. an instant fall locks the piece (and clears
+// the lines it fills), nothing is predicted after it until a state with the
+// next piece arrives
+class PiecePredictor {
+public:
+    PiecePredictor() = default;
+    ~PiecePredictor() = default;
+
+    // the moves GameMatrix can do on its own
+    [[nodiscard]] static bool isPredictable(Action action);
+
+    // start from the authoritative state, then replay the pending inputs
+    void reconcile(const PlayerState &state);
+
+    // remembers the input, and applies it when we can. returns whether the
+    // predicted grid changed
+    bool applyLocal(int sequence, Action action);
+
+    // nothing until the first state with a piece in it
+    [[nodiscard]] std::optional<tetroMat> getPredictedGrid() const;
+
+    [[nodiscard]] std::size_t pendingCount() const;
+
+    void reset();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingInput {
+        int sequence;
+        Action action;
+        Clock::time_point sentAt;
+    };
+
+    // applies what the server would do with this key stroke, flags included
+    bool applyOnMatrix(Action action);
+
+    // after an instant fall, until the server sends the next piece
+    [[nodiscard]] bool hasPiece() const;
+
+    std::optional<GameMatrix> matrix_;
+    std::deque<PendingInput> pending_;
+    bool controlsReversed_ = false;
+    bool controlsBlocked_ = false;
+
+    // an input the server never acknowledges (lost packet, or dropped from
+    // its queue) must not be replayed forever
+    static constexpr std::size_t MAX_PENDING_INPUTS = 32;
+    static constexpr int PENDING_TIMEOUT_MS = 1000;
+};
+
+#endif // PIECE_PREDICTOR_HPP
@@ -0,0 +1,61 @@
+#ifndef BOARDWIDGET_HPP
+#define BOARDWIDGET_HPP
+
+#include <QWidget>
+#include <QColor>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPixmap>
+#include <QRegion>
+#include <QResizeEvent>
+#include <QSize>
+
+#include <unordered_map>
+
+#include "Types.hpp"
+
+
+// Board that stays alive for the whole game : it keeps the last grid it was
+// given and only repaints the cells that changed, each cell is a pixmap drawn
+// once per piece type (and again only when the widget is resized)
+class BoardWidget : public QWidget {
+
+    Q_OBJECT
+
+public:
+    explicit BoardWidget(bool isOpponentBoard, QWidget *parent = nullptr);
+    ~BoardWidget() override = default;
+
+    void setBoard(const tetroMat &board);
+    void setGameOver(bool gameOver);
+
+    [[nodiscard]] QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    [[nodiscard]] QRect cellRect(int row, int col) const;
+    [[nodiscard]] const QPixmap &cellPixmap(int value);
+    void updateGeometryCache();
+
+    bool isOpponentBoard;
+    bool isGameOver = false;
+    tetroMat board;
+
+    // where the grid is drawn inside the widget, computed on resize
+    int cellSize = 0;
+    QPoint gridOrigin;
+
+    std::unordered_map<int, QPixmap> cellPixmaps;
+
+    static constexpr int BORDER_WIDTH = 2;
+
+    // what we show before the first state arrives
+    static constexpr int DEFAULT_ROWS = 20;
+    static constexpr int DEFAULT_COLS = 10;
+};
+
+
+#endif // BOARDWIDGET_HPP
@@ -19,8 +19,11 @@
 #include "Common.hpp"
 #include "Config.hpp"
 
+class BoardWidget;
 
-QWidget* renderBoard(const tetroMat &board, bool isOpponentBoard, bool isGameOver, QWidget *parent = nullptr);
+
+QColor colorForValue(int value);
+QWidget* renderBoard(BoardWidget *board, bool isOpponentBoard, QWidget *parent = nullptr);
 QWidget* renderEnergyBar(int energy, int maxEnergy = MAX_ENERGY, QWidget *parent = nullptr);
 QWidget* renderPiece(PieceType type, int gridHeight, int gridWidth, QWidget *parent = nullptr);
 QWidget* renderStats(int score, int level, int linesCleared, QWidget *parent = nullptr);
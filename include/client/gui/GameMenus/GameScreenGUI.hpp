@@ -18,12 +18,15 @@
 #include <QPropertyAnimation>
 
 #include <iostream>
+#include <optional>
 
 #include "Types.hpp"
 #include "Common.hpp"
 #include "Config.hpp"
 #include "ClientSession.hpp"
 #include "GameRenderGUI.hpp"
+#include "BoardWidget.hpp"
+#include "MiniMapWidget.hpp"
 #include "MainMenuGUI.hpp"           
 
 
@@ -46,6 +49,8 @@ private:
     void setupUi();
     void setupPlayerUI(const PlayerState &ps);
     void setupSpectatorUI(const SpectatorState &ss);
+    void updateMiniMap(const PlayerState &ps);
+    void buildSpectatorUI();
     void clearLayout(QLayout *layout);
     void replaceWidgetInLayout(QBoxLayout *layout, QWidget *&oldW, QWidget *newW);
 
@@ -55,6 +60,18 @@ private:
     tetroMat opponentBoard;
     bool     isSpectator = false;
 
+    // the boards live as long as the screen, each frame only hands them the
+    // new grid. the side panels are rebuilt when what they show changes
+    BoardWidget *mainBoard      = nullptr;
+    BoardWidget *oppBoard       = nullptr;
+    BoardWidget *spectatedBoard = nullptr;
+
+    // royale only, refreshed every OVERVIEW_UPDATE_INTERVAL
+    MiniMapWidget *miniMap = nullptr;
+    int msSinceOverview = OVERVIEW_UPDATE_INTERVAL;
+    std::optional<PlayerState>    shownPlayerState;
+    std::optional<SpectatorState> shownSpectatorState;
+
     QWidget *mainBoardWidget    = nullptr;
     QWidget *oppBoardWidget     = nullptr;
     QWidget *statsWidget        = nullptr;
@@ -64,6 +81,7 @@ private:
     QWidget *controlsWidget     = nullptr;
     QWidget *opponentContainer  = nullptr;
     QLabel  *opponentNameLabel  = nullptr;
+    QLabel  *spectatingLabel    = nullptr;
 
     QTimer  *updateTimer        = nullptr;
 
@@ -0,0 +1,49 @@
+#ifndef MINIMAPWIDGET_HPP
+#define MINIMAPWIDGET_HPP
+
+#include <QWidget>
+#include <QColor>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QSize>
+
+#include <string>
+#include <vector>
+
+#include "GameOverview.hpp"
+
+
+// Every opponent of a royale game at once, each one as the skyline of its
+// board (a bar per column), so the player doesn't have to cycle through them
+// to see who is about to top out
+class MiniMapWidget : public QWidget {
+
+    Q_OBJECT
+
+public:
+    explicit MiniMapWidget(QWidget *parent = nullptr);
+    ~MiniMapWidget() override = default;
+
+    // only repaints if one of the opponents changed
+    void setOverview(const GameOverview &overview, const std::string &ownUsername, int boardHeight);
+
+    [[nodiscard]] QSize sizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    std::vector<BoardOverview> opponents;
+    int boardHeight = DEFAULT_ROWS;
+
+    static constexpr int BOARDS_PER_ROW = 4;
+    static constexpr int TILE_WIDTH = 70;
+    static constexpr int TILE_HEIGHT = 60;
+    static constexpr int NAME_HEIGHT = 14;
+    static constexpr int SPACING = 6;
+
+    static constexpr int DEFAULT_ROWS = 20;
+};
+
+
+#endif // MINIMAPWIDGET_HPP
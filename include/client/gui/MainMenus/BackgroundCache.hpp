@@ -0,0 +1,55 @@
+#ifndef BACKGROUNDCACHE_HPP
+#define BACKGROUNDCACHE_HPP
+
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+
+
+// The background image every screen paints behind its widgets. It is decoded
+// once for the whole process, and scaled once per window size : a repaint is
+// then a plain blit of a pixmap that is already the right size, instead of
+// decoding the png and scaling it again on every paintEvent (20 times a second
+// on the game screen). GUI thread only, like every QPixmap.
+class BackgroundCache {
+public:
+    static BackgroundCache& instance() {
+        static BackgroundCache instance;
+        return instance;
+    }
+
+    // decodes the image now (at startup), so the first screen doesn't have to
+    void preload();
+
+    // the background at exactly [size] (stretched) or covering it
+    // (Qt::KeepAspectRatioByExpanding, bigger than size on one side)
+    [[nodiscard]] const QPixmap& scaled(const QSize &size, Qt::AspectRatioMode mode = Qt::IgnoreAspectRatio);
+
+    // frees every pixmap, to call before the QApplication goes away (this
+    // cache outlives main, and a pixmap can't be destroyed without it)
+    void clear();
+
+    BackgroundCache(const BackgroundCache&) = delete;
+    void operator=(const BackgroundCache&) = delete;
+
+private:
+    BackgroundCache() = default;
+    ~BackgroundCache() = default;
+
+    QPixmap source;
+
+    // WIDTH, HEIGHT, ASPECT RATIO MODE -> SCALED COPY
+    std::map<std::tuple<int, int, int>, QPixmap> scaledCopies;
+
+    // a few window sizes at once (maximized, restored, the game screen...),
+    // past that the copies of old sizes are dropped
+    static constexpr std::size_t MAX_SCALED_COPIES = 4;
+
+    static inline const QString BACKGROUND_PATH = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
+};
+
+#endif // BACKGROUNDCACHE_HPP
@@ -19,6 +19,8 @@
 #include <QPointer>
 #include <QMessageBox>
 
+#include <functional>
+#include <memory>
 #include <set>
 #include <sstream>
 #include <random>
@@ -32,6 +34,7 @@ class FriendsList : public QMainWindow {
 
 public:
     explicit FriendsList(ClientSession &session,QWidget *parent = nullptr);
+    ~FriendsList() override;
 
     QString buttonStyle = R"(
         QPushButton {
@@ -118,18 +121,23 @@ private:
     QTimer *refreshTimer; 
     
     QWidget *chatWidget;
-    QTimer *messageTimer;
+
+    // the chat is refreshed by the session notifications, not by a timer
+    std::string chatFriendID;
+    std::function<void()> refreshChat;
+    int notificationSubscription = -1;
 
 
     ClientSession &session;
 
 private slots:
     void showChat(const QString &friendName);
-    void addFriendWidget(const QString &friendName);
+    void addFriendWidget(const QString &friendName, ClientStatus status);
     void populateFriends();
     void createSearchBar();
     void createBottomLayout();
     void sendInvite(const std::string &friendID);
+    void handleNotification(const Notification &notification);
 };
 
 #endif // FRIENDSLIST_HPP
\ No newline at end of file
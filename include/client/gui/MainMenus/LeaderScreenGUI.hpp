@@ -11,6 +11,8 @@
 #include <QTableWidget>
 #include <QTableWidgetItem>
 
+#include <algorithm>
+
 #include "MainMenuGUI.hpp"
 #include "Common.hpp"
 #include "ClientSession.hpp"
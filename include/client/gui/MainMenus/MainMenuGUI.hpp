@@ -56,7 +56,10 @@ private:
     QLineEdit   *chatInput;
 
     ClientSession &session;
+    int notificationSubscription;
 
+    // back to the login screen, the session is over
+    void backToLogin();
 
 private slots:
     void logout();
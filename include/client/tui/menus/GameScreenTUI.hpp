@@ -4,7 +4,10 @@
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/dom/elements.hpp>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <mutex>
 #include <thread>
 #include <sstream>
 #include <map>
@@ -14,6 +17,7 @@
 
 #include "MenuHandlerTUI.hpp"
 #include "ClientSession.hpp"
+#include "GameStateFeed.hpp"
 #include "Common.hpp"
 
 // Forward declaration of the currentScreen variable which is defined in MenuHandler.cpp
@@ -74,6 +78,16 @@ ftxui::Element renderStats(int score, int level, int linesCleared);
  */
 ftxui::Element renderEnergyBar(int energy);
 
+/**
+ * Helper function to render the mini-map of a royale game
+ *
+ * @param overview The skylines of every board of the game
+ * @param ownUsername The board not to show (ours)
+ * @param boardHeight The number of rows of a board
+ * @return An ftxui Element with a small skyline per opponent
+ */
+ftxui::Element renderMiniMap(const GameOverview &overview, const std::string &ownUsername, int boardHeight);
+
 /**
  * Helper function to render the game controls
  *
@@ -15,6 +15,7 @@ enum class StatusCode
     // success codes
     SUCCESS,
     SUCCESS_REPLACED_SESSION,
+    SUCCESS_NOT_MODIFIED,
 
     // error codes
     ERROR,
@@ -122,11 +123,23 @@ struct ChatMessage
     std::string text;
 };
 
+// pushed by the db server through /poll_notifications
+// type is one of "message", "friend_request", "friend_accept",
+// "friend_decline", "friend_remove" or "rename", fromID is the account that
+// caused it. the client adds "session_expired" itself (no fromID) when the
+// lobby server no longer knows its session
+struct Notification
+{
+    std::string type;
+    std::string fromID;
+};
+
 
 
 // message type for debugging
 enum class MessageType
 {
+    DEBUG,
     INFO,
     WARNING,
     ERROR,
@@ -140,6 +153,7 @@ enum class ServerMethods
 
     // status thing
     GET_CLIENT_STATUS,
+    GET_CLIENT_STATUSES, // many usernames at once, for the friends list
 
     // Lobby methods
     GET_CURRENT_LOBBY,
@@ -149,6 +163,7 @@ enum class ServerMethods
 
     // Game methods
     GET_GAME_STATE,
+    GET_GAME_OVERVIEW, // every board of the game, low resolution (mini-map)
     KEY_STROKE,
     LEAVE_GAME,
 
@@ -160,6 +175,7 @@ enum class ServerMethods
     CREATE_LOBBY,
     JOIN_LOBBY,
     SPECTATE_LOBBY,
+    HEARTBEAT, // nothing else to send, but the session is still alive
 
     NONE, // default value
 
@@ -184,14 +200,22 @@ const int EMPTY_LOBBY_PORT = -1;
 
 // Buffer size for the server
 const int MAX_BUFFER_SIZE = 2048;
+// biggest datagram we send : under the usual path MTU (so the IP layer never
+// has to fragment it), bigger messages are split (see Fragmentation.hpp)
+const int MAX_DATAGRAM_SIZE = 1200;
 
 // Timeout values for the server / client
 const int TIMEOUT_SEC = 5;
 const int LOBBY_TIMEOUT_SEC = 1;
 const int GAME_TIMEOUT_SEC = 1;
 const int CLIENT_TIMEOUT_SEC = 3;
+// an HTTP keep-alive connection the db server gets no request on for this
+// long is closed (its thread is freed), the clients stop reusing theirs before
+const int HTTP_IDLE_TIMEOUT_SEC = 30;
 const int TIMEOUT_USEC = 0;
 const int GAME_UPDATE_INTERVAL = 50;
+// how often the game rebuilds its overview (and the clients ask for it)
+const int OVERVIEW_UPDATE_INTERVAL = 200;
 
 // Port for the servers
 const int LOBBY_SERVER_PORT = 5050;
@@ -206,6 +230,12 @@ const int NO_LOBBY_PORT_FOUND = -1;
 
 // limits for the servers
 const int MAX_SESSIONS = 200;
+
+// a session nothing was heard from (no request with its token, to any server)
+// for SESSION_TIMEOUT_SEC is ended by the lobby server. a client that has been
+// quiet for SESSION_HEARTBEAT_SEC sends a HEARTBEAT
+const int SESSION_TIMEOUT_SEC = 90;
+const int SESSION_HEARTBEAT_SEC = 30;
 const int MAX_GAMES = 20;
 const int MAX_LOBBIES = 20;
 
@@ -216,6 +246,20 @@ const int MAX_LOBBY_SIZE = 9;
 
 const int MAX_REQUEST_ID = 4096;
 
+// usernames per GET_CLIENT_STATUSES request (so the answer fits in one
+// MAX_DATAGRAM_SIZE datagram)
+const int MAX_STATUS_BATCH = 32;
+
+// size of the lobby states in one page of GET_PUBLIC_LOBBIES (so a page stays
+// a datagram or two), a lobby bigger than that still gets a page of its own
+const int LOBBY_LIST_PAGE_BYTES = 1024;
+// version a client sends before it has any listing
+const int NO_LOBBY_LIST_VERSION = -1;
+
+// usernames in a game overview are cut to this (so a full royale overview fits
+// in one MAX_DATAGRAM_SIZE datagram)
+const int OVERVIEW_NAME_LENGTH = 16;
+
 const int MAX_ENERGY = 200;
 
 // rules for tokens
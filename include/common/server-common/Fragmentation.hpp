@@ -0,0 +1,103 @@
+#ifndef FRAGMENTATION_HPP
+#define FRAGMENTATION_HPP
+
+#include "Common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+// Every message between the clients and the servers is a serialized request
+// or response. Most of them are small and go as one datagram, as they always
+// did. A message bigger than MAX_DATAGRAM_SIZE is split in fragments, each with
+// a small header (FRAGMENT_MAGIC, message ID, fragment index, fragment count),
+// and put back together on the other side. A JSON payload never starts with
+// FRAGMENT_MAGIC, so both kinds can arrive on the same socket.
+
+struct FragmentHeader
+{
+    std::uint32_t messageID;
+    std::uint16_t index;
+    std::uint16_t count;
+
+    static constexpr std::size_t SIZE = 9;
+    // biggest message : MAX_FRAGMENTS * (MAX_DATAGRAM_SIZE - SIZE) bytes
+    static constexpr std::size_t MAX_FRAGMENTS = 64;
+    // not valid UTF-8, a JSON payload can't start with this
+    static constexpr unsigned char FRAGMENT_MAGIC = 0xF7;
+
+    [[nodiscard]] std::string serialize() const;
+    [[nodiscard]] static std::optional<FragmentHeader>
+    deserialize(const char* data, std::size_t length);
+};
+
+class FragmentWriter
+{
+  public:
+    FragmentWriter();
+
+    // the datagrams to send for this message (itself if it fits in one,
+    // nothing if it is too big even for MAX_FRAGMENTS)
+    [[nodiscard]] std::vector<std::string> split(const std::string& message);
+
+    // splits and sends the message, to [address] or on a connected socket
+    // (address == nullptr)
+    [[nodiscard]] StatusCode send(int socket, const std::string& message,
+                                  const sockaddr* address = nullptr,
+                                  socklen_t addressLength = 0);
+
+  private:
+    std::atomic<std::uint32_t> nextMessageID;
+};
+
+class FragmentReader
+{
+  public:
+    // takes a datagram from [sender], gives back the whole message once every
+    // fragment of it arrived (right away if it wasn't fragmented)
+    [[nodiscard]] std::optional<std::string>
+    feed(const std::string& sender, const char* data, std::size_t length);
+
+    // forgets the messages that didn't get all their fragments in time
+    void expire();
+
+    [[nodiscard]] std::size_t pendingCount() const;
+
+    // who sent a datagram, as the sender for feed()
+    [[nodiscard]] static std::string senderKey(const sockaddr_in& address);
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    // a message we got some of the fragments of
+    struct PartialMessage
+    {
+        std::vector<std::string> fragments;
+        std::vector<bool> received;
+        std::size_t receivedCount = 0;
+        std::size_t size = 0;
+        Clock::time_point deadline;
+    };
+
+    // SENDER + MESSAGE ID -> WHAT WE HAVE SO FAR
+    std::map<std::pair<std::string, std::uint32_t>, PartialMessage> partials;
+    mutable std::mutex partialsMutex;
+
+    // a message that hasn't got all its fragments after this is dropped (the
+    // request will be sent again anyway)
+    static constexpr int FRAGMENT_TIMEOUT_MS = 1000;
+    // bound on what senders can make us keep in memory
+    static constexpr std::size_t MAX_PARTIAL_MESSAGES = 256;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef GAME_OVERVIEW_HPP
+#define GAME_OVERVIEW_HPP
+
+#include "Common.hpp"
+#include "Types.hpp"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// a low resolution view of every board of a game, for the mini-map : each
+// board is only its skyline (how high the stack is in every column, one
+// character per column). the game builds it every OVERVIEW_UPDATE_INTERVAL
+// and hands the same bytes to everybody who asks, and a full royale (9 boards,
+// names cut at OVERVIEW_NAME_LENGTH) still fits in one datagram
+
+struct BoardOverview
+{
+    std::string username;
+    std::string skyline;
+    bool isGameOver = false;
+
+    bool operator==(const BoardOverview& other) const = default;
+};
+
+struct GameOverview
+{
+  public:
+    std::vector<BoardOverview> boards;
+
+    // skyline of a board : for every column, the number of rows from its
+    // highest block to the bottom (0 for an empty column)
+    [[nodiscard]] static std::string encodeSkyline(const tetroMat& board);
+    [[nodiscard]] static std::vector<int> decodeSkyline(const std::string& skyline);
+
+    [[nodiscard]] std::string serialize() const;
+    [[nodiscard]] static GameOverview deserialize(const std::string& data);
+
+  private:
+    // one character per height, 0 to 61 (higher stacks are shown as 61)
+    static constexpr char SKYLINE_DIGITS[] =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static constexpr std::size_t MAX_SKYLINE_HEIGHT = sizeof(SKYLINE_DIGITS) - 2;
+};
+
+#endif
@@ -43,6 +43,16 @@ struct PlayerState : public GameState
     std::string targetUsername;
     tetroMat targetGrid;
 
+    // the falling piece on its own (it is also drawn in playerGrid), and the
+    // last key stroke the server applied : what the client needs to predict
+    // its own moves and to replay the ones not acknowledged yet
+    PieceType currentTetro = PieceType::None;
+    Position2D currentPosition = {0, 0};
+    tetroShape currentShape;
+    int lastInputSequence = 0;
+    bool controlsReversed = false;
+    bool controlsBlocked = false;
+
     [[nodiscard]] static PlayerState generateEmptyState();
     [[nodiscard]] std::string serialize() const override;
     [[nodiscard]] static PlayerState deserialize(const std::string& data);
@@ -13,6 +13,7 @@ struct KeyStrokePacket
   public:
     Action action;
     std::string token;
+    int sequence = 0; // increasing per client, 0 if the client doesn't care
 
     [[nodiscard]] std::string serialize() const;
     [[nodiscard]] static KeyStrokePacket deserialize(const std::string& data);
@@ -0,0 +1,218 @@
+#ifndef LOGGER_HPP
+#define LOGGER_HPP
+
+#include "Common.hpp"
+#include "Metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// The log of every server of the process. A call to log() checks the level of
+// its component, puts the record in a lock-free ring buffer and returns : the
+// arguments are only turned into text later, by the writer thread, which is
+// also the only one to touch the output. When the buffer is full the record is
+// dropped (and counted in tetris_log_dropped_total), the caller never waits.
+
+// who logs (each one gets its own level)
+enum class LogComponent
+{
+    MASTER_SERVER,
+    TETRIS_SERVER,
+    LOBBY_SERVER,
+    LOBBY,
+    GAME_SERVER,
+    GAME,
+    NONE, // default value
+};
+
+enum class LogFormat
+{
+    TEXT, // 2026-01-01T12:00:00.000Z [game-AB12CD] [INFO] message
+    JSON, // one object per line (time, level, component, context, message)
+};
+
+class Logger
+{
+  public:
+    static Logger& instance() {
+        static Logger instance;
+        return instance;
+    }
+
+    // is a record of this level from this component going to be written
+    [[nodiscard]] bool enabled(MessageType level, LogComponent component) const;
+
+    // [context] tells the instances of a component apart (the lobby or game
+    // ID), [args] are written one after the other. string literals are kept
+    // as pointers and the rest is copied : nothing is formatted on the
+    // caller's thread (unless the arguments are too big for a record)
+    template<typename... Args>
+    void log(MessageType level, LogComponent component, std::string context,
+             Args&&... args);
+
+    // the lowest level written, for every component or for one of them
+    // (MessageType::NONE turns it off)
+    void setLevel(MessageType level);
+    void setLevel(LogComponent component, MessageType level);
+    void setFormat(LogFormat format);
+    void setOutput(std::ostream& output);
+
+    // waits (a second at most) until everything logged so far is written
+    void flush();
+
+    [[nodiscard]] std::uint64_t droppedRecords() const;
+
+    // "debug", "info"... and "master", "lobby-server"... (nothing if unknown)
+    [[nodiscard]] static std::optional<MessageType> parseLevel(const std::string& name);
+    [[nodiscard]] static std::optional<LogComponent> parseComponent(const std::string& name);
+
+    Logger(const Logger&) = delete;
+    void operator=(const Logger&) = delete;
+
+  private:
+    Logger();
+    ~Logger();
+
+    // a const char array is taken for a string literal, which lives as long
+    // as the program : only those are kept as pointers
+    template<typename T>
+    static constexpr bool isStringLiteral =
+        std::is_array_v<std::remove_reference_t<T>> &&
+        std::is_same_v<std::remove_extent_t<std::remove_reference_t<T>>, const char>;
+
+    // the arguments of a log() call, as they are kept until written (a char
+    // array that isn't const decays to char* and is copied)
+    template<typename T>
+    using Stored = std::conditional_t<
+        isStringLiteral<T>, const char*,
+        std::conditional_t<std::is_same_v<std::decay_t<T>, const char*> ||
+                               std::is_same_v<std::decay_t<T>, char*>,
+                           std::string, std::decay_t<T>>>;
+
+    static constexpr std::size_t PAYLOAD_SIZE = 160;
+
+    struct Record
+    {
+        std::chrono::system_clock::time_point time;
+        MessageType level = MessageType::NONE;
+        LogComponent component = LogComponent::NONE;
+        std::string context;
+        // appends the arguments to the line, then destroys them
+        void (*render)(void* payload, std::string& line) = nullptr;
+        alignas(std::max_align_t) std::array<std::byte, PAYLOAD_SIZE> payload;
+    };
+
+    // bounded MPMC queue of D. Vyukov (used with a single consumer) : a slot
+    // is free for position p when its sequence is p, and written when it is
+    // p + 1
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        Record record;
+    };
+
+    template<typename Payload>
+    static void renderPayload(void* payload, std::string& line);
+
+    template<typename... Args>
+    [[nodiscard]] static std::string concatenate(const Args&... args);
+
+    [[nodiscard]] Slot* claim(std::size_t& position);
+    void publish(Slot* slot, std::size_t position);
+    [[nodiscard]] bool writeNext(std::string& batch);
+    void formatRecord(Record& record, std::string& batch) const;
+    void writerLoop();
+
+    static constexpr std::size_t CAPACITY = 4096; // a power of two
+    static constexpr std::size_t MAX_BATCH = 256;
+    static constexpr int IDLE_WAIT_MS = 2;
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<std::size_t> enqueuePosition{0};
+    alignas(64) std::atomic<std::size_t> dequeuePosition{0};
+    // everything before it is out (written and flushed)
+    std::atomic<std::size_t> writtenPosition{0};
+
+    std::array<std::atomic<int>, static_cast<std::size_t>(LogComponent::NONE)> levels;
+    std::atomic<LogFormat> format{LogFormat::TEXT};
+
+    std::mutex outputMutex;
+    std::ostream* output;
+
+    Counter& dropped;
+    std::atomic_bool stopping{false};
+    std::thread writerThread;
+};
+
+template<typename Payload>
+void
+Logger::renderPayload(void* payload, std::string& line) {
+    auto* arguments = std::launder(reinterpret_cast<Payload*>(payload));
+
+    std::ostringstream stream;
+    std::apply([&stream](const auto&... argument) { (stream << ... << argument); },
+               *arguments);
+    line += stream.str();
+
+    arguments->~Payload();
+}
+
+template<typename... Args>
+std::string
+Logger::concatenate(const Args&... args) {
+    std::ostringstream stream;
+    (stream << ... << args);
+    return stream.str();
+}
+
+template<typename... Args>
+void
+Logger::log(const MessageType level, const LogComponent component,
+            std::string context, Args&&... args) {
+    if (!enabled(level, component)) {
+        return;
+    }
+
+    std::size_t position = 0;
+    Slot* slot = claim(position);
+    if (slot == nullptr) {
+        dropped.increment();
+        return;
+    }
+
+    Record& record = slot->record;
+    record.time = std::chrono::system_clock::now();
+    record.level = level;
+    record.component = component;
+    record.context = std::move(context);
+
+    using Payload = std::tuple<Stored<Args>...>;
+    if constexpr (sizeof(Payload) <= PAYLOAD_SIZE &&
+                  alignof(Payload) <= alignof(std::max_align_t)) {
+        new (record.payload.data()) Payload(std::forward<Args>(args)...);
+        record.render = &renderPayload<Payload>;
+    } else {
+        // too big to be kept as is, the text is made now
+        using Text = std::tuple<std::string>;
+        new (record.payload.data()) Text(concatenate(args...));
+        record.render = &renderPayload<Text>;
+    }
+
+    publish(slot, position);
+}
+
+#endif // LOGGER_HPP
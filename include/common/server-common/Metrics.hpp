@@ -0,0 +1,165 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "Common.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Counters, gauges and histograms of the whole process, served as text (the
+// Prometheus format) at GET /metrics by the HTTP server. Registering a metric
+// takes a lock and is done once, the reference is then kept by the caller.
+// Updating one is a relaxed atomic add, nothing else, so they stay on in
+// production.
+
+class Counter
+{
+  public:
+    void increment(std::uint64_t amount = 1);
+    [[nodiscard]] std::uint64_t value() const;
+
+  private:
+    std::atomic<std::uint64_t> count{0};
+};
+
+class Gauge
+{
+  public:
+    void set(std::int64_t newValue);
+    void add(std::int64_t amount);
+    [[nodiscard]] std::int64_t value() const;
+
+  private:
+    std::atomic<std::int64_t> current{0};
+};
+
+// durations, in microseconds. HDR like : 16 linear buckets for every power of
+// two, so a quantile is never more than ~6% off, whatever the magnitude
+class Histogram
+{
+  public:
+    void record(std::uint64_t microseconds);
+    void record(std::chrono::steady_clock::duration duration);
+
+    [[nodiscard]] std::uint64_t count() const;
+    [[nodiscard]] std::uint64_t sum() const;
+    // highest value of the bucket the quantile falls in (0 if empty)
+    [[nodiscard]] std::uint64_t quantile(double q) const;
+
+  private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr std::uint64_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    // up to 2^40 us (~12 days), more than that goes in the last bucket
+    static constexpr int MAX_MAGNITUDE = 40;
+    static constexpr std::size_t BUCKETS = SUB_BUCKETS * (MAX_MAGNITUDE - SUB_BUCKET_BITS + 1);
+
+    [[nodiscard]] static std::size_t bucketOf(std::uint64_t value);
+    [[nodiscard]] static std::uint64_t highestValueOf(std::size_t bucket);
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+    std::atomic<std::uint64_t> total{0};
+    std::atomic<std::uint64_t> sumOfValues{0};
+};
+
+// records the time between its construction and its destruction
+class ScopedTimer
+{
+  public:
+    explicit ScopedTimer(Histogram& histogram);
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+class MetricsRegistry
+{
+  public:
+    static MetricsRegistry& instance() {
+        static MetricsRegistry instance;
+        return instance;
+    }
+
+    // the same name and labels (method="KEY_STROKE") always give the same
+    // metric. the help is the one of the first registration
+    [[nodiscard]] Counter& counter(const std::string& name, const std::string& help,
+                                   const std::string& labels = "");
+    [[nodiscard]] Gauge& gauge(const std::string& name, const std::string& help,
+                               const std::string& labels = "");
+    // exposed in seconds, as a summary (quantiles, sum and count)
+    [[nodiscard]] Histogram& histogram(const std::string& name, const std::string& help,
+                                       const std::string& labels = "");
+
+    // everything, in the Prometheus text format (version 0.0.4)
+    [[nodiscard]] std::string render() const;
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    void operator=(const MetricsRegistry&) = delete;
+
+  private:
+    MetricsRegistry() = default;
+    ~MetricsRegistry() = default;
+
+    template<typename T>
+    struct Family
+    {
+        std::string help;
+        // LABELS -> METRIC (pointers, so the references handed out stay valid)
+        std::map<std::string, std::unique_ptr<T>> series;
+    };
+
+    template<typename T>
+    [[nodiscard]] T& getOrAdd(std::map<std::string, Family<T>>& families,
+                              const std::string& name, const std::string& help,
+                              const std::string& labels);
+
+    mutable std::mutex registryMutex;
+    std::map<std::string, Family<Counter>> counters;
+    std::map<std::string, Family<Gauge>> gauges;
+    std::map<std::string, Family<Histogram>> histograms;
+
+    // the quantiles every histogram is exposed with
+    static constexpr std::array QUANTILES = {0.5, 0.9, 0.99, 0.999};
+};
+
+// what the UDP servers (lobby server, lobbies, games) all measure : how long
+// each method takes to handle, and the traffic
+class RequestMetrics
+{
+  public:
+    static RequestMetrics& instance() {
+        static RequestMetrics instance;
+        return instance;
+    }
+
+    void received(std::size_t bytes);
+    void sent(std::size_t bytes);
+    void deserializeFailed();
+    [[nodiscard]] Histogram& duration(ServerMethods method);
+
+    RequestMetrics(const RequestMetrics&) = delete;
+    void operator=(const RequestMetrics&) = delete;
+
+  private:
+    RequestMetrics();
+    ~RequestMetrics() = default;
+
+    Counter& bytesIn;
+    Counter& bytesOut;
+    Counter& deserializeFailures;
+    // one per ServerMethods, NONE included
+    std::array<Histogram*, static_cast<std::size_t>(ServerMethods::NONE) + 1> durations{};
+};
+
+#endif // METRICS_HPP
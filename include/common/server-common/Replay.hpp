@@ -0,0 +1,157 @@
+#ifndef REPLAY_HPP
+#define REPLAY_HPP
+
+#include "Common.hpp"
+#include "Types.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// The replay of a match : what it takes to play it again exactly (the seed
+// of every board, the roster, the order the boards are updated in) and every
+// input, stamped with the tick it was applied on. It is written as the match
+// goes, in a compact append-only binary file, so a crash loses the last
+// second at most.
+//
+//   file   := "TRRP" version:u8 mode:u8 startTime:varint (ms since epoch)
+//             players:varint (nameLength:varint name seed:varint)*
+//             (tickOrder:varint)*                  (one index per player)
+//             record*
+//   record := INPUT tickDelta:varint player:varint action:u8
+//           | LEAVE tickDelta:varint player:varint after:varint score:varint lines:varint
+//           | END   tickDelta:varint players:varint (player score lines)*
+//
+// the tick of a record is the one of the record before it plus its delta,
+// players are indexes in the roster. a LEAVE happens during its tick, once
+// the first [after] boards of the tick order are updated.
+
+// where the master server writes them (one file per match)
+const std::string REPLAY_DIRECTORY = "replays";
+
+enum class ReplayEventType : std::uint8_t
+{
+    INPUT = 1,
+    LEAVE = 2,
+    END = 3,
+};
+
+struct ReplayPlayer
+{
+    std::string name;
+    std::uint32_t seed = 0;
+};
+
+// the score and lines of a player, when it left or when the match ended
+struct ReplayScore
+{
+    std::uint32_t player = 0;
+    int score = 0;
+    int lines = 0;
+};
+
+struct ReplayEvent
+{
+    ReplayEventType type = ReplayEventType::INPUT;
+    std::uint64_t tick = 0;
+    std::uint32_t player = 0;
+    Action action = Action::None;
+    // LEAVE only, how many boards of the tick order its tick updated before
+    std::uint32_t after = 0;
+    // one for a LEAVE, everyone still there for an END
+    std::vector<ReplayScore> scores;
+};
+
+struct Replay
+{
+    GameMode gameMode = GameMode::NONE;
+    std::uint64_t startTime = 0;
+    std::vector<ReplayPlayer> players;
+    // the roster indexes, in the order the server updated the boards
+    std::vector<std::uint32_t> tickOrder;
+    std::vector<ReplayEvent> events;
+    // false if the file stops before the END (server crash, match running)
+    bool complete = false;
+
+    // nothing if it isn't a replay at all (or of another version of the
+    // game logic). a truncated file gives what it has up to its last whole
+    // record
+    [[nodiscard]] static std::optional<Replay> parse(std::string_view data);
+};
+
+// builds the bytes of a replay, the caller decides where they go
+class ReplayEncoder
+{
+  public:
+    ReplayEncoder(GameMode gameMode, std::uint64_t startTime,
+                  const std::vector<ReplayPlayer>& players,
+                  const std::vector<std::uint32_t>& tickOrder);
+
+    void input(std::uint64_t tick, std::uint32_t player, Action action);
+    void leave(std::uint64_t tick, std::uint32_t after, const ReplayScore& score);
+    void end(std::uint64_t tick, const std::vector<ReplayScore>& scores);
+
+    // what was encoded since the last call
+    [[nodiscard]] std::string take();
+
+  private:
+    void record(ReplayEventType type, std::uint64_t tick);
+    void writeVarint(std::uint64_t value);
+
+    std::string pending;
+    std::uint64_t lastTick = 0;
+};
+
+// appends the bytes of every replay to their file, on its own thread : the
+// game's tick only hands them over
+class ReplayWriter
+{
+  public:
+    static ReplayWriter& instance() {
+        static ReplayWriter instance;
+        return instance;
+    }
+
+    // where the replays go, nothing recorded when empty (the default)
+    void setDirectory(const std::string& directory);
+    [[nodiscard]] std::string getDirectory() const;
+
+    // [last] closes the file once written
+    void append(const std::string& path, std::string bytes, bool last = false);
+
+    // waits until everything handed over so far is written
+    void flush();
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    void operator=(const ReplayWriter&) = delete;
+
+  private:
+    ReplayWriter();
+    ~ReplayWriter();
+
+    struct Chunk
+    {
+        std::string path;
+        std::string bytes;
+        bool last;
+    };
+
+    void writerLoop();
+
+    mutable std::mutex writerMutex;
+    std::condition_variable wakeUp;
+    std::condition_variable drained;
+    std::deque<Chunk> chunks;
+    bool writing = false;
+    bool stopping = false;
+    std::string directory;
+    std::thread writerThread;
+};
+
+#endif // REPLAY_HPP
@@ -0,0 +1,122 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include "Common.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Spans of time (a tick, a phase of the engine, a request...) recorded while
+// tracing is on, and written as a Chrome trace, to open in chrome://tracing or
+// ui.perfetto.dev. Each thread keeps its spans in its own buffer, the only
+// lock it takes is its own (nobody else's but the dump's). When tracing is
+// off, a span costs one relaxed load.
+
+// where "trace stop" writes the trace, if not told otherwise
+const std::string DEFAULT_TRACE_FILE = "tetris-trace.json";
+
+class Tracer
+{
+  public:
+    static Tracer& instance() {
+        static Tracer instance;
+        return instance;
+    }
+
+    [[nodiscard]] bool isEnabled() const {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    // start forgets the spans of the previous trace
+    void start();
+    void stop();
+
+    // what start recorded (until stop), in the Chrome trace event format
+    [[nodiscard]] std::string toChromeJson() const;
+    [[nodiscard]] StatusCode dump(const std::string& path) const;
+    [[nodiscard]] std::size_t spanCount() const;
+
+    // how the calling thread appears in the trace ("game-AB12CD tick")
+    void setThreadName(const std::string& name);
+
+    // [name] and [category] are not copied : string literals only
+    void record(const char* name, const char* category,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+
+    // a name that lives as long as the process, for the spans of a method
+    [[nodiscard]] static const char* methodName(ServerMethods method);
+
+    Tracer(const Tracer&) = delete;
+    void operator=(const Tracer&) = delete;
+
+  private:
+    Tracer() = default;
+    ~Tracer() = default;
+
+    struct Span
+    {
+        const char* name;
+        const char* category;
+        std::int64_t startNs; // since the steady clock's epoch
+        std::int64_t durationNs;
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        std::uint32_t id = 0;
+        std::string name;
+        std::vector<Span> spans;
+        std::uint64_t dropped = 0;
+    };
+
+    [[nodiscard]] ThreadBuffer& localBuffer();
+
+    // per thread, so a forgotten trace can't eat all the memory (~8 MB each)
+    static constexpr std::size_t MAX_SPANS_PER_THREAD = 1 << 18;
+
+    std::atomic_bool enabled{false};
+    std::atomic<std::int64_t> originNs{0};
+
+    mutable std::mutex buffersMutex;
+    // a buffer outlives its thread until the next start
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    std::uint32_t nextThreadID = 1;
+};
+
+// records the time between its construction and its destruction, if tracing
+// was on when it was built
+class TraceSpan
+{
+  public:
+    TraceSpan(const char* name, const char* category)
+        : name(name), category(category), active(Tracer::instance().isEnabled()) {
+        if (active) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TraceSpan() {
+        if (active) {
+            Tracer::instance().record(name, category, start, std::chrono::steady_clock::now());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+  private:
+    const char* name;
+    const char* category;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // TRACER_HPP
@@ -3,7 +3,11 @@
 
 #include "Common.hpp"
 #include "DBServer.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "Replay.hpp"
 #include "TetrisServer.hpp"
+#include "Tracer.hpp"
 
 #include <iostream>
 #include <memory>
@@ -15,7 +19,8 @@ class MasterServer
     // Compiler optimizations? (Another CLion suggestion)
     explicit MasterServer(const std::string& _ip = MASTER_SERVER_IP,
                           int _lobbyPort = LOBBY_SERVER_PORT,
-                          int _DBPort = DB_SERVER_PORT, bool _debug = false);
+                          int _DBPort = DB_SERVER_PORT,
+                          int _maxSessions = MAX_SESSIONS);
 
     ~MasterServer();
 
@@ -37,7 +42,7 @@ class MasterServer
     std::string ip;
     int lobbyPort;
     int dbPort;
-    bool debug;
+    int maxSessions;
 
     std::shared_ptr<TetrisServer> tetrisServer;
     std::shared_ptr<TetrisDBServer> dbServer;
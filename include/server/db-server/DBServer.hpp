@@ -3,17 +3,24 @@
 
 #include "Common.hpp"
 #include "HTTPServer.hpp"
+#include "Leaderboard.hpp"
+#include "Metrics.hpp"
 
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstdlib>
+#include <deque>
 #include <filesystem>
 #include <iostream>
 #include <mutex>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <openssl/sha.h>
 #include <sqlite3.h>
@@ -44,9 +51,61 @@ private:
     std::atomic<bool> stopFlag_;
     std::atomic<bool> running_;
 
+    // notification channel (long-poll), every account has a small queue of
+    // events (new message, friend request, ...) that /poll_notifications
+    // hands out. seq is global and only grows, so it doubles as the cursor
+    // (it starts over when the server restarts, a cursor from before that is
+    // taken as 0)
+    struct Notification {
+        std::uint64_t seq;
+        std::string type;
+        std::string fromID;
+    };
+
+    static constexpr std::size_t MAX_PENDING_NOTIFICATIONS = 128;
+    static constexpr int DEFAULT_POLL_TIMEOUT_SEC = 20;
+    static constexpr int MAX_POLL_TIMEOUT_SEC = 30;
+
+    std::unordered_map<std::string, std::deque<Notification> > notifications_;
+    std::uint64_t lastNotificationSeq_ = 0;
+    std::mutex notificationsMutex_;
+    std::condition_variable notificationsCV_;
+
+    // ranking of the players table, kept in memory (see Leaderboard.hpp)
+    Leaderboard leaderboard_;
+
+    static constexpr int DEFAULT_LEADERBOARD_LIMIT = 10;
+    static constexpr int DEFAULT_RANK_RADIUS = 2;
+
+    // accountIDs + userNames a single /resolve_accounts may ask for, sqlite
+    // caps the number of bound parameters of one statement
+    static constexpr std::size_t MAX_RESOLVE_ACCOUNTS = 256;
+
+    // dbMutex_, timed : how long a request waits for sqlite, and how long it
+    // keeps it busy once it has it (see Metrics.hpp)
+    class DBLock {
+    public:
+        explicit DBLock(std::mutex &mutex);
+
+        ~DBLock();
+
+        DBLock(const DBLock &) = delete;
+        DBLock &operator=(const DBLock &) = delete;
+
+    private:
+        std::chrono::steady_clock::time_point waitStart;
+        std::lock_guard<std::mutex> lock;
+        std::chrono::steady_clock::time_point lockedAt;
+    };
+
+    // the time to answer a request, per endpoint (the path, without the
+    // query). the unknown ones all go in "other"
+    [[nodiscard]] static Histogram &endpointDuration(const std::string &path);
+
     // Important
     void dbServerLoop(); // Runs the HTTP server in a non-blocking thread
     void initializeDatabase() const;
+    void loadLeaderboard();
 
     // Utility functions
     static void sendJSONResponse(http::response<http::string_body> &res,
@@ -62,6 +121,13 @@ private:
     static std::unordered_map<std::string, std::string>
     parseQuery(const std::string &query);
 
+    static boost::property_tree::ptree
+    leaderboardToJSON(const std::vector<LeaderboardEntry> &entries);
+
+    void pushNotification(const std::string &accountID,
+                          const std::string &type,
+                          const std::string &fromID);
+
     // Request dispatch functions
     void handleGetRequest(const http::request<http::string_body> &req,
                           http::response<http::string_body> &res);
@@ -95,6 +161,9 @@ private:
     void handleGetPlayer(const std::string &accountID, unsigned int version,
                          http::response<http::string_body> &res);
 
+    void handleGetRank(const std::string &query, unsigned int version,
+                       http::response<http::string_body> &res);
+
     void handleGetAccountIDByUsername(const std::string &username,
                                       unsigned int version,
                                       http::response<http::string_body> &res);
@@ -103,6 +172,10 @@ private:
                                       unsigned int version,
                                       http::response<http::string_body> &res);
 
+    void handleResolveAccounts(const boost::property_tree::ptree &pt,
+                               unsigned int version,
+                               http::response<http::string_body> &res);
+
     void handleSendFriendRequest(const boost::property_tree::ptree &pt,
                                  unsigned int version,
                                  http::response<http::string_body> &res);
@@ -129,6 +202,9 @@ private:
     void handleDeleteMessage(const boost::property_tree::ptree &pt,
                              unsigned int version,
                              http::response<http::string_body> &res);
+
+    void handlePollNotifications(const std::string &query, unsigned int version,
+                                 http::response<http::string_body> &res);
 };
 
 #endif // DBSERVER_SQLITE_HPP
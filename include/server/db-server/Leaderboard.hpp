@@ -0,0 +1,86 @@
+#ifndef LEADERBOARD_HPP
+#define LEADERBOARD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ext/pb_ds/assoc_container.hpp>
+#include <ext/pb_ds/tree_policy.hpp>
+
+struct LeaderboardEntry {
+    int rank;
+    std::string accountID;
+    std::string userName;
+    int score;
+};
+
+// in-memory copy of the players ranking, the players table stays the durable
+// backing but reads never have to sort it anymore. it is an order-statistics
+// tree, so updates, "what is my rank" and "give me the k-th player" are all
+// O(log n), and listing k players from there is O(k)
+class Leaderboard {
+public:
+    Leaderboard() = default;
+    ~Leaderboard() = default;
+
+    void clear();
+
+    // inserts the player or moves it to its new score
+    void setPlayer(const std::string &accountID, const std::string &userName,
+                   int score);
+
+    // moves a known player, returns false if we never heard of it
+    [[nodiscard]] bool setScore(const std::string &accountID, int score);
+
+    void setUserName(const std::string &accountID, const std::string &userName);
+
+    void removePlayer(const std::string &accountID);
+
+    [[nodiscard]] std::size_t size() const;
+
+    [[nodiscard]] std::vector<LeaderboardEntry> getTop(std::size_t count) const;
+
+    [[nodiscard]] std::optional<LeaderboardEntry> getEntry(const std::string &accountID) const;
+
+    // the player and up to 'radius' players above and below it
+    [[nodiscard]] std::vector<LeaderboardEntry> getAround(const std::string &accountID,
+                                                          std::size_t radius) const;
+
+private:
+    // best score first, ties broken by accountID so every key is unique
+    struct RankKey {
+        int score;
+        std::string accountID;
+    };
+
+    struct RankOrder {
+        bool operator()(const RankKey &a, const RankKey &b) const {
+            return a.score != b.score ? a.score > b.score : a.accountID < b.accountID;
+        }
+    };
+
+    using RankTree = __gnu_pbds::tree<RankKey, __gnu_pbds::null_type, RankOrder,
+                                      __gnu_pbds::rb_tree_tag,
+                                      __gnu_pbds::tree_order_statistics_node_update>;
+
+    struct PlayerInfo {
+        std::string userName;
+        int score;
+    };
+
+    RankTree ranking;
+    std::unordered_map<std::string, PlayerInfo> players;
+    mutable std::mutex leaderboardMutex;
+
+    [[nodiscard]] int rankOfScore(int score) const;
+
+    [[nodiscard]] std::vector<LeaderboardEntry> listFrom(std::size_t position,
+                                                         std::size_t count) const;
+};
+
+#endif // LEADERBOARD_HPP
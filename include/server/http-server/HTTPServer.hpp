@@ -1,5 +1,8 @@
 #pragma once
 
+#include "Common.hpp"
+#include "Metrics.hpp"
+
 #include <atomic>
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
@@ -33,11 +36,20 @@ class TetrisHTTPServer
                                        http::verb method,
                                        const std::string& body);
 
+    // one thread per connection, until the client closes it or sends nothing
+    // for HTTP_IDLE_TIMEOUT_SEC
     virtual void doSession(tcp::socket socket);
 
+    // GET /metrics, the same on every HTTP server (see Metrics.hpp)
+    static void handleMetricsRequest(const http::request<http::string_body>& req,
+                                     http::response<http::string_body>& res);
+
   private:
     void doAccept();
 
+    // whether a request started coming in before the idle timeout
+    [[nodiscard]] static bool waitForRequest(tcp::socket& socket);
+
     std::string address_;
     unsigned short port_;
 
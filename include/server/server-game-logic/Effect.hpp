@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Types.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class TetrisGame;
+
+// What a board does to another one during a tick : penalty lines (classic),
+// a malus (royale). A tick is done in two phases :
+//  1. every board is simulated on its own (GameEngine::handlingRoutine only
+//     ever touches the board it is given), what it does to the others is
+//     left in its effects
+//  2. the EffectQueue applies the effects of every board at once, in an
+//     order that doesn't depend on the one the boards were simulated in
+// so the boards of a tick can be simulated in any order, or at the same time
+
+enum class EffectType
+{
+    PenaltyLines,
+    Malus,
+};
+
+struct Effect
+{
+    EffectType type;
+    TetrisGame* target;
+    int lines = 0;                                       // PenaltyLines
+    TypePowerUps malus = TypePowerUps::invertedControls; // Malus
+
+    void apply() const;
+};
+
+class EffectQueue
+{
+  public:
+    // takes the effects [source] left during its phase 1
+    void collect(TetrisGame& source);
+
+    // phase 2 : by source (their player names), then in the order each source
+    // left them
+    void apply();
+
+    // [game] is leaving, nothing it did or that was done to it is applied
+    void forget(const TetrisGame* game);
+
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    struct Queued
+    {
+        const TetrisGame* source;
+        Effect effect;
+    };
+
+    std::vector<Queued> queued;
+};
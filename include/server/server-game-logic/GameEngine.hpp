@@ -28,6 +28,8 @@ class GameEngine
     virtual void handleGameLogic(TetrisGame& game);
     virtual void handleGameOver(TetrisGame& game);
     virtual void handleScore(TetrisGame& game, int linesCleared);
+    // one tick of [game], and of nothing else : what it does to the other
+    // boards is left in its effects (see Effect.hpp)
     virtual void handlingRoutine(TetrisGame& game, Action action);
 
     // interface for bonus and malus (should raise an exception if not
@@ -64,7 +64,7 @@ class GameMatrix
     void clearSingleLine(int line);
     [[nodiscard]] int clearFullLines();
     void pushNewLinesAtBottom(std::vector<std::vector<int>> newLines);
-    void pushPenaltyLinesAtBottom(int linesToAdd);
+    void pushPenaltyLinesAtBottom(int linesToAdd, std::mt19937& random);
     void destroyAreaAroundBlock(const Position2D pos, const int blastRadius);
 
     // util
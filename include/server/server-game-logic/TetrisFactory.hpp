@@ -4,6 +4,7 @@
 #include "Types.hpp"
 
 #include <algorithm>
+#include <cstdint>
 #include <random>
 #include <vector>
 
@@ -25,6 +26,9 @@ public:
   [[nodiscard]] bool isPoolEmpty() const;
   [[nodiscard]] int getPoolSize() const;
 
+  // same seed, same pieces (the pool is refilled from it)
+  void reseed(std::uint32_t seed);
+
 
 private:
     
@@ -1,12 +1,15 @@
 #pragma once
 
 #include "Bag.hpp"
+#include "Effect.hpp"
 #include "GameMatrix.hpp"
 #include "TetrisFactory.hpp"
 #include "Common.hpp"
 
+#include <cstdint>
 #include <iostream>
 #include <map>
+#include <random>
 
 class TetrisGame
 {
@@ -29,6 +32,8 @@ class TetrisGame
     GameMatrix gameMatrix;
     TetrisFactory factory;
     Bag bag;
+    // everything random in the game but the pieces (penalty holes, power ups)
+    std::mt19937 random;
     int score;
 
     // some game variables
@@ -47,6 +52,10 @@ class TetrisGame
     // name of the player
     std::string playerName;
 
+    // what this board did to the others this tick, applied once every board
+    // of the tick is simulated (see Effect.hpp)
+    std::vector<Effect> effects;
+
     // flags for powers ups
     bool blockControlsFlag = false;
     bool reverseControlsFlag = false;
@@ -81,6 +90,12 @@ class TetrisGame
     [[nodiscard]] virtual bool getReverseControlsFlag() const noexcept;
     [[nodiscard]] virtual bool getDarkModeFlag() const noexcept;
 
+    // the pieces and everything else random in the game come from [seed]
+    // only, a game is played again the same from the same seed and inputs
+    virtual void setSeed(std::uint32_t seed);
+    // in [0, bound)
+    [[nodiscard]] int randomIndex(int bound);
+
     // special getters
     [[nodiscard]] Tetromino& getNextPiece();
     [[nodiscard]] const Tetromino* getHoldPiece() const;
@@ -138,4 +153,8 @@ class TetrisGame
     virtual void startBlockControls();
     virtual void startInvertedControls();
     virtual void pushSingleBlock();
+
+    // effects on the other boards, for the EffectQueue
+    void emitEffect(const Effect& effect);
+    [[nodiscard]] std::vector<Effect> takeEffects();
 };
@@ -3,16 +3,29 @@
 #define GAME_HPP
 
 #include "Common.hpp"
+#include "Fragmentation.hpp"
 #include "GameCreator.hpp"
 #include "GameEngine.hpp"
+#include "GameOverview.hpp"
 #include "GameState.hpp"
 #include "KeyStroke.hpp"
 #include "LobbyState.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "PresenceIndex.hpp"
+#include "Replay.hpp"
 #include "ServerRequest.hpp"
 #include "ServerResponse.hpp"
 #include "TetrisGame.hpp"
+#include "Tracer.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <thread>
 #include <utility>
@@ -26,8 +39,7 @@
 class Game
 {
   public:
-    Game(const std::string& ip, const LobbyState& lobbyState,
-         bool debug = false);
+    Game(const std::string& ip, const LobbyState& lobbyState);
     ~Game();
 
     [[nodiscard]] StatusCode startGame();
@@ -35,6 +47,18 @@ class Game
 
     [[nodiscard]] bool isSessionInGame(const std::string& token);
 
+    // false once every player left (or the game was closed), the game server
+    // then reaps it
+    [[nodiscard]] bool isRunning();
+    [[nodiscard]] std::string getGameID() const;
+    [[nodiscard]] std::uint64_t getTicks();
+
+    // a player / spectator whose session expired
+    void evictSession(const std::string& token);
+
+    // the lobby server's presence index, told whenever someone leaves
+    void setPresenceIndex(std::shared_ptr<PresenceIndex> index);
+
   private:
     [[nodiscard]] StatusCode initializeSocket();
     [[nodiscard]] StatusCode setSocketOptions();
@@ -45,6 +69,8 @@ class Game
 
     std::shared_ptr<TetrisGame> getGame(const std::string& token);
     void updateGame();
+    void updateOverview();
+    void finishReplay();
 
     [[nodiscard]] std::unordered_map<std::string, std::string> getPlayers();
     [[nodiscard]] std::unordered_map<std::string, std::string> getSpectators();
@@ -55,6 +81,7 @@ class Game
     [[nodiscard]] ServerResponse handleKeyStrokeRequest(const ServerRequest& request);
     [[nodiscard]] ServerResponse handleKeyStroke(const KeyStrokePacket& packet, const ServerRequest& request);
     [[nodiscard]] ServerResponse handleGetGameStateRequest(const ServerRequest& request);
+    [[nodiscard]] ServerResponse handleGetGameOverviewRequest(const ServerRequest& request);
     [[nodiscard]] std::string getGameState(const std::string& token);
     [[nodiscard]] std::string getPlayerGameState(const std::string& token);
     [[nodiscard]] std::string getSpectatorGameState(const std::string& token);
@@ -70,15 +97,39 @@ class Game
     int gameSocket;
     struct sockaddr_in gameAddr;
     struct sockaddr_in clientAddr;
+    FragmentReader fragmentReader; // requests too big for one datagram
+    FragmentWriter fragmentWriter; // responses too big for one datagram
 
     LobbyState lobbyState;
     bool running = false;
-    bool debug;
 
     // model stuff (mvc?)
     std::unordered_map<std::string, std::shared_ptr<TetrisGame>> games;
     std::shared_ptr<GameEngine> engine;
-    std::unordered_map<std::string, Action> actionMap;
+    // what the boards did to each other this tick, applied at its end
+    // (under gameMutex)
+    EffectQueue effects;
+
+    // key strokes are kept in order and applied one per tick, each one with
+    // the sequence number the client gave it so we can tell it which of its
+    // inputs are already in the state it receives
+    struct QueuedAction
+    {
+        Action action;
+        int sequence;
+    };
+    std::unordered_map<std::string, std::deque<QueuedAction>> actionQueues;
+    std::unordered_map<std::string, int> lastInputSequence;
+
+    // past this, the oldest key strokes are dropped (the client is spamming
+    // faster than GAME_UPDATE_INTERVAL and would lag behind forever)
+    static constexpr std::size_t MAX_QUEUED_ACTIONS = 16;
+
+    // every board of the game (see GameOverview), serialized by the update
+    // thread every OVERVIEW_UPDATE_INTERVAL and sent as is to whoever asks
+    std::string overview;
+    std::mutex overviewMutex;
+    int ticksSinceOverview = 0;
 
     // mutexes and threads
     std::mutex gameMutex;
@@ -90,6 +141,25 @@ class Game
     std::thread gameRoutineThread;
     std::thread updateThread;
     std::thread listenThread;
+
+    std::shared_ptr<PresenceIndex> presence;
+
+    // the replay of the match (see Replay.hpp), if the server records them.
+    // everything here is under gameMutex, the tick hands the bytes to the
+    // ReplayWriter every REPLAY_FLUSH_TICKS and never writes them itself
+    struct ReplaySeat
+    {
+        std::uint32_t player;   // in the roster
+        std::uint32_t position; // in the tick order
+    };
+    std::optional<ReplayEncoder> replay;
+    std::string replayPath;
+    std::unordered_map<std::string, ReplaySeat> replaySeats;
+    std::uint64_t ticks = 0;
+    // how many boards of the tick order the current tick already updated
+    std::uint32_t updatedThisTick = 0;
+
+    static constexpr int REPLAY_FLUSH_TICKS = 1000 / GAME_UPDATE_INTERVAL;
 };
 
 #endif
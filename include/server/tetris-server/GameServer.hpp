@@ -4,8 +4,10 @@
 #include "Common.hpp"
 #include "Game.hpp"
 #include "LobbyServer.hpp"
+#include "Logger.hpp"
 
 #include <Lobby.hpp>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -21,30 +23,42 @@ class GameServer
 {
   public:
     GameServer(const std::string& ip,
-               const std::shared_ptr<LobbyServer>& lobbyServer,
-               bool debug = false);
+               const std::shared_ptr<LobbyServer>& lobbyServer);
     ~GameServer();
 
     [[nodiscard]] StatusCode startGameServer();
     [[nodiscard]] StatusCode closeGameServer();
 
     [[nodiscard]] bool isSessionInAnyGame(const std::string& token);
+    // the lobby server ended this session, it leaves its game (gameID)
+    void evictSession(const std::string& token, const std::string& gameID);
 
     [[nodiscard]] int countGames();
     [[nodiscard]] bool isRunning();
 
+    // called for every game reapGames closed, with its ID (the one of the
+    // lobby it was started from), on the game server's thread once the game
+    // is closed
+    using GameFinishedCallback = std::function<void(const std::string& gameID)>;
+    void onGameFinished(GameFinishedCallback callback);
+
   private:
     void listen();
     void startGame(const std::shared_ptr<Lobby>& lobby);
+    void reapGames();
     void printMessage(const std::string& message, MessageType msgType) const;
 
     std::string ip;
     std::shared_ptr<LobbyServer> lobbyServer;
-    bool debug;
     bool running = false;
 
+    // a game stays here until it stops running (everyone left), then it is
+    // closed by reapGames : its threads are joined, its port is free for the
+    // next lobby and it no longer counts against MAX_GAMES
     std::vector<std::shared_ptr<Game>> activeGames;
-    std::vector<std::thread> gameThreads = {};
+
+    std::vector<GameFinishedCallback> finishedCallbacks;
+    std::mutex callbacksMutex;
 
     // mutexes and threads
     std::mutex gamesMutex;
@@ -2,11 +2,18 @@
 #define LOBBY_HPP
 
 #include "Common.hpp"
+#include "Fragmentation.hpp"
+#include "LobbyListing.hpp"
 #include "LobbyState.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "PresenceIndex.hpp"
 #include "ServerRequest.hpp"
 #include "ServerResponse.hpp"
+#include "Tracer.hpp"
 
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -25,8 +32,7 @@ class Lobby
 
   public:
     Lobby(const std::string& IPAddr, int port, const std::string& lobbyID,
-          GameMode gameMode, int maxPlayers, bool isPublic = true,
-          bool debug = false);
+          GameMode gameMode, int maxPlayers, bool isPublic = true);
     ~Lobby();
 
     // connectivity management
@@ -39,6 +45,11 @@ class Lobby
     [[nodiscard]] StatusCode addSpectator(const std::string& sessionToken, const std::string& username);
     [[nodiscard]] StatusCode removeSpectator(const std::string& sessionToken);
 
+    // the lobby server's presence index, told whenever someone joins or leaves
+    void setPresenceIndex(std::shared_ptr<PresenceIndex> index);
+    // the lobby server's public listing, marked dirty whenever the state changes
+    void setLobbyListing(std::shared_ptr<LobbyListing> lobbyListing);
+
     // info that we might want to use outside of the class
     [[nodiscard]] LobbyState getState();
     [[nodiscard]] int getPort();
@@ -69,6 +80,8 @@ class Lobby
 
     // dead lobby stuff
     void setHasEverBeenJoined(bool flag);
+
+    void markListingDirty() const;
     [[nodiscard]] bool getHasEverBeenJoined() const;
 
     std::string ip;
@@ -79,6 +92,8 @@ class Lobby
     int lobbySocket;
     struct sockaddr_in lobbyAddr;
     struct sockaddr_in clientAddr;
+    FragmentReader fragmentReader; // requests too big for one datagram
+    FragmentWriter fragmentWriter; // responses too big for one datagram
 
     std::thread listenThread;
 
@@ -86,7 +101,6 @@ class Lobby
     GameMode gameMode;
     int maxPlayers;
     bool isPublic;
-    bool debug;
     bool running = false;
     bool hasEverBeenJoined = false;
     std::unordered_map<std::string, bool> readyPlayers;
@@ -96,6 +110,9 @@ class Lobby
     std::unordered_map<std::string, std::string> players;
     std::unordered_map<std::string, std::string> spectators;
     std::mutex stateMutex;
+
+    std::shared_ptr<PresenceIndex> presence;
+    std::shared_ptr<LobbyListing> listing;
 };
 
 #endif
\ No newline at end of file
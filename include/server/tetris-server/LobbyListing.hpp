@@ -0,0 +1,68 @@
+#ifndef LOBBY_LISTING_HPP
+#define LOBBY_LISTING_HPP
+
+#include "Common.hpp"
+#include "LobbyState.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+// the public lobby listing, serialized once and kept until a lobby changes
+// (the lobbies and the lobby server mark it dirty, the next request rebuilds
+// it). every rebuild that changes something gets a new version, so a client
+// that already has the current one gets a "not modified" answer instead of the
+// whole list. the listing is split in pages small enough for one datagram,
+// for every game mode and for all of them together
+
+class LobbyListing
+{
+  public:
+    LobbyListing();
+    ~LobbyListing() = default;
+
+    // one page of the listing, [lobbies] being a json array of lobby states
+    struct Page
+    {
+        int version = 0;
+        int pageCount = 0;
+        bool notModified = false;
+        std::string lobbies = "[]";
+    };
+
+    void markDirty();
+
+    // rebuilds the listing if something changed since the last time, with
+    // the states given by [collect] (only called when a rebuild is needed)
+    void refresh(const std::function<std::vector<LobbyState>()>& collect);
+
+    // the page of the lobbies with this game mode (or all of them), not
+    // modified if knownVersion is the current version
+    [[nodiscard]] Page getPage(std::optional<GameMode> gameMode, int page,
+                               int knownVersion) const;
+    [[nodiscard]] int getVersion() const;
+
+  private:
+    // all the game modes together
+    static constexpr int ALL_MODES = -1;
+    // versions wrap around, and never go negative (NO_LOBBY_LIST_VERSION)
+    static constexpr int MAX_VERSION = 1 << 30;
+
+    [[nodiscard]] static std::vector<std::string>
+    paginate(const std::vector<std::string>& lobbies);
+
+    std::atomic_bool dirty{true};
+
+    // FILTER (a game mode or ALL_MODES) -> PAGES, sorted by lobby ID
+    std::map<int, std::vector<std::string>> pages;
+    int version;
+
+    mutable std::mutex listingMutex;
+};
+
+#endif
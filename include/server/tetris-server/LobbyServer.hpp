@@ -2,10 +2,16 @@
 #define LOBBY_SERVER_HPP
 
 #include "Common.hpp"
+#include "Fragmentation.hpp"
 #include "GameServer.hpp"
 #include "Lobby.hpp"
+#include "LobbyListing.hpp"
+#include "Logger.hpp"
+#include "Metrics.hpp"
+#include "PresenceIndex.hpp"
 #include "ServerRequest.hpp"
 #include "ServerResponse.hpp"
+#include "Tracer.hpp"
 
 #include <iostream>
 #include <memory>
@@ -31,13 +37,16 @@ class GameServer;
 class LobbyServer
 {
   public:
-    LobbyServer(const std::string& IPAddr, int listenPort, bool debug = false);
+    LobbyServer(const std::string& IPAddr, int listenPort,
+                int maxSessions = MAX_SESSIONS);
     ~LobbyServer();
 
     [[nodiscard]] StatusCode startLobbyServer();
     [[nodiscard]] StatusCode closeLobbyServer();
 
     void setGameServer(std::shared_ptr<GameServer> gameServer);
+    // the game server closed this game (see GameServer::onGameFinished)
+    void handleGameFinished(const std::string& gameID);
 
     // session management
     [[nodiscard]] StatusCode addClientSession(const std::string& token,
@@ -47,6 +56,7 @@ class LobbyServer
     getClientSessionUsername(const std::string& token) const;
     [[nodiscard]] std::string
     getClientSessionToken(const std::string& username) const;
+    [[nodiscard]] std::shared_ptr<PresenceIndex> getPresenceIndex() const;
 
     [[nodiscard]] std::shared_ptr<Lobby> getLobby(
         const std::string& lobbyID) const; // maybe this needs to be private
@@ -56,6 +66,7 @@ class LobbyServer
     // data analysis mostly lol we want some stats to flex with pretty gui
     [[nodiscard]] int countPlayers() const;
     [[nodiscard]] int countLobbies() const;
+    [[nodiscard]] int getMaxSessions() const;
     [[nodiscard]] bool isRunning();
 
     // this is called by the game server to get the lobbies that are ready
@@ -74,6 +85,9 @@ class LobbyServer
 
     [[nodiscard]] bool isSessionActive(const std::string& token) const;
     [[nodiscard]] bool doesUserHaveSession(const std::string& username) const;
+    // ends the sessions nothing was heard from for SESSION_TIMEOUT_SEC, and
+    // takes them out of their lobby / game
+    void reapIdleSessions();
     void printMessage(const std::string& message, MessageType msgtype) const;
 
     // generation shit
@@ -102,6 +116,10 @@ class LobbyServer
     handleSpectateLobbyRequest(const ServerRequest& request) const;
     [[nodiscard]] ServerResponse
     handleGetClientStatusRequest(const ServerRequest& request) const;
+    [[nodiscard]] ServerResponse
+    handleGetClientStatusesRequest(const ServerRequest& request) const;
+    [[nodiscard]] ServerResponse
+    handleHeartbeatRequest(const ServerRequest& request) const;
 
     // attributes
 
@@ -109,21 +127,25 @@ class LobbyServer
     int port;
     std::shared_ptr<GameServer>
         gameServer; // the game server that is using this lobby server
-    bool debug;
+    int maxSessions; // MAX_SESSIONS unless the master server says otherwise
     bool running = false;
 
     int serverSocket;
     struct sockaddr_in serverAddr;
     struct sockaddr_in clientAddr;
+    FragmentReader fragmentReader; // requests too big for one datagram
+    FragmentWriter fragmentWriter; // responses too big for one datagram
 
     std::unordered_map<std::string, int> lobbies; // LOBBY ID -> PORT USED
     std::unordered_map<std::string, std::shared_ptr<Lobby>>
         lobbyObjects; // LOBBY ID -> LOBBY POINTER
-    std::unordered_map<std::string, std::string>
-        clientTokens; // TOKEN -> USERNAME
+    std::shared_ptr<PresenceIndex>
+        presence; // TOKEN <-> USERNAME -> WHERE THEY ARE (shared with lobbies
+                  // and games)
+    std::shared_ptr<LobbyListing>
+        listing; // PUBLIC LOBBIES, SERIALIZED (marked dirty by the lobbies)
 
     mutable std::mutex lobbiesMutex; // protecting access to lobbies
-    mutable std::mutex clientMutex;  // protecting access to clients
     std::mutex runningMutex;         // protecting access to running flag
     std::mutex listenMutex;          // protecting access to listen function
 
@@ -0,0 +1,96 @@
+#ifndef PRESENCE_INDEX_HPP
+#define PRESENCE_INDEX_HPP
+
+#include "Common.hpp"
+#include "TimerWheel.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// the sessions of the lobby server (TOKEN <-> USERNAME, both ways) and where
+// every connected player is (menu, which lobby, which game), kept up to date by
+// the lobby server, the lobbies and the games as players come and go. every
+// lookup is a hash map access instead of going through every session, every
+// lobby and every game. it also knows when each session was last heard from,
+// so the sessions of crashed clients can be ended
+
+class PresenceIndex
+{
+  public:
+    using Clock = TimerWheel::Clock;
+
+    explicit PresenceIndex(
+        Clock::duration sessionTimeout = std::chrono::seconds(SESSION_TIMEOUT_SEC));
+    ~PresenceIndex() = default;
+
+    // sessions : an older session of the same user is replaced (and doesn't
+    // count against maxSessions). SUCCESS, SUCCESS_REPLACED_SESSION,
+    // ERROR_SESSION_ALREADY_EXISTS or ERROR_MAX_PLAYERS_REACHED
+    [[nodiscard]] StatusCode addSession(const std::string& token,
+                                        const std::string& username,
+                                        std::size_t maxSessions);
+    [[nodiscard]] bool removeSession(const std::string& token);
+    void clear();
+
+    // lobbies and games, placeID being the lobby ID (a game keeps the ID of
+    // the lobby it was started from)
+    void enter(const std::string& token, ClientStatus status,
+               const std::string& placeID);
+    // back to the menu, unless the session already went somewhere else
+    void leave(const std::string& token, const std::string& placeID);
+    // everybody still in this place with this status goes back to the menu
+    void leaveAll(const std::string& placeID, ClientStatus status);
+
+    [[nodiscard]] bool hasSession(const std::string& username) const;
+    [[nodiscard]] bool hasToken(const std::string& token) const;
+    [[nodiscard]] std::optional<std::string>
+    getToken(const std::string& username) const;
+    [[nodiscard]] std::optional<std::string>
+    getUsername(const std::string& token) const;
+    [[nodiscard]] ClientStatus getStatus(const std::string& username) const;
+    [[nodiscard]] std::vector<ClientStatus>
+    getStatuses(const std::vector<std::string>& names) const;
+    [[nodiscard]] std::size_t size() const;
+
+    // heartbeats : the session was heard from (any request with its token).
+    // false if there is no such session
+    bool touch(const std::string& token, Clock::time_point now = Clock::now());
+
+    // the sessions nothing was heard from for sessionTimeout, they are removed
+    // here. where they were is given so the lobby server can take them out
+    struct Expired
+    {
+        std::string token;
+        std::string username;
+        ClientStatus status;
+        std::string placeID;
+    };
+    [[nodiscard]] std::vector<Expired> expire(Clock::time_point now = Clock::now());
+
+  private:
+    struct Presence
+    {
+        std::string token;
+        ClientStatus status = ClientStatus::IN_MENU;
+        std::string placeID;
+    };
+
+    [[nodiscard]] ClientStatus statusOf(const std::string& username) const;
+
+    std::unordered_map<std::string, Presence> presences; // USERNAME -> PRESENCE
+    std::unordered_map<std::string, std::string> usernames; // TOKEN -> USERNAME
+    Clock::duration sessionTimeout;
+    TimerWheel deadlines; // TOKEN -> WHEN IT EXPIRES, one slot per second
+
+    mutable std::mutex presenceMutex;
+
+    // more than SESSION_TIMEOUT_SEC, so a deadline is seen in one turn
+    static constexpr std::size_t SESSION_WHEEL_SLOTS = 128;
+};
+
+#endif
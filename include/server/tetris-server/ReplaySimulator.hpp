@@ -0,0 +1,48 @@
+#ifndef REPLAY_SIMULATOR_HPP
+#define REPLAY_SIMULATOR_HPP
+
+#include "Common.hpp"
+#include "GameCreator.hpp"
+#include "Replay.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Plays a replay again without a server, a socket or a clock : the boards are
+// built the way Game builds them (same roster, same seeds), and every tick
+// updates them in the recorded order with the recorded inputs, as fast as the
+// engine goes. The scores the file recorded (when a player left, at the end)
+// are checked against the simulated ones.
+
+struct ReplayOutcome
+{
+    std::string name;
+    int score = 0;
+    int lines = 0;
+    bool gameOver = false;
+    bool left = false;
+    // what the server recorded for this player, if it did
+    std::optional<ReplayScore> recorded;
+
+    [[nodiscard]] bool matches() const;
+};
+
+struct ReplayResult
+{
+    std::uint64_t ticks = 0;
+    // in roster order
+    std::vector<ReplayOutcome> players;
+
+    [[nodiscard]] bool verified() const;
+};
+
+class ReplaySimulator
+{
+  public:
+    // nothing if the game mode has no engine
+    [[nodiscard]] static std::optional<ReplayResult> simulate(const Replay& replay);
+};
+
+#endif
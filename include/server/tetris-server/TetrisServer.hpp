@@ -4,6 +4,7 @@
 #include "Common.hpp"
 #include "GameServer.hpp"
 #include "LobbyServer.hpp"
+#include "Logger.hpp"
 
 #include <iostream>
 #include <memory>
@@ -13,7 +14,8 @@
 class TetrisServer
 {
   public:
-    TetrisServer(const std::string& ip, int listenPort, bool debug = false);
+    TetrisServer(const std::string& ip, int listenPort,
+                 int maxSessions = MAX_SESSIONS);
 
     ~TetrisServer();
 
@@ -38,7 +40,6 @@ class TetrisServer
 
     std::string ip;
     int lobbyPort;
-    bool debug;
 
     std::shared_ptr<LobbyServer> lobbyServer;
     std::shared_ptr<GameServer> gameServer;
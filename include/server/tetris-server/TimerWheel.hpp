@@ -0,0 +1,63 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// deadlines for a lot of keys (the session tokens), where almost every
+// deadline is pushed back before it is reached. the keys are put in a ring of
+// slots, one per [resolution] of time, and only the slots whose time has come
+// are looked at. pushing a deadline back is just a hash map update : the key
+// stays in its slot, and when that slot comes it is moved to the slot of its
+// new deadline instead of expiring. not thread safe, the owner locks it
+
+class TimerWheel
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    TimerWheel(Clock::duration resolution, std::size_t slotCount,
+               Clock::time_point start = Clock::now());
+    ~TimerWheel() = default;
+
+    // sets the deadline of the key (a new one or an earlier / later one)
+    void schedule(const std::string& key, Clock::time_point deadline);
+    void cancel(const std::string& key);
+    void clear();
+
+    // the keys whose deadline is passed, they are forgotten. a deadline is
+    // seen at most [resolution] late
+    [[nodiscard]] std::vector<std::string> advance(Clock::time_point now);
+
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    struct Timer
+    {
+        Clock::time_point deadline;
+        std::uint64_t tick;       // of the slot it is in (not always the deadline's)
+        std::uint64_t generation; // the slot entry that still counts
+    };
+    struct Entry
+    {
+        std::string key;
+        std::uint64_t generation;
+    };
+
+    // the first tick a deadline is sure to be passed at
+    [[nodiscard]] std::uint64_t dueTick(Clock::time_point deadline) const;
+    void place(const std::string& key, Timer& timer, std::uint64_t tick);
+
+    Clock::duration resolution;
+    Clock::time_point start;
+    std::vector<std::vector<Entry>> slots;
+    std::unordered_map<std::string, Timer> timers;
+    std::uint64_t nextTick = 0;       // the next slot advance looks at
+    std::uint64_t nextGeneration = 0; // entries of a rescheduled key are stale
+};
+
+#endif
@@ -16,10 +16,18 @@ int main(int argc, char *argv[]) {
     // Load the session
     ClientSession session(config);
 
+    // Decode the background once, every screen paints it
+    BackgroundCache::instance().preload();
+
     // Create the main window
     LoginScreen loginScreen(session);
     loginScreen.showMaximized();
 
-    return a.exec();
+    const int status = a.exec();
+
+    // the pixmaps go before the application does
+    BackgroundCache::instance().clear();
+
+    return status;
 
 }
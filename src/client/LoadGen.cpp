@@ -0,0 +1,583 @@
+#include "LoadGen.hpp"
+
+#include "GameState.hpp"
+#include "KeyStroke.hpp"
+#include "LobbyState.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// ==================================================== //
+//                   LatencyRecorder                    //
+// ==================================================== //
+
+void
+LatencyRecorder::record(const ServerMethods method,
+                        const std::chrono::microseconds latency,
+                        const StatusCode status) {
+    std::lock_guard lock(statsMutex);
+    MethodStats &methodStats = stats[method];
+
+    // ERROR_RECEIVING_RESPONSE is what the channel answers when a request
+    // expires, the other two mean it never left the client
+    switch (status) {
+        case StatusCode::ERROR_RECEIVING_RESPONSE:
+            ++methodStats.timedOut;
+            return;
+        case StatusCode::ERROR_SENDING_REQUEST:
+        case StatusCode::ERROR_NOT_CONNECTED:
+            ++methodStats.dropped;
+            return;
+        case StatusCode::SUCCESS:
+        case StatusCode::SUCCESS_REPLACED_SESSION:
+        case StatusCode::SUCCESS_NOT_MODIFIED:
+            break;
+        default:
+            ++methodStats.errors;
+            break;
+    }
+
+    methodStats.latenciesUs.push_back(latency.count());
+}
+
+void
+LatencyRecorder::report(std::ostream &out,
+                        const std::chrono::milliseconds elapsed) const {
+    std::lock_guard lock(statsMutex);
+
+    const double seconds = std::max(1.0, static_cast<double>(elapsed.count())) / 1000.0;
+
+    // nearest rank, on a sorted copy
+    auto percentile = [](const std::vector<std::int64_t> &sorted, const double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const auto rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+        return static_cast<double>(sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1]) / 1000.0;
+    };
+
+    out << std::left << std::setw(20) << "method" << std::right
+        << std::setw(9) << "answered" << std::setw(9) << "req/s"
+        << std::setw(10) << "p50 ms" << std::setw(10) << "p90 ms"
+        << std::setw(10) << "p99 ms" << std::setw(10) << "max ms"
+        << std::setw(8) << "errors" << std::setw(10) << "timeouts"
+        << std::setw(9) << "dropped" << '\n';
+
+    std::size_t totalAnswered = 0;
+    int totalErrors = 0, totalTimedOut = 0, totalDropped = 0;
+
+    out << std::fixed << std::setprecision(2);
+    for (const auto &[method, methodStats]: stats) {
+        std::vector<std::int64_t> sorted = methodStats.latenciesUs;
+        std::ranges::sort(sorted);
+
+        const std::size_t sent = sorted.size() + methodStats.timedOut + methodStats.dropped;
+        out << std::left << std::setw(20) << getServerMethodString(method) << std::right
+            << std::setw(9) << sorted.size()
+            << std::setw(9) << static_cast<double>(sent) / seconds
+            << std::setw(10) << percentile(sorted, 50)
+            << std::setw(10) << percentile(sorted, 90)
+            << std::setw(10) << percentile(sorted, 99)
+            << std::setw(10) << percentile(sorted, 100)
+            << std::setw(8) << methodStats.errors
+            << std::setw(10) << methodStats.timedOut
+            << std::setw(9) << methodStats.dropped << '\n';
+
+        totalAnswered += sorted.size();
+        totalErrors += methodStats.errors;
+        totalTimedOut += methodStats.timedOut;
+        totalDropped += methodStats.dropped;
+    }
+
+    out << std::left << std::setw(20) << "TOTAL" << std::right
+        << std::setw(9) << totalAnswered
+        << std::setw(9) << static_cast<double>(totalAnswered + totalTimedOut + totalDropped) / seconds
+        << std::setw(40) << ""
+        << std::setw(8) << totalErrors << std::setw(10) << totalTimedOut
+        << std::setw(9) << totalDropped << std::endl;
+    out << std::defaultfloat;
+}
+
+// ==================================================== //
+//                       BotTable                       //
+// ==================================================== //
+
+BotTable::BotTable(const GameMode gameMode, const int seats)
+    : gameMode(gameMode), seats(seats) {
+}
+
+GameMode
+BotTable::getGameMode() const {
+    return gameMode;
+}
+
+int
+BotTable::getSeats() const {
+    return seats;
+}
+
+void
+BotTable::publishLobby(const std::string &lobbyID) {
+    {
+        std::lock_guard lock(lobbyMutex);
+        this->lobbyID = lobbyID;
+        ++lobbyGeneration;
+    }
+    lobbyCV.notify_all();
+}
+
+std::string
+BotTable::waitForLobby(int &generation, const std::chrono::milliseconds timeout) {
+    std::unique_lock lock(lobbyMutex);
+    if (!lobbyCV.wait_for(lock, timeout, [&] {
+        return closed || lobbyGeneration > generation;
+    }) || closed) {
+        return "";
+    }
+
+    generation = lobbyGeneration;
+    return lobbyID;
+}
+
+void
+BotTable::close() {
+    {
+        std::lock_guard lock(lobbyMutex);
+        closed = true;
+    }
+    lobbyCV.notify_all();
+}
+
+// ==================================================== //
+//                          Bot                         //
+// ==================================================== //
+
+Bot::Bot(const int id, const LoadGenConfig &config,
+         std::shared_ptr<BotTable> table, const bool isHost,
+         LatencyRecorder &recorder)
+    : id(id), config(config), table(std::move(table)), isHost(isHost),
+      recorder(recorder),
+      requestManager(config.serverIP, config.lobbyServerPort),
+      username("bot-" + std::to_string(id)),
+      random(config.seed + static_cast<unsigned>(id)) {
+}
+
+int
+Bot::getGamesPlayed() const {
+    return gamesPlayed;
+}
+
+ServerResponse
+Bot::timed(const ServerMethods method,
+           const std::function<ServerResponse()> &request) {
+    const auto start = std::chrono::steady_clock::now();
+    ServerResponse response = request();
+    recorder.record(method,
+                    std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start),
+                    response.status);
+    return response;
+}
+
+// sleeps [ms], but wakes up early once the run is over
+static void
+pause(const std::atomic_bool &running, const int ms) {
+    const auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (running && std::chrono::steady_clock::now() < until) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void
+Bot::run(const std::atomic_bool &running) {
+    if (requestManager.connectToServer() != StatusCode::SUCCESS) {
+        std::cerr << username << " could not connect to the server" << std::endl;
+        return;
+    }
+
+    const ServerResponse session = timed(ServerMethods::START_SESSION, [&] {
+        return requestManager.startSession(username);
+    });
+    const auto tokenIt = session.data.find("token");
+    if ((session.status != StatusCode::SUCCESS &&
+         session.status != StatusCode::SUCCESS_REPLACED_SESSION) ||
+        tokenIt == session.data.end()) {
+        std::cerr << username << " has no session : "
+                  << getStatusCodeString(session.status) << std::endl;
+        (void) requestManager.disconnectFromServer();
+        return;
+    }
+    token = tokenIt->second;
+
+    while (running) {
+        if (playLobby(running)) {
+            playGame(running);
+        }
+    }
+
+    (void) timed(ServerMethods::END_SESSION, [&] {
+        return requestManager.endSession(token);
+    });
+    (void) requestManager.disconnectFromServer();
+}
+
+bool
+Bot::playLobby(const std::atomic_bool &running) {
+    if (isHost) {
+        const ServerResponse created = timed(ServerMethods::CREATE_LOBBY, [&] {
+            return requestManager.createAndJoinLobby(token, table->getGameMode(),
+                                                     table->getSeats(), true);
+        });
+        if (created.status != StatusCode::SUCCESS) {
+            // most likely MAX_LOBBIES, some other table has to finish first
+            pause(running, 1000);
+            return false;
+        }
+
+        // the answer only has the port, the id comes with the lobby state
+        const ServerResponse lobby = timed(ServerMethods::GET_CURRENT_LOBBY, [&] {
+            return requestManager.getCurrentLobbyState(token);
+        });
+        std::string lobbyID;
+        try {
+            lobbyID = LobbyState::deserialize(lobby.data.at("lobby")).lobbyID;
+        } catch (const std::exception &) {
+        }
+        if (lobby.status != StatusCode::SUCCESS || lobbyID.empty()) {
+            (void) timed(ServerMethods::LEAVE_LOBBY, [&] {
+                return requestManager.leaveLobby(token);
+            });
+            return false;
+        }
+        table->publishLobby(lobbyID);
+    } else {
+        const std::string lobbyID = table->waitForLobby(
+            lobbyGeneration, std::chrono::milliseconds(LOBBY_WAIT_MS));
+        if (lobbyID.empty()) {
+            return false;
+        }
+
+        const ServerResponse joined = timed(ServerMethods::JOIN_LOBBY, [&] {
+            return requestManager.joinLobby(token, lobbyID);
+        });
+        if (joined.status != StatusCode::SUCCESS) {
+            return false;
+        }
+    }
+
+    const ServerResponse ready = timed(ServerMethods::READY, [&] {
+        return requestManager.readyUp(token);
+    });
+
+    // same polling as the lobby screens, until the game has started
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(LOBBY_WAIT_MS);
+    while (ready.status == StatusCode::SUCCESS && running &&
+           std::chrono::steady_clock::now() < deadline) {
+        const ServerResponse status = timed(ServerMethods::GET_CLIENT_STATUS, [&] {
+            return requestManager.getClientStatus(username);
+        });
+        const auto statusIt = status.data.find("status");
+        if (status.status == StatusCode::SUCCESS && statusIt != status.data.end() &&
+            statusIt->second == std::to_string(static_cast<int>(ClientStatus::IN_GAME))) {
+            return true;
+        }
+
+        (void) timed(ServerMethods::GET_CURRENT_LOBBY, [&] {
+            return requestManager.getCurrentLobbyState(token);
+        });
+        pause(running, POLL_INTERVAL_MS);
+    }
+
+    // the lobby never filled up (or the run is over), the host makes a new one
+    (void) timed(ServerMethods::LEAVE_LOBBY, [&] {
+        return requestManager.leaveLobby(token);
+    });
+    return false;
+}
+
+void
+Bot::playGame(const std::atomic_bool &running) {
+    using Clock = std::chrono::steady_clock;
+
+    ++gamesPlayed;
+
+    const auto keyInterval = std::chrono::milliseconds(60000 / std::max(1, config.apm));
+    const auto pollInterval = std::chrono::milliseconds(POLL_INTERVAL_MS);
+    const auto overviewInterval = std::chrono::milliseconds(OVERVIEW_UPDATE_INTERVAL);
+    const bool royale = table->getGameMode() == GameMode::ROYALE;
+
+    Clock::time_point nextKey = Clock::now();
+    Clock::time_point nextPoll = Clock::now();
+    Clock::time_point nextOverview = Clock::now();
+
+    while (running) {
+        Clock::time_point now = Clock::now();
+
+        if (now >= nextKey) {
+            KeyStrokePacket packet;
+            packet.action = nextAction();
+            packet.token = token;
+            packet.sequence = ++sequence;
+            (void) timed(ServerMethods::KEY_STROKE, [&] {
+                return requestManager.sendKeyStroke(token, packet);
+            });
+            // a slow server gets fewer inputs, no burst to catch up
+            nextKey = std::max(nextKey + keyInterval, Clock::now());
+        }
+
+        if (now >= nextPoll) {
+            const ServerResponse state = timed(ServerMethods::GET_GAME_STATE, [&] {
+                return requestManager.getGameState(token);
+            });
+            nextPoll = std::max(nextPoll + pollInterval, Clock::now());
+
+            if (state.status == StatusCode::SUCCESS) {
+                try {
+                    if (PlayerState::deserialize(state.data.at("gamestate")).isGameOver) {
+                        break;
+                    }
+                } catch (const std::exception &) {
+                }
+            } else if (state.status != StatusCode::ERROR_RECEIVING_RESPONSE) {
+                // answered with an error : the game is gone
+                break;
+            }
+        }
+
+        if (royale && now >= nextOverview) {
+            (void) timed(ServerMethods::GET_GAME_OVERVIEW, [&] {
+                return requestManager.getGameOverview(token);
+            });
+            nextOverview = std::max(nextOverview + overviewInterval, Clock::now());
+        }
+
+        std::this_thread::sleep_until(std::min({nextKey, nextPoll,
+                                                royale ? nextOverview : nextPoll}));
+    }
+
+    (void) timed(ServerMethods::LEAVE_GAME, [&] {
+        return requestManager.leaveGame(token);
+    });
+}
+
+Action
+Bot::nextAction() {
+    if (!config.script.empty()) {
+        return config.script[scriptPosition++ % config.script.size()];
+    }
+
+    // what a player presses, the power-ups only mean something in royale
+    static const std::vector<Action> PLAYING_ACTIONS = {
+        Action::MoveLeft, Action::MoveRight, Action::MoveDown, Action::RotateLeft,
+        Action::RotateRight, Action::InstantFall, Action::UseBag,
+        Action::UseMalus, Action::UseBonus,
+    };
+    const std::size_t choices = table->getGameMode() == GameMode::ROYALE
+                                    ? PLAYING_ACTIONS.size()
+                                    : PLAYING_ACTIONS.size() - 2;
+    return PLAYING_ACTIONS[std::uniform_int_distribution<std::size_t>(0, choices - 1)(random)];
+}
+
+// ==================================================== //
+//                      Entry point                     //
+// ==================================================== //
+
+// comma separated list, each item through [parse]. false if one is unknown
+template<typename T, typename Parse>
+static bool
+parseList(const std::string &list, std::vector<T> &items, Parse parse) {
+    items.clear();
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        T value;
+        if (!parse(item, value)) {
+            return false;
+        }
+        items.push_back(value);
+    }
+    return !items.empty();
+}
+
+// NAME ON THE COMMAND LINE -> GAME MODE
+static const std::map<std::string, GameMode> GAME_MODE_NAMES = {
+    {"classic", GameMode::CLASSIC}, {"royale", GameMode::ROYALE},
+    {"duel", GameMode::DUEL}, {"endless", GameMode::ENDLESS},
+};
+
+static bool
+parseGameMode(const std::string &name, GameMode &gameMode) {
+    const auto it = GAME_MODE_NAMES.find(name);
+    if (it == GAME_MODE_NAMES.end()) {
+        return false;
+    }
+    gameMode = it->second;
+    return true;
+}
+
+static bool
+parseAction(const std::string &name, Action &action) {
+    for (int i = static_cast<int>(Action::None); i <= static_cast<int>(Action::SeeNextOpponent); ++i) {
+        if (actionToString(static_cast<Action>(i)) == name) {
+            action = static_cast<Action>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+// seats of a lobby of this game mode
+static int
+seatsFor(const GameMode gameMode, const int lobbySize) {
+    switch (gameMode) {
+        case GameMode::ENDLESS:
+            return ENDLESS_LOBBY_SIZE;
+        case GameMode::DUEL:
+            return DUAL_LOBBY_SIZE;
+        default:
+            return lobbySize;
+    }
+}
+
+int
+main(int argc, char *argv[]) {
+    // TetrisRoyaleLoadGen [--clients N] [--duration SEC] [--apm N]
+    //                     [--lobby-size N] [--modes classic,royale,duel,endless]
+    //                     [--script MoveLeft,RotateRight,InstantFall,...]
+    //                     [--seed N] [--host IP] [--port N]
+    const std::string usage =
+        std::string("Usage: ") + argv[0] +
+        " [--clients N] [--duration SEC] [--apm N] [--lobby-size N]"
+        " [--modes classic,royale,duel,endless] [--script Action,Action,...]"
+        " [--seed N] [--host IP] [--port N]";
+
+    LoadGenConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << usage << std::endl;
+            return EXIT_FAILURE;
+        }
+        const std::string value = argv[++i];
+
+        bool valid = true;
+        try {
+            if (arg == "--clients") {
+                config.clients = std::stoi(value);
+                valid = config.clients > 0;
+            } else if (arg == "--duration") {
+                config.durationSec = std::stoi(value);
+                valid = config.durationSec > 0;
+            } else if (arg == "--apm") {
+                config.apm = std::stoi(value);
+                valid = config.apm > 0;
+            } else if (arg == "--lobby-size") {
+                config.lobbySize = std::stoi(value);
+                valid = config.lobbySize >= MIN_LOBBY_SIZE && config.lobbySize <= MAX_LOBBY_SIZE;
+            } else if (arg == "--modes") {
+                valid = parseList(value, config.gameModes, parseGameMode);
+            } else if (arg == "--script") {
+                valid = parseList(value, config.script, parseAction);
+            } else if (arg == "--seed") {
+                config.seed = static_cast<unsigned>(std::stoul(value));
+            } else if (arg == "--host") {
+                config.serverIP = value;
+            } else if (arg == "--port") {
+                config.lobbyServerPort = std::stoi(value);
+                valid = config.lobbyServerPort > 0 && config.lobbyServerPort <= MAX_PORT;
+            } else {
+                std::cerr << usage << std::endl;
+                return EXIT_FAILURE;
+            }
+        } catch (const std::exception &) {
+            valid = false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value for " << arg << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the bots are seated mode after mode, a table that doesn't fit in the
+    // bots left is skipped for a smaller one (endless has a single seat)
+    std::vector<std::shared_ptr<BotTable>> tables;
+    std::map<GameMode, int> tablesPerMode;
+    int seated = 0;
+    std::size_t modeIndex = 0;
+    while (seated < config.clients) {
+        bool placed = false;
+        for (std::size_t tries = 0; tries < config.gameModes.size() && !placed; ++tries) {
+            const GameMode gameMode = config.gameModes[modeIndex++ % config.gameModes.size()];
+            const int seats = seatsFor(gameMode, config.lobbySize);
+            if (seats <= config.clients - seated) {
+                tables.push_back(std::make_shared<BotTable>(gameMode, seats));
+                ++tablesPerMode[gameMode];
+                seated += seats;
+                placed = true;
+            }
+        }
+        if (!placed) {
+            break;
+        }
+    }
+
+    if (tables.empty()) {
+        std::cerr << "Not enough clients for a single lobby" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    LatencyRecorder recorder;
+    std::vector<std::unique_ptr<Bot>> bots;
+    for (const auto &table: tables) {
+        for (int seat = 0; seat < table->getSeats(); ++seat) {
+            bots.push_back(std::make_unique<Bot>(static_cast<int>(bots.size()), config,
+                                                 table, seat == 0, recorder));
+        }
+    }
+
+    std::cout << bots.size() << " bots in " << tables.size() << " lobbies (";
+    for (const auto &[name, gameMode]: GAME_MODE_NAMES) {
+        if (tablesPerMode.contains(gameMode)) {
+            std::cout << ' ' << tablesPerMode[gameMode] << ' ' << name;
+        }
+    }
+    std::cout << " ), " << config.apm << " APM for " << config.durationSec << "s against "
+              << config.serverIP << ':' << config.lobbyServerPort << std::endl;
+    if (seated < config.clients) {
+        std::cout << config.clients - seated << " clients left without a lobby" << std::endl;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic_bool running{true};
+
+    std::vector<std::thread> threads;
+    threads.reserve(bots.size());
+    for (const auto &bot: bots) {
+        threads.emplace_back([&bot, &running] { bot->run(running); });
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(config.durationSec));
+    running = false;
+    for (const auto &table: tables) {
+        table->close();
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    int gamesPlayed = 0;
+    for (const auto &bot: bots) {
+        gamesPlayed += bot->getGamesPlayed();
+    }
+    std::cout << "\n" << gamesPlayed << " games played by the bots in "
+              << static_cast<double>(elapsed.count()) / 1000.0 << "s\n" << std::endl;
+    recorder.report(std::cout, elapsed);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,86 @@
+#include "AccountCache.hpp"
+
+AccountCache::AccountCache(const std::size_t capacity)
+    : capacity(capacity > 0 ? capacity : 1) {
+}
+
+std::optional<std::string>
+AccountCache::findUserName(const std::string &accountID) {
+    std::lock_guard lock(cacheMutex);
+
+    const auto it = byAccountID.find(accountID);
+    if (it == byAccountID.end()) {
+        return std::nullopt;
+    }
+
+    // a hit makes it the most recently used one
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+std::optional<std::string>
+AccountCache::findAccountID(const std::string &userName) {
+    std::lock_guard lock(cacheMutex);
+
+    const auto it = byUserName.find(userName);
+    if (it == byUserName.end()) {
+        return std::nullopt;
+    }
+
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->first;
+}
+
+void
+AccountCache::put(const std::string &accountID, const std::string &userName) {
+    // names can be given up and taken by someone else, so an old pair that
+    // shares either side with the new one is not true anymore
+
+    std::lock_guard lock(cacheMutex);
+
+    if (const auto it = byAccountID.find(accountID); it != byAccountID.end()) {
+        erase(it->second);
+    }
+    if (const auto it = byUserName.find(userName); it != byUserName.end()) {
+        erase(it->second);
+    }
+
+    entries.emplace_front(accountID, userName);
+    byAccountID[accountID] = entries.begin();
+    byUserName[userName] = entries.begin();
+
+    while (entries.size() > capacity) {
+        erase(std::prev(entries.end()));
+    }
+}
+
+void
+AccountCache::invalidate(const std::string &accountID) {
+    std::lock_guard lock(cacheMutex);
+
+    if (const auto it = byAccountID.find(accountID); it != byAccountID.end()) {
+        erase(it->second);
+    }
+}
+
+void
+AccountCache::clear() {
+    std::lock_guard lock(cacheMutex);
+    entries.clear();
+    byAccountID.clear();
+    byUserName.clear();
+}
+
+std::size_t
+AccountCache::size() const {
+    std::lock_guard lock(cacheMutex);
+    return entries.size();
+}
+
+void
+AccountCache::erase(const EntryList::iterator it) {
+    // the lock must be held by the caller
+    byAccountID.erase(it->first);
+    byUserName.erase(it->second);
+    entries.erase(it);
+}
@@ -0,0 +1,239 @@
+#include "ClientChannel.hpp"
+
+ClientChannel::ClientChannel(const std::string &serverIP, const int port)
+    : serverIP(serverIP), port(port) {
+    // the socket is only created by open()
+}
+
+ClientChannel::~ClientChannel() {
+    close();
+}
+
+StatusCode
+ClientChannel::open() {
+    // this method is used to create the socket and bind it to the endpoint :
+    // a connected udp socket only receives what this endpoint sends
+
+    if (isOpen()) {
+        return StatusCode::SUCCESS;
+    }
+
+    if (port <= 0 || port > MAX_PORT) {
+        return StatusCode::ERROR_INVALID_PORT;
+    }
+
+    channelSocket = socket(AF_INET, SOCK_DGRAM, 0);
+    if (channelSocket < 0) {
+        channelSocket = NO_FILE_DESCRIPTOR;
+        return StatusCode::ERROR_CREATING_SOCKET;
+    }
+
+    sockaddr_in serverAddress = {};
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, serverIP.c_str(), &serverAddress.sin_addr) != 1 ||
+        connect(channelSocket, reinterpret_cast<struct sockaddr *>(&serverAddress),
+                sizeof(serverAddress)) < 0) {
+        ::close(channelSocket);
+        channelSocket = NO_FILE_DESCRIPTOR;
+        return StatusCode::ERROR_NOT_CONNECTED;
+    }
+
+    receiving = true;
+    receiveThread = std::thread(&ClientChannel::receiveLoop, this);
+
+    return StatusCode::SUCCESS;
+}
+
+void
+ClientChannel::close() {
+    // this method is used to stop the receive thread and close the socket,
+    // the requests still waiting get an error
+
+    receiving = false;
+    if (receiveThread.joinable()) {
+        receiveThread.join();
+    }
+
+    if (channelSocket != NO_FILE_DESCRIPTOR) {
+        ::close(channelSocket);
+        channelSocket = NO_FILE_DESCRIPTOR;
+    }
+
+    failPendingRequests(StatusCode::ERROR_NOT_CONNECTED);
+}
+
+bool
+ClientChannel::isOpen() const {
+    return channelSocket != NO_FILE_DESCRIPTOR;
+}
+
+int
+ClientChannel::getPort() const {
+    return port;
+}
+
+std::future<ServerResponse>
+ClientChannel::send(ServerRequest &request, const int retries) {
+    // this method gives the request its id, registers it as pending and
+    // sends it. the future is set by the receive thread
+
+    if (!isOpen()) {
+        std::promise<ServerResponse> promise;
+        promise.set_value(ServerResponse::ErrorResponse(
+            INVALID_ID, StatusCode::ERROR_NOT_CONNECTED));
+        return promise.get_future();
+    }
+
+    const int attemptTimeoutMs = CLIENT_TIMEOUT_SEC * 1000 / (retries + 1);
+
+    std::future<ServerResponse> future;
+    std::string payload; {
+        std::lock_guard lock(pendingMutex);
+
+        request.id = nextRequestID();
+        payload = request.serialize();
+
+        PendingRequest pending;
+        pending.payload = payload;
+        pending.attemptTimeoutMs = attemptTimeoutMs;
+        pending.retriesLeft = retries;
+        pending.deadline = Clock::now() + std::chrono::milliseconds(attemptTimeoutMs);
+        future = pending.promise.get_future();
+
+        pendingRequests.emplace(request.id, std::move(pending));
+    }
+
+    if (transmit(payload) != StatusCode::SUCCESS) {
+        completeRequest(request.id, ServerResponse::ErrorResponse(
+                            request.id, StatusCode::ERROR_SENDING_REQUEST));
+    }
+
+    return future;
+}
+
+StatusCode
+ClientChannel::transmit(const std::string &payload) {
+    // this method is used to put a serialized request on the wire (in several
+    // datagrams if it is too big for one)
+
+    return fragmentWriter.send(channelSocket, payload);
+}
+
+void
+ClientChannel::receiveLoop() {
+    // this is the body of the receive thread : it reads every answer, gives
+    // it to the request with the same id, and takes care of the timeouts.
+    // an answer nobody waits for anymore (it came after its timeout) is
+    // dropped instead of being taken for the answer to the next request
+
+    char buffer[MAX_BUFFER_SIZE];
+
+    while (receiving) {
+        pollfd descriptor = {channelSocket, POLLIN, 0};
+        if (poll(&descriptor, 1, RECEIVE_POLL_MS) > 0 && (descriptor.revents & POLLIN)) {
+            const ssize_t recvLen = recv(channelSocket, buffer, MAX_BUFFER_SIZE, MSG_DONTWAIT);
+
+            // a fragment of a bigger answer is kept until the answer is whole
+            // (the socket is connected, there is only one sender)
+            const std::optional<std::string> payload = recvLen > 0
+                ? fragmentReader.feed("", buffer, static_cast<std::size_t>(recvLen))
+                : std::nullopt;
+
+            if (payload) {
+                try {
+                    ServerResponse response = ServerResponse::deserialize(*payload);
+                    completeRequest(response.id, std::move(response));
+                } catch (const std::runtime_error &) {
+                    // not something we can match to a request, ignore it
+                }
+            }
+        }
+
+        fragmentReader.expire();
+        expireRequests();
+    }
+}
+
+void
+ClientChannel::expireRequests() {
+    // this method sends again the requests whose try timed out, and gives up
+    // on the ones that have no try left
+
+    std::vector<std::string> resend;
+    std::vector<std::pair<int, std::promise<ServerResponse>>> expired;
+
+    {
+        std::lock_guard lock(pendingMutex);
+        const Clock::time_point now = Clock::now();
+
+        for (auto it = pendingRequests.begin(); it != pendingRequests.end();) {
+            PendingRequest &pending = it->second;
+
+            if (now < pending.deadline) {
+                ++it;
+            } else if (pending.retriesLeft > 0) {
+                --pending.retriesLeft;
+                pending.deadline = now + std::chrono::milliseconds(pending.attemptTimeoutMs);
+                resend.push_back(pending.payload);
+                ++it;
+            } else {
+                expired.emplace_back(it->first, std::move(pending.promise));
+                it = pendingRequests.erase(it);
+            }
+        }
+    }
+
+    // same id, so whichever answer comes first is the one we keep
+    for (const std::string &payload: resend) {
+        (void) transmit(payload);
+    }
+
+    for (auto &[id, promise]: expired) {
+        promise.set_value(ServerResponse::ErrorResponse(
+            id, StatusCode::ERROR_RECEIVING_RESPONSE));
+    }
+}
+
+void
+ClientChannel::completeRequest(const int id, ServerResponse response) {
+    // this method gives the answer to the request waiting for it, if any
+
+    std::promise<ServerResponse> promise; {
+        std::lock_guard lock(pendingMutex);
+
+        const auto it = pendingRequests.find(id);
+        if (it == pendingRequests.end()) {
+            return; // late or duplicated answer
+        }
+
+        promise = std::move(it->second.promise);
+        pendingRequests.erase(it);
+    }
+
+    promise.set_value(std::move(response));
+}
+
+void
+ClientChannel::failPendingRequests(const StatusCode status) {
+    // nobody will answer the requests still waiting
+
+    std::lock_guard lock(pendingMutex);
+    for (auto &[id, pending]: pendingRequests) {
+        pending.promise.set_value(ServerResponse::ErrorResponse(id, status));
+    }
+    pendingRequests.clear();
+}
+
+int
+ClientChannel::nextRequestID() {
+    // this method is used to generate a request ID (with pendingMutex held)
+    // ids go up and wrap at MAX_REQUEST_ID, skipping the ones still waiting
+    // for their answer so two requests in flight never share one
+
+    do {
+        lastRequestID = (lastRequestID + 1) % MAX_REQUEST_ID;
+    } while (pendingRequests.contains(lastRequestID));
+
+    return lastRequestID;
+}
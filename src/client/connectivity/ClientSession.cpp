@@ -28,8 +28,20 @@ ClientSession::ClientSession(Config &config, bool debug)
 
 ClientSession::~ClientSession() {
     // this is the destructor of the ClientSession class
-    // I really doubt that we need to do anything here
-    // but I will leave it here just in case
+    // the only thing to clean up is the notification thread (if it was ever
+    // started), the pending long-poll is aborted by the stop flag
+
+    {
+        std::lock_guard lock(subscribersMutex_);
+        stopNotifications_ = true;
+    }
+    subscribersCV_.notify_all();
+
+    if (notificationThread_.joinable()) {
+        notificationThread_.join();
+    }
+
+    stopHeartbeats();
 }
 
 std::string
@@ -65,6 +77,7 @@ ClientSession::getAccountID() {
 
 std::string
 ClientSession::getToken() {
+    std::lock_guard lock(tokenMutex_);
     return token_;
 }
 
@@ -95,6 +108,7 @@ ClientSession::setAccountID(const std::string &accountID) {
 
 void
 ClientSession::setToken(const std::string &token) {
+    std::lock_guard lock(tokenMutex_);
     token_ = token;
 }
 
@@ -103,17 +117,6 @@ ClientSession::setBestScore(const int score) {
     bestScore_ = score;
 }
 
-void
-ClientSession::updateLocalMessages(const std::string &otherAccountID, const ChatMessage &message) {
-    // Add the new message to our local cache
-    // We'll use a map to store conversations by the other user's account ID
-    if (!conversations_.contains(otherAccountID)) {
-        conversations_[otherAccountID] = std::vector<ChatMessage>();
-    }
-
-    conversations_[otherAccountID].push_back(message);
-}
-
 void
 ClientSession::setFriendList(const std::vector<std::string> &friends) {
     friendList_ = friends;
@@ -177,9 +180,10 @@ ClientSession::getLeaderboard(const int limit) const {
             for (const auto &item: leaderboardArray) {
                 const auto &player = item.second;
 
-                // Extract player data
+                // Extract player data (the server ranks ties equally)
                 PlayerScore score;
-                score.rank = rank++;
+                score.rank = player.get<int>("rank", rank);
+                ++rank;
                 score.name = player.get<std::string>("userName", "Unknown");
                 score.score = player.get<int>("bestScore", 0);
 
@@ -197,24 +201,91 @@ ClientSession::getLeaderboard(const int limit) const {
     return leaderboard;
 }
 
+std::vector<PlayerScore>
+ClientSession::getLeaderboardAroundMe(const int around) {
+    // this method returns the players ranked right above and below us
+    // (us included), empty if we're not logged in or not ranked
+
+    std::vector<PlayerScore> leaderboard;
+    if (getAccountID().empty()) {
+        return leaderboard;
+    }
+
+    const DBResponse response = dbRequestManager.getRank(getAccountID(), around);
+    if (response.status != 200) {
+        return leaderboard;
+    }
+
+    try {
+        for (const auto &item: response.json.get_child("around")) {
+            const auto &player = item.second;
+
+            PlayerScore score;
+            score.rank = player.get<int>("rank", 0);
+            score.name = player.get<std::string>("userName", "Unknown");
+            score.score = player.get<int>("bestScore", 0);
+            leaderboard.push_back(score);
+        }
+    } catch (std::exception &e) {
+        // error parsing leaderboard data
+    }
+
+    return leaderboard;
+}
+
 std::vector<ChatMessage>
 ClientSession::getPlayerMessages(const std::string &otherAccountID) {
-    // Check if we have a valid accountID
+    // this method pulls whatever is new in the conversation and returns the
+    // whole (cached) conversation, oldest message first
+
+    (void) syncMessages(otherAccountID);
+    return getConversation(otherAccountID);
+}
+
+std::size_t
+ClientSession::syncMessages(const std::string &otherAccountID) {
+    // this method asks the db server for the messages we don't have yet
+    // (everything after the cursor of the conversation) and appends them to
+    // the local cache. it returns the number of new messages, so an idle chat
+    // costs one tiny request and no work at all on the caller's side
+
     if (getAccountID().empty()) {
-        return std::vector<ChatMessage>();
+        return 0;
     }
 
-    std::vector<ChatMessage> messages;
-    const DBResponse response = dbRequestManager.getMessages(getAccountID(), otherAccountID);
+    std::string cursor;
+    {
+        std::lock_guard lock(conversationsMutex_);
+        if (const auto it = conversationCursors_.find(otherAccountID);
+            it != conversationCursors_.end()) {
+            cursor = it->second;
+        }
+    }
 
-    // Check if the response was successful
-    if (response.status == 200) {
-        try {
-            // Access the messages array from the response
-            const auto &messagesArray = response.json.get_child("messages");
+    const std::string startCursor = cursor;
+    std::vector<ChatMessage> fetched;
+    bool hasMore = true;
+
+    while (hasMore) {
+        const DBResponse response = dbRequestManager.getMessages(
+            getAccountID(), otherAccountID, cursor, MESSAGES_PAGE_SIZE);
+
+        if (response.status == 404) {
+            // our cursor message does not exist anymore (deleted), so the
+            // cache can't be trusted : drop it, next sync reloads everything
+            std::lock_guard lock(conversationsMutex_);
+            conversations_.erase(otherAccountID);
+            conversationCursors_.erase(otherAccountID);
+            return 0;
+        }
+
+        if (response.status != 200) {
+            // error fetching messages, we'll try again next time
+            break;
+        }
 
-            // Iterate through each message
-            for (const auto &item: messagesArray) {
+        try {
+            for (const auto &item: response.json.get_child("messages")) {
                 const auto &message = item.second;
 
                 ChatMessage chatMsg;
@@ -224,33 +295,61 @@ ClientSession::getPlayerMessages(const std::string &otherAccountID) {
                 if (senderId == getAccountID()) {
                     chatMsg.from = "Me"; // Message sent by this user
                 } else {
-                    // Try to get username from message or use a default
                     // turn id into username
                     chatMsg.from = getFriendUsername(senderId);
                 }
 
-                // Extract message content
                 chatMsg.text = message.get<std::string>("content", "");
-
-                // Cache the message locally
-                updateLocalMessages(otherAccountID, chatMsg);
-
-                // Add to the messages vector
-                messages.push_back(chatMsg);
+                fetched.push_back(chatMsg);
             }
-            // std::cout << "Fetched " << messages.size() << " messages with " << otherAccountID << std::endl;
+
+            cursor = response.json.get<std::string>("cursor", cursor);
+            hasMore = response.json.get<bool>("hasMore", false);
         } catch (std::exception &e) {
             // error parsing messages data
+            break;
         }
-    } else {
-        // error fetching messages
     }
 
-    return messages;
+    if (fetched.empty()) {
+        return 0;
+    }
+
+    std::lock_guard lock(conversationsMutex_);
+
+    // someone else synced this conversation while we were waiting on the
+    // network, their result already contains ours
+    const auto it = conversationCursors_.find(otherAccountID);
+    const std::string currentCursor = (it != conversationCursors_.end()) ? it->second : "";
+    if (currentCursor != startCursor) {
+        return 0;
+    }
+
+    std::vector<ChatMessage> &conversation = conversations_[otherAccountID];
+    conversation.insert(conversation.end(), fetched.begin(), fetched.end());
+    conversationCursors_[otherAccountID] = cursor;
+
+    return fetched.size();
+}
+
+std::vector<ChatMessage>
+ClientSession::getConversation(const std::string &otherAccountID) {
+    // this method returns the cached conversation without touching the
+    // network, oldest message first
+
+    std::lock_guard lock(conversationsMutex_);
+    if (const auto it = conversations_.find(otherAccountID); it != conversations_.end()) {
+        return it->second;
+    }
+
+    return {};
 }
 
 std::string
 ClientSession::getAccountIDFromUsername(const std::string &username) const {
+    if (const auto cached = accountCache_.findAccountID(username)) {
+        return *cached;
+    }
 
     // Send request to get account ID by username
     const DBResponse response = dbRequestManager.getAccountIDByUsername(username);
@@ -258,6 +357,9 @@ ClientSession::getAccountIDFromUsername(const std::string &username) const {
     if (response.status == 200) {
         try {
             const std::string accountID = response.json.get<std::string>("accountID", "");
+            if (!accountID.empty()) {
+                accountCache_.put(accountID, username);
+            }
             return accountID;
         } catch (const std::exception &e) {
             // error parsing account ID
@@ -269,18 +371,67 @@ ClientSession::getAccountIDFromUsername(const std::string &username) const {
     return ""; // Return empty string on failure
 }
 
+std::unordered_map<std::string, std::string>
+ClientSession::resolveUsernames(const std::vector<std::string> &accountIDs) const {
+    // this method answers from the cache when it can and asks the db server
+    // for everything else in one go. ids that don't exist are left out
+
+    std::unordered_map<std::string, std::string> names;
+    std::vector<std::string> missing;
+
+    for (const auto &accountID: accountIDs) {
+        if (names.contains(accountID)) {
+            continue;
+        }
+        if (const auto cached = accountCache_.findUserName(accountID)) {
+            names[accountID] = *cached;
+        } else if (std::ranges::find(missing, accountID) == missing.end()) {
+            missing.push_back(accountID);
+        }
+    }
+
+    if (missing.empty()) {
+        return names;
+    }
+
+    for (const DBResponse &response: dbRequestManager.resolveAccounts(missing)) {
+        if (response.status != 200) {
+            continue;
+        }
+
+        try {
+            for (const auto &item: response.json.get_child("accounts")) {
+                const std::string accountID = item.second.get<std::string>("accountID", "");
+                const std::string userName = item.second.get<std::string>("userName", "");
+                if (accountID.empty() || userName.empty()) {
+                    continue;
+                }
+
+                accountCache_.put(accountID, userName);
+                names[accountID] = userName;
+            }
+        } catch (const std::exception &e) {
+            // error parsing accounts
+        }
+    }
+
+    return names;
+}
+
 std::string
 ClientSession::getFriendUsername(const std::string &friendID) {
-    if (friendIDToUsername.contains(friendID)) {
-        return friendIDToUsername[friendID];
+    std::lock_guard lock(friendNamesMutex_);
+    if (const auto it = friendIDToUsername.find(friendID); it != friendIDToUsername.end()) {
+        return it->second;
     }
     return "Unknown";
 }
 
 std::string
 ClientSession::getRequestUsername(const std::string &requestID) {
-    if (pendingRequestIDToUsername.contains(requestID)) {
-        return pendingRequestIDToUsername[requestID];
+    std::lock_guard lock(friendNamesMutex_);
+    if (const auto it = pendingRequestIDToUsername.find(requestID); it != pendingRequestIDToUsername.end()) {
+        return it->second;
     }
     return "Unknown";
 }
@@ -303,10 +454,6 @@ ClientSession::fetchPlayerData() {
             std::ostringstream oss;
             write_json(oss, response.json, false);
 
-            // Clear existing maps
-            friendIDToUsername.clear();
-            pendingRequestIDToUsername.clear();
-
             // Parse friendList array
             std::vector<std::string> friends;
             try {
@@ -315,15 +462,6 @@ ClientSession::fetchPlayerData() {
                     for (const auto &child: friendsArray) {
                         std::string friendID = child.second.data();
                         friends.push_back(friendID);
-
-                        // Fetch and store the username for this friend ID
-                        DBResponse nameResponse = dbRequestManager.getUsernameByAccountID(friendID);
-                        if (nameResponse.status == 200) {
-                            std::string username = nameResponse.json.get<std::string>("username", "Unknown");
-                            friendIDToUsername[friendID] = username;
-                        } else {
-                            friendIDToUsername[friendID] = "Unknown";
-                        }
                     }
                 }
             } catch (const std::exception &e) {
@@ -339,15 +477,6 @@ ClientSession::fetchPlayerData() {
                     for (const auto &child: pendingArray) {
                         std::string requestID = child.second.data();
                         pending.push_back(requestID);
-
-                        // Fetch and store the username for this friend request ID
-                        DBResponse nameResponse = dbRequestManager.getUsernameByAccountID(requestID);
-                        if (nameResponse.status == 200) {
-                            std::string username = nameResponse.json.get<std::string>("username", "Unknown");
-                            pendingRequestIDToUsername[requestID] = username;
-                        } else {
-                            pendingRequestIDToUsername[requestID] = "Unknown";
-                        }
                     }
                 }
             } catch (const std::exception &e) {
@@ -355,6 +484,33 @@ ClientSession::fetchPlayerData() {
             }
             setPendingFriendRequests(pending);
 
+            // one lookup for every name we don't know yet
+            std::vector<std::string> lookups = friends;
+            lookups.insert(lookups.end(), pending.begin(), pending.end());
+            const auto names = resolveUsernames(lookups);
+
+            auto nameOf = [&names](const std::string &accountID) {
+                const auto it = names.find(accountID);
+                return it != names.end() ? it->second : std::string("Unknown");
+            };
+
+            // built aside, then swapped in at once : the notification thread
+            // never sees the maps half filled
+            std::unordered_map<std::string, std::string> friendNames;
+            std::unordered_map<std::string, std::string> requestNames;
+            for (const auto &friendID: friends) {
+                friendNames[friendID] = nameOf(friendID);
+            }
+            for (const auto &requestID: pending) {
+                requestNames[requestID] = nameOf(requestID);
+            }
+
+            {
+                std::lock_guard lock(friendNamesMutex_);
+                friendIDToUsername = std::move(friendNames);
+                pendingRequestIDToUsername = std::move(requestNames);
+            }
+
             return StatusCode::SUCCESS;
         } catch (const std::exception &e) {
             return StatusCode::ERROR;
@@ -376,6 +532,10 @@ ClientSession::updatePlayer(const std::string &newName,
 
     if (response.status == 200) {
         setUsername(response.json.get<std::string>("userName", username_));
+
+        // our old name may be cached, and someone else can take it now
+        accountCache_.invalidate(getAccountID());
+        accountCache_.put(getAccountID(), getUsername());
         return StatusCode::SUCCESS;
     }
     return StatusCode::ERROR;
@@ -414,19 +574,125 @@ ClientSession::sendMessage(const std::string &receiverID, const std::string &mes
     if (response.status == 200) {
         // std::cout << "Message sent to " << receiverID << std::endl;
 
-        // Add the message to our local cache for this conversation
-        ChatMessage newMessage;
-        newMessage.from = "Me";
-        newMessage.text = messageContent;
-
-        // Store this message in our local cache
-        updateLocalMessages(receiverID, newMessage);
+        // pull the message back from the server instead of appending it
+        // ourselves, so the cursor of the conversation stays consistent
+        (void) syncMessages(receiverID);
 
         return StatusCode::SUCCESS;
     }
     return StatusCode::ERROR_SENDING_MESSAGE;
 }
 
+int
+ClientSession::subscribeNotifications(NotificationCallback callback) {
+    // this method registers a callback for the db server notifications and
+    // returns an id to unsubscribe with. the notification thread is started
+    // with the first subscription and lives as long as the session
+
+    int subscriptionID;
+    {
+        std::lock_guard lock(subscribersMutex_);
+        subscriptionID = nextSubscriptionID_++;
+        notificationSubscribers_[subscriptionID] = std::move(callback);
+
+        if (!notificationThread_.joinable()) {
+            notificationThread_ = std::thread(&ClientSession::notificationLoop, this);
+        }
+    }
+    subscribersCV_.notify_all();
+
+    return subscriptionID;
+}
+
+void
+ClientSession::unsubscribeNotifications(const int subscriptionID) {
+    // callbacks are called with the lock held, so once this returns the
+    // callback is guaranteed not to be running anymore
+    std::lock_guard lock(subscribersMutex_);
+    notificationSubscribers_.erase(subscriptionID);
+}
+
+void
+ClientSession::notificationLoop() {
+    // this is the body of the notification thread : it keeps one long-poll
+    // open on the db server while someone is subscribed, and dispatches
+    // whatever comes back. new messages are synced into the conversation
+    // cache before the subscribers are told about them
+
+    std::string cursor;
+    std::string cursorAccountID;
+
+    while (!stopNotifications_) {
+        {
+            // nobody listening (or not logged in), no need to poll
+            std::unique_lock lock(subscribersMutex_);
+            subscribersCV_.wait_for(lock, std::chrono::milliseconds(NOTIFICATION_RETRY_DELAY_MS), [this] {
+                return stopNotifications_ || !notificationSubscribers_.empty();
+            });
+
+            if (stopNotifications_) {
+                break;
+            }
+            if (notificationSubscribers_.empty() || getAccountID().empty()) {
+                continue;
+            }
+        }
+
+        // the cursor belongs to an account, start over after a re-login
+        const std::string accountID = getAccountID();
+        if (accountID != cursorAccountID) {
+            cursor.clear();
+            cursorAccountID = accountID;
+        }
+
+        const DBResponse response = dbRequestManager.pollNotifications(
+            accountID, cursor, NOTIFICATION_POLL_TIMEOUT_SEC, stopNotifications_);
+
+        if (stopNotifications_) {
+            break;
+        }
+
+        if (response.status != 200) {
+            // server unreachable or unhappy, don't hammer it
+            std::this_thread::sleep_for(std::chrono::milliseconds(NOTIFICATION_RETRY_DELAY_MS));
+            continue;
+        }
+
+        std::vector<Notification> notifications;
+        try {
+            for (const auto &item: response.json.get_child("notifications")) {
+                notifications.push_back({
+                    item.second.get<std::string>("type", ""),
+                    item.second.get<std::string>("fromID", "")
+                });
+            }
+            cursor = response.json.get<std::string>("cursor", cursor);
+        } catch (const std::exception &e) {
+            continue;
+        }
+
+        for (const Notification &notification: notifications) {
+            if (notification.type == "message") {
+                (void) syncMessages(notification.fromID);
+            } else if (notification.type == "rename") {
+                // the next lookup will fetch the new name
+                accountCache_.invalidate(notification.fromID);
+            }
+
+            publishNotification(notification);
+        }
+    }
+}
+
+void
+ClientSession::publishNotification(const Notification &notification) {
+    // the callbacks are called with the lock held (see unsubscribeNotifications)
+    std::lock_guard lock(subscribersMutex_);
+    for (const auto &[id, callback]: notificationSubscribers_) {
+        callback(notification);
+    }
+}
+
 StatusCode
 ClientSession::sendFriendRequest(const std::string &receiverIdentifier) {
     if (getAccountID().empty()) {
@@ -531,6 +797,30 @@ ClientSession::getClientStatus(const std::string &username) {
     return static_cast<ClientStatus>(std::stoi(response.data.at("status")));
 }
 
+std::unordered_map<std::string, ClientStatus>
+ClientSession::getClientStatuses(const std::vector<std::string> &usernames) {
+    std::unordered_map<std::string, ClientStatus> statuses;
+    for (const std::string &username: usernames) {
+        statuses[username] = ClientStatus::OFFLINE;
+    }
+
+    // a batch that failed leaves its players offline, like getClientStatus
+    for (const ServerResponse &response:
+         this->gameRequestManager.getClientStatuses(usernames)) {
+        if (response.status != StatusCode::SUCCESS) {
+            continue;
+        }
+
+        for (const auto &[username, status]: response.data) {
+            if (statuses.contains(username)) {
+                statuses[username] = static_cast<ClientStatus>(std::stoi(status));
+            }
+        }
+    }
+
+    return statuses;
+}
+
 StatusCode
 ClientSession::startSession() {
     ServerResponse response =
@@ -540,6 +830,7 @@ ClientSession::startSession() {
     if (response.status == StatusCode::SUCCESS_REPLACED_SESSION ||
         response.status == StatusCode::SUCCESS) {
         this->setToken(response.data.at("token"));
+        startHeartbeats(response.data.at("token"));
         return StatusCode::SUCCESS;
     }
     return response.status;
@@ -553,22 +844,152 @@ ClientSession::endSession() {
     if (response.status == StatusCode::SUCCESS) {
         // we set the token of the client
         this->setToken("");
+        stopHeartbeats();
         return StatusCode::SUCCESS;
     }
     return response.status;
 }
 
+void
+ClientSession::startHeartbeats(const std::string &token) {
+    // one heartbeat thread per session, the one of an older session stops
+    stopHeartbeats();
+    heartbeatThread_ = std::thread(&ClientSession::heartbeatLoop, this, token);
+}
+
+void
+ClientSession::stopHeartbeats() {
+    {
+        std::lock_guard lock(heartbeatMutex_);
+        stopHeartbeats_ = true;
+    }
+    heartbeatCV_.notify_all();
+
+    if (heartbeatThread_.joinable()) {
+        heartbeatThread_.join();
+    }
+
+    std::lock_guard lock(heartbeatMutex_);
+    stopHeartbeats_ = false;
+}
+
+void
+ClientSession::heartbeatLoop(const std::string &token) {
+    // this is the body of the heartbeat thread : it sleeps until
+    // SESSION_HEARTBEAT_SEC after the last request with a token, and only
+    // sends a HEARTBEAT if nothing was sent in the meantime. the lobby server
+    // ends the session after SESSION_TIMEOUT_SEC without any of them
+
+    constexpr auto interval = std::chrono::seconds(SESSION_HEARTBEAT_SEC);
+
+    std::unique_lock lock(heartbeatMutex_);
+    while (!stopHeartbeats_) {
+        const auto quiet = gameRequestManager.timeSinceTokenSent();
+        if (quiet < interval) {
+            heartbeatCV_.wait_for(lock, interval - quiet, [this] { return stopHeartbeats_; });
+            continue;
+        }
+
+        // a logout doesn't wait for the answer : the future is dropped, the
+        // channel completes it whenever the answer (or the timeout) comes
+        std::future<ServerResponse> answer = gameRequestManager.heartbeatAsync(token);
+        while (answer.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (heartbeatCV_.wait_for(lock, std::chrono::milliseconds(HEARTBEAT_STOP_CHECK_MS),
+                                      [this] { return stopHeartbeats_; })) {
+                return;
+            }
+        }
+
+        if (answer.get().status == StatusCode::ERROR_SESSION_NOT_FOUND) {
+            break; // expired (or the server restarted), no point going on
+        }
+    }
+    if (stopHeartbeats_) {
+        return;
+    }
+    lock.unlock();
+
+    // the session is gone on the server side : unless a new one was started
+    // meanwhile, we are logged out and the screens have to go back to login
+    {
+        std::lock_guard tokenLock(tokenMutex_);
+        if (token_ != token) {
+            return;
+        }
+        token_.clear();
+    }
+    publishNotification({"session_expired", ""});
+}
+
 std::unordered_map<std::string, std::string>
-ClientSession::getPublicLobbiesList() {
-    ServerResponse response = this->gameRequestManager.getPublicLobbiesList();
+ClientSession::getPublicLobbiesList(const std::optional<GameMode> gameMode) {
+    const int filter = gameMode ? static_cast<int>(*gameMode) : -1;
+
+    int knownVersion; {
+        std::lock_guard lock(lobbyListMutex_);
+        knownVersion = lobbyListCache_[filter].version;
+    }
+
+    // the first page tells us if anything changed, and how many pages there are
+    ServerResponse first =
+            this->gameRequestManager.getPublicLobbiesList(knownVersion, gameMode, 0);
+
+    if (first.status == StatusCode::SUCCESS_NOT_MODIFIED) {
+        std::lock_guard lock(lobbyListMutex_);
+        return lobbyListCache_[filter].lobbies;
+    }
 
     // we have to check if the response was successful
-    if (response.status != StatusCode::SUCCESS) {
+    if (first.status != StatusCode::SUCCESS) {
+        return {};
+    }
+
+    LobbyListCache listing;
+    int pageCount = 1;
+    try {
+        listing.version = std::stoi(first.data.at("version"));
+        pageCount = std::stoi(first.data.at("pageCount"));
+    } catch (const std::exception &) {
         return {};
     }
 
+    // the other pages (if any) are asked for all at once
+    std::vector<ServerResponse> pages = {first};
+    std::vector<std::future<ServerResponse>> futures;
+    for (int page = 1; page < pageCount; ++page) {
+        futures.push_back(this->gameRequestManager.getPublicLobbiesListAsync(
+            NO_LOBBY_LIST_VERSION, gameMode, page));
+    }
+    for (auto &future: futures) {
+        pages.push_back(future.get());
+    }
+
+    int index = 0;
+    for (const ServerResponse &page: pages) {
+        // a page that is missing, or from a listing that changed in between,
+        // is not kept, so the next call asks for everything again
+        if (page.status != StatusCode::SUCCESS ||
+            page.data.at("version") != first.data.at("version")) {
+            listing.version = NO_LOBBY_LIST_VERSION;
+            if (page.status != StatusCode::SUCCESS) {
+                continue;
+            }
+        }
+
+        try {
+            for (const auto &lobby: nlohmann::json::parse(page.data.at("lobbies"))) {
+                listing.lobbies[std::to_string(index++)] = lobby.dump();
+            }
+        } catch (const std::exception &) {
+            listing.version = NO_LOBBY_LIST_VERSION;
+        }
+    }
+
+    std::lock_guard lock(lobbyListMutex_);
+    lobbyListCache_[filter] = listing;
+
     // we return the list of lobbies
-    return response.data;
+    return listing.lobbies;
 }
 
 StatusCode
@@ -661,11 +1082,17 @@ ClientSession::unreadyUp() {
     return StatusCode::SUCCESS;
 }
 
+int
+ClientSession::nextInputSequence() {
+    return ++lastInputSequence_;
+}
+
 StatusCode
-ClientSession::sendKeyStroke(const Action &keyStroke) {
+ClientSession::sendKeyStroke(const Action &keyStroke, const int sequence) {
     KeyStrokePacket keyStrokePacket;
     keyStrokePacket.token = getToken();
     keyStrokePacket.action = keyStroke;
+    keyStrokePacket.sequence = sequence;
     ServerResponse response = this->gameRequestManager.sendKeyStroke(
         keyStrokePacket.token, keyStrokePacket);
 
@@ -677,6 +1104,54 @@ ClientSession::sendKeyStroke(const Action &keyStroke) {
     return StatusCode::SUCCESS;
 }
 
+StatusCode
+ClientSession::sendKeyStrokes(const std::vector<std::pair<int, Action>> &keyStrokes) {
+    // they are all in flight together instead of one round trip each, the
+    // game server still gets them in order (one socket, sent in order)
+
+    std::vector<std::future<ServerResponse>> responses;
+    responses.reserve(keyStrokes.size());
+
+    for (const auto &[sequence, action]: keyStrokes) {
+        KeyStrokePacket keyStrokePacket;
+        keyStrokePacket.token = getToken();
+        keyStrokePacket.action = action;
+        keyStrokePacket.sequence = sequence;
+        responses.push_back(this->gameRequestManager.sendKeyStrokeAsync(
+            keyStrokePacket.token, keyStrokePacket));
+    }
+
+    StatusCode result = StatusCode::SUCCESS;
+    for (std::future<ServerResponse> &response: responses) {
+        if (const StatusCode status = response.get().status; status != StatusCode::SUCCESS) {
+            result = status;
+        }
+    }
+
+    return result;
+}
+
+StatusCode
+ClientSession::fetchGameState(std::string &rawState) {
+    // this method returns the state as the server sent it, the caller decides
+    // whether it is a player or a spectator one (one round trip instead of
+    // trying getPlayerState and then getSpectatorState)
+
+    ServerResponse response = this->gameRequestManager.getGameState(getToken());
+
+    if (response.status != StatusCode::SUCCESS) {
+        return response.status;
+    }
+
+    const auto it = response.data.find("gamestate");
+    if (it == response.data.end()) {
+        return StatusCode::ERROR;
+    }
+
+    rawState = it->second;
+    return StatusCode::SUCCESS;
+}
+
 PlayerState
 ClientSession::getPlayerState() {
     ServerResponse response = this->gameRequestManager.getGameState(getToken());
@@ -691,6 +1166,28 @@ ClientSession::getPlayerState() {
     return playerState;
 }
 
+StatusCode
+ClientSession::fetchGameOverview(GameOverview &overview) {
+    ServerResponse response = this->gameRequestManager.getGameOverview(getToken());
+
+    if (response.status != StatusCode::SUCCESS) {
+        return response.status;
+    }
+
+    const auto it = response.data.find("overview");
+    if (it == response.data.end()) {
+        return StatusCode::ERROR;
+    }
+
+    try {
+        overview = GameOverview::deserialize(it->second);
+    } catch (const std::runtime_error &) {
+        return StatusCode::ERROR;
+    }
+
+    return StatusCode::SUCCESS;
+}
+
 SpectatorState
 ClientSession::getSpectatorState() {
     ServerResponse response = this->gameRequestManager.getGameState(getToken());
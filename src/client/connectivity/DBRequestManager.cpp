@@ -8,7 +8,15 @@ DBRequestManager::DBRequestManager(const std::string &host, const int &port)
     : host_(host), port_(port) {
 }
 
-DBRequestManager::~DBRequestManager() = default;
+DBRequestManager::~DBRequestManager() {
+    // the server ends its session loop when we close our side
+    std::lock_guard lock(connectionsMutex_);
+    for (const auto &idle: idleConnections_) {
+        boost::system::error_code ignored;
+        idle.connection->shutdown(tcp::socket::shutdown_both, ignored);
+    }
+    idleConnections_.clear();
+}
 
 std::string
 DBRequestManager::getServerIP() {
@@ -37,9 +45,218 @@ DBRequestManager::getUsernameByAccountID(const std::string &accountID) const {
     return sendRequest(http::verb::get, "/get_username?accountID=" + accountID, "");
 }
 
+std::vector<DBResponse>
+DBRequestManager::resolveAccounts(const std::vector<std::string> &accountIDs,
+                                  const std::vector<std::string> &userNames) const {
+    std::vector<PendingRequest> requests;
+    boost::property_tree::ptree ids;
+    boost::property_tree::ptree names;
+    std::size_t batchSize = 0;
+
+    auto flush = [&] {
+        boost::property_tree::ptree pt;
+        pt.add_child("accountIDs", ids);
+        pt.add_child("userNames", names);
+        requests.push_back({http::verb::post, "/resolve_accounts", toJSON(pt)});
+
+        ids.clear();
+        names.clear();
+        batchSize = 0;
+    };
+
+    auto add = [&](boost::property_tree::ptree &array, const std::string &value) {
+        boost::property_tree::ptree item;
+        item.put("", value);
+        array.push_back(std::make_pair("", item));
+
+        if (++batchSize == RESOLVE_BATCH_SIZE) {
+            flush();
+        }
+    };
+
+    for (const auto &accountID: accountIDs) {
+        add(ids, accountID);
+    }
+    for (const auto &userName: userNames) {
+        add(names, userName);
+    }
+    if (batchSize > 0) {
+        flush();
+    }
+
+    return sendPipelined(requests);
+}
+
 DBResponse
 DBRequestManager::sendRequest(http::verb method, const std::string &target,
                               const std::string &body) const {
+    return sendPipelined({{method, target, body}}).front();
+}
+
+std::vector<DBResponse>
+DBRequestManager::sendPipelined(const std::vector<PendingRequest> &requests) const {
+    // this method sends every request on the same keep-alive connection and
+    // then reads the responses, which the server answers in order
+    // if a connection we reused was closed by the server in the meantime we
+    // only notice it here, so we try once more on a fresh one as long as
+    // nothing was answered yet. only when every request is a GET though : a
+    // POST may have reached the server before the connection broke, and
+    // sending it again could apply it twice (a message sent twice...)
+
+    std::vector<DBResponse> responses;
+    if (requests.empty()) {
+        return responses;
+    }
+
+    const bool idempotent = std::all_of(requests.begin(), requests.end(), [](const PendingRequest &request) {
+        return request.method == http::verb::get;
+    });
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = false;
+        responses.clear();
+
+        try {
+            std::unique_ptr<Connection> connection = acquireConnection(reused);
+
+            for (const auto &request: requests) {
+                http::write(*connection, makeRequest(request));
+            }
+
+            boost::beast::flat_buffer buffer;
+            bool keepAlive = true;
+
+            for (std::size_t i = 0; i < requests.size(); ++i) {
+                http::response<http::string_body> res;
+                http::read(*connection, buffer, res);
+                keepAlive = keepAlive && res.keep_alive();
+
+                DBResponse dbResp;
+                dbResp.status = res.result_int();
+                try {
+                    std::istringstream iss(res.body());
+                    read_json(iss, dbResp.json);
+                } catch (const boost::property_tree::json_parser_error &e) {
+                    // the connection is still fine, only this answer is lost
+                    dbResp.status = 500;
+                    dbResp.json.put("error", e.what());
+                }
+                responses.push_back(std::move(dbResp));
+            }
+
+            if (keepAlive) {
+                releaseConnection(std::move(connection));
+            } else {
+                boost::system::error_code ignored;
+                connection->shutdown(tcp::socket::shutdown_both, ignored);
+            }
+
+            return responses;
+        } catch (const std::exception &e) {
+            if (idempotent && reused && responses.empty() && attempt == 0) {
+                continue;
+            }
+
+            // whatever did not get an answer fails with the same error
+            while (responses.size() < requests.size()) {
+                DBResponse dbResp;
+                dbResp.status = 500;
+                dbResp.json.put("error", e.what());
+                responses.push_back(std::move(dbResp));
+            }
+            return responses;
+        }
+    }
+
+    return responses;
+}
+
+std::unique_ptr<DBRequestManager::Connection>
+DBRequestManager::acquireConnection(bool &reused) const {
+    tcp::resolver::results_type endpoints;
+
+    {
+        std::lock_guard lock(connectionsMutex_);
+
+        // the oldest ones first : those idle for too long are closed, the
+        // server would close them (or has already)
+        const auto expired = std::chrono::steady_clock::now() - std::chrono::seconds(MAX_IDLE_SEC);
+        const auto fresh = std::find_if(idleConnections_.begin(), idleConnections_.end(),
+                                        [expired](const IdleConnection &idle) {
+                                            return idle.since > expired;
+                                        });
+        for (auto it = idleConnections_.begin(); it != fresh; ++it) {
+            boost::system::error_code ignored;
+            it->connection->shutdown(tcp::socket::shutdown_both, ignored);
+        }
+        idleConnections_.erase(idleConnections_.begin(), fresh);
+
+        if (!idleConnections_.empty()) {
+            std::unique_ptr<Connection> connection = std::move(idleConnections_.back().connection);
+            idleConnections_.pop_back();
+            reused = true;
+            return connection;
+        }
+
+        if (!endpoints_) {
+            tcp::resolver resolver(ioc_);
+            endpoints_ = resolver.resolve(host_, std::to_string(port_));
+        }
+        endpoints = *endpoints_;
+    }
+
+    // connecting is done outside the lock, it is the slow part
+    reused = false;
+    auto connection = std::make_unique<Connection>(ioc_);
+    try {
+        asio::connect(*connection, endpoints.begin(), endpoints.end());
+    } catch (const std::exception &) {
+        // the address may have changed, resolve again next time
+        std::lock_guard lock(connectionsMutex_);
+        endpoints_.reset();
+        throw;
+    }
+    connection->set_option(tcp::no_delay(true));
+
+    return connection;
+}
+
+void
+DBRequestManager::releaseConnection(std::unique_ptr<Connection> connection) const {
+    std::lock_guard lock(connectionsMutex_);
+
+    if (idleConnections_.size() < MAX_IDLE_CONNECTIONS) {
+        idleConnections_.push_back({std::move(connection), std::chrono::steady_clock::now()});
+        return;
+    }
+
+    boost::system::error_code ignored;
+    connection->shutdown(tcp::socket::shutdown_both, ignored);
+}
+
+http::request<http::string_body>
+DBRequestManager::makeRequest(const PendingRequest &request) const {
+    http::request<http::string_body> req{request.method, request.target, 11};
+    req.set(http::field::host, host_);
+    req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
+    req.keep_alive(true);
+
+    if (request.method == http::verb::post) {
+        req.set(http::field::content_type, "application/json");
+        req.body() = request.body;
+        req.prepare_payload();
+    }
+
+    return req;
+}
+
+DBResponse
+DBRequestManager::sendAbortableGetRequest(const std::string &target,
+                                          const std::atomic_bool &abort) const {
+    // same as sendRequest, except that the read is asynchronous so we can
+    // give up on it : a long-poll may be held by the server for a while and we
+    // don't want to keep the client hanging when it shuts down
+
     DBResponse dbResp;
 
     try {
@@ -49,30 +266,41 @@ DBRequestManager::sendRequest(http::verb method, const std::string &target,
         tcp::socket socket(ioc);
         asio::connect(socket, results.begin(), results.end());
 
-        boost::beast::flat_buffer buffer;
-        http::request<http::string_body> req{method, target, 11};
+        http::request<http::string_body> req{http::verb::get, target, 11};
         req.set(http::field::host, host_);
         req.set(http::field::user_agent, BOOST_BEAST_VERSION_STRING);
-
-        if (method == http::verb::post) {
-            req.set(http::field::content_type, "application/json");
-            req.body() = body;
-            req.prepare_payload();
-        }
-
         http::write(socket, req);
 
+        boost::beast::flat_buffer buffer;
         http::response<http::string_body> res;
-        http::read(socket, buffer, res);
+        boost::system::error_code readError;
+        bool done = false;
+
+        http::async_read(socket, buffer, res,
+                         [&readError, &done](const boost::system::error_code &ec,
+                                             std::size_t) {
+                             readError = ec;
+                             done = true;
+                         });
+
+        while (!done) {
+            (void) ioc.run_for(std::chrono::milliseconds(ABORT_CHECK_INTERVAL_MS));
+            if (abort && !done) {
+                // the handler will run with operation_aborted on the next turn
+                socket.cancel();
+            }
+        }
 
-        // Set status code in the response structure
-        dbResp.status = res.result_int();
+        if (readError) {
+            throw boost::system::system_error(readError);
+        }
 
-        // Parse the response body into JSON
+        dbResp.status = res.result_int();
         std::istringstream iss(res.body());
         read_json(iss, dbResp.json);
 
-        socket.shutdown(tcp::socket::shutdown_both);
+        boost::system::error_code ignored;
+        socket.shutdown(tcp::socket::shutdown_both, ignored);
     } catch (const std::exception &e) {
         dbResp.status = 500;
         dbResp.json.put("error", e.what());
@@ -93,12 +321,47 @@ DBRequestManager::getLeaderboard(const int limit) const {
 }
 
 DBResponse
-DBRequestManager::getMessages(const std::string &accountID,
-                              const std::string &otherAccountID) const {
+DBRequestManager::getRank(const std::string &accountID, const int around) const {
     return sendRequest(http::verb::get,
-                       "/get_messages?accountID=" + accountID +
-                       "&otherAccountID=" + otherAccountID,
-                       "");
+                       "/get_rank?accountID=" + accountID +
+                       "&around=" + std::to_string(around), "");
+}
+
+DBResponse
+DBRequestManager::pollNotifications(const std::string &accountID,
+                                    const std::string &since,
+                                    const int timeoutSec,
+                                    const std::atomic_bool &abort) const {
+    // an empty since is the handshake, the server answers right away with the
+    // current cursor
+    std::string target = "/poll_notifications?accountID=" + accountID +
+                         "&timeout=" + std::to_string(timeoutSec);
+
+    if (!since.empty()) {
+        target += "&since=" + since;
+    }
+
+    return sendAbortableGetRequest(target, abort);
+}
+
+DBResponse
+DBRequestManager::getMessages(const std::string &accountID,
+                              const std::string &otherAccountID,
+                              const std::string &since,
+                              const int limit) const {
+    // since is the messageID of the last message we already have (empty to
+    // start from the beginning of the conversation), limit < 0 means no limit
+    std::string target = "/get_messages?accountID=" + accountID +
+                         "&otherAccountID=" + otherAccountID;
+
+    if (!since.empty()) {
+        target += "&since=" + since;
+    }
+    if (limit >= 0) {
+        target += "&limit=" + std::to_string(limit);
+    }
+
+    return sendRequest(http::verb::get, target, "");
 }
 
 DBResponse
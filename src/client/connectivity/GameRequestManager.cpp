@@ -6,17 +6,17 @@ GameRequestManager::GameRequestManager(const std::string &serverIP,
     // this is the constructor of the GameRequestManager class
     // it initializes the RequestManager session with the given serverIP and
     // lobbyServerPort all of them can be ignored and will then be set up to
-    // their default values (common.hpp) the clientSocket is set to -1, which
-    // means that the client is not connected to any server yet
+    // their default values (common.hpp). no socket is opened yet, this is
+    // done by connectToServer
 
-    clientSocket = NO_FILE_DESCRIPTOR;
+    lobbyServerChannel = std::make_shared<ClientChannel>(serverIP, lobbyServerPort);
 }
 
 GameRequestManager::~GameRequestManager() {
     // this is the destructor of the GameRequestManager class
-    // it closes the clientSocket if it is connected to a server
+    // it closes every channel that is still open
     // this is done to avoid memory leaks and to free the resources used by the
-    // clientSocket
+    // sockets
 
     (void) disconnectFromServer();
 }
@@ -40,32 +40,22 @@ GameRequestManager::getPort() const {
 StatusCode
 GameRequestManager::connectToServer() {
     // this method is used to connect to the server
-    // it will create a socket and connect to the server
+    // it will open the channel to the lobby server, the lobby and game ones
+    // are opened when we join one
 
-    // create the socket
-    clientSocket = socket(AF_INET, SOCK_DGRAM, 0);
-    if (clientSocket < 0) {
-        return StatusCode::ERROR_CREATING_SOCKET;
-    }
-
-    // set the socket options
-    if (setSocketOptions() != StatusCode::SUCCESS) {
-        return StatusCode::ERROR_SETTING_SOCKET_OPTIONS;
-    }
-
-    return StatusCode::SUCCESS;
+    std::lock_guard lock(channelsMutex);
+    return lobbyServerChannel->open();
 }
 
 StatusCode
 GameRequestManager::disconnectFromServer() {
     // this method is used to disconnect from the server
-    // it will close the socket
+    // it will close every channel
 
-    // close the socket
-    if (clientSocket != NO_FILE_DESCRIPTOR) {
-        close(clientSocket);
-        clientSocket = NO_FILE_DESCRIPTOR;
-    }
+    closeLobbyChannels();
+
+    std::lock_guard lock(channelsMutex);
+    lobbyServerChannel->close();
 
     return StatusCode::SUCCESS;
 }
@@ -79,31 +69,40 @@ GameRequestManager::getClientStatus(const std::string &username) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::GET_CLIENT_STATUS;
     request.params["username"] = username;
 
-    // this is a special case, we want to send the request specifically to the
-    // lobby server, so we grab the current port, restore the listening port,
-    // send the request, and then restore the port
+    // this goes to the lobby server whatever lobby or game we are in, on its
+    // own socket so it never mixes with the in-game traffic
+    return sendRequest(Endpoint::LobbyServer, request, READ_RETRIES).get();
+}
 
-    const int currentPort = getCurrentPort();
-    if (changePort(lobbyServerPort) != StatusCode::SUCCESS) {
-        return ServerResponse::ErrorResponse(INVALID_ID,
-                                             StatusCode::ERROR_CHANGING_PORT);
-    }
+std::vector<ServerResponse>
+GameRequestManager::getClientStatuses(const std::vector<std::string> &usernames) {
+    // this method is used to get the status of many players at once (the
+    // friends list). the usernames are sent as a json array, split so that
+    // the answer of a batch always fits in one datagram
 
-    // send the request and receive the response
-    (void) sendRequest(request);
-    const ServerResponse response = receiveResponse();
+    std::vector<std::future<ServerResponse>> futures;
+    for (std::size_t first = 0; first < usernames.size(); first += MAX_STATUS_BATCH) {
+        const std::size_t last = std::min(usernames.size(), first + MAX_STATUS_BATCH);
 
-    // restore the port
-    if (changePort(currentPort) != StatusCode::SUCCESS) {
-        return ServerResponse::ErrorResponse(INVALID_ID,
-                                             StatusCode::ERROR_RESTORING_PORT);
+        ServerRequest request;
+        request.method = ServerMethods::GET_CLIENT_STATUSES;
+        request.params["usernames"] =
+            nlohmann::json(std::vector<std::string>(usernames.begin() + first,
+                                                    usernames.begin() + last)).dump();
+
+        futures.push_back(sendRequest(Endpoint::LobbyServer, request, READ_RETRIES));
     }
 
-    return response;
+    std::vector<ServerResponse> responses;
+    responses.reserve(futures.size());
+    for (auto &future: futures) {
+        responses.push_back(future.get());
+    }
+
+    return responses;
 }
 
 // main menu stuff
@@ -116,13 +115,11 @@ GameRequestManager::startSession(const std::string &username) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::START_SESSION;
     request.params["username"] = username;
 
     // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    return sendRequest(Endpoint::LobbyServer, request).get();
 }
 
 ServerResponse
@@ -133,29 +130,62 @@ GameRequestManager::endSession(const std::string &token) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::END_SESSION;
     request.params["token"] = token;
 
     // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    return sendRequest(Endpoint::LobbyServer, request).get();
+}
+
+std::future<ServerResponse>
+GameRequestManager::heartbeatAsync(const std::string &token) {
+    // this method is used to tell the lobby server the session is still alive
+    // when no other request was sent for a while. it only reads, so it can be
+    // sent again if lost. the caller doesn't have to wait for the answer
+
+    // create the request
+    ServerRequest request;
+    request.method = ServerMethods::HEARTBEAT;
+    request.params["token"] = token;
+
+    // send the request
+    return sendRequest(Endpoint::LobbyServer, request, READ_RETRIES);
+}
+
+std::chrono::steady_clock::duration
+GameRequestManager::timeSinceTokenSent() const {
+    return std::chrono::steady_clock::now() -
+           std::chrono::steady_clock::time_point(std::chrono::steady_clock::duration(lastTokenSent.load()));
 }
 
 ServerResponse
-GameRequestManager::getPublicLobbiesList() {
+GameRequestManager::getPublicLobbiesList(const int knownVersion,
+                                         const std::optional<GameMode> gameMode,
+                                         const int page) {
     // this method is used to get the list of public lobbies
     // it will send a request to the lobby server to get the list of public
     // lobbies it will return the response from the server
 
+    return getPublicLobbiesListAsync(knownVersion, gameMode, page).get();
+}
+
+std::future<ServerResponse>
+GameRequestManager::getPublicLobbiesListAsync(const int knownVersion,
+                                              const std::optional<GameMode> gameMode,
+                                              const int page) {
+    // same, but the pages of a long listing can be asked for all at once
+
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::GET_PUBLIC_LOBBIES;
+    request.params["version"] = std::to_string(knownVersion);
+    request.params["page"] = std::to_string(page);
+    if (gameMode) {
+        request.params["gameMode"] = std::to_string(static_cast<int>(*gameMode));
+    }
 
-    // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    // send the request, it only reads so it can be sent again if lost
+    return sendRequest(Endpoint::LobbyServer, request, READ_RETRIES);
 }
 
 ServerResponse
@@ -168,7 +198,6 @@ GameRequestManager::createAndJoinLobby(const std::string &token,
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::CREATE_LOBBY;
     request.params["token"] = token;
     request.params["gameMode"] = std::to_string(static_cast<int>(gameMode));
@@ -176,8 +205,7 @@ GameRequestManager::createAndJoinLobby(const std::string &token,
     request.params["visibility"] = isPublic ? "public" : "private";
 
     // send the request
-    (void) sendRequest(request);
-    ServerResponse response = receiveResponse();
+    ServerResponse response = sendRequest(Endpoint::LobbyServer, request).get();
 
     // if the request is sucessful, we join the lobby. if not, we can return the
     // response
@@ -201,24 +229,22 @@ GameRequestManager::joinLobby(const std::string &token,
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::JOIN_LOBBY;
     request.params["token"] = token;
     request.params["lobbyID"] = lobbyID;
 
     // send the request
-    (void) sendRequest(request);
-    ServerResponse response = receiveResponse();
+    ServerResponse response = sendRequest(Endpoint::LobbyServer, request).get();
 
-    // change the port to the lobby port if the request is successful
+    // open the channels to the lobby if the request is successful
     if (response.status != StatusCode::SUCCESS) {
         return response;
     }
 
     const int lobbyPort = std::stoi(response.data.at("port"));
-    if (changePort(lobbyPort) != StatusCode::SUCCESS) {
+    if (openLobbyChannels(lobbyPort) != StatusCode::SUCCESS) {
         return ServerResponse::ErrorResponse(INVALID_ID,
-                                             StatusCode::ERROR_CHANGING_PORT);
+                                             StatusCode::ERROR_NOT_CONNECTED);
     }
 
     return response;
@@ -233,24 +259,22 @@ GameRequestManager::spectateLobby(const std::string &token,
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::SPECTATE_LOBBY;
     request.params["token"] = token;
     request.params["lobbyID"] = lobbyID;
 
     // send the request
-    (void) sendRequest(request);
-    ServerResponse response = receiveResponse();
+    ServerResponse response = sendRequest(Endpoint::LobbyServer, request).get();
 
-    // change the port to the lobby port if the request is successful
+    // open the channels to the lobby if the request is successful
     if (response.status != StatusCode::SUCCESS) {
         return response;
     }
 
     const int lobbyPort = std::stoi(response.data.at("port"));
-    if (changePort(lobbyPort) != StatusCode::SUCCESS) {
+    if (openLobbyChannels(lobbyPort) != StatusCode::SUCCESS) {
         return ServerResponse::ErrorResponse(INVALID_ID,
-                                             StatusCode::ERROR_CHANGING_PORT);
+                                             StatusCode::ERROR_NOT_CONNECTED);
     }
 
     return response;
@@ -266,13 +290,11 @@ GameRequestManager::getCurrentLobbyState(const std::string &token) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::GET_CURRENT_LOBBY;
     request.params["token"] = token;
 
-    // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    // send the request, it only reads so it can be sent again if lost
+    return sendRequest(Endpoint::Lobby, request, READ_RETRIES).get();
 }
 
 ServerResponse
@@ -283,24 +305,18 @@ GameRequestManager::leaveLobby(const std::string &token) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::LEAVE_LOBBY;
     request.params["token"] = token;
 
     // send the request
-    (void) sendRequest(request);
-    ServerResponse response = receiveResponse();
+    ServerResponse response = sendRequest(Endpoint::Lobby, request).get();
 
-    // restore the port if the request is successful
-    if (response.status != StatusCode::SUCCESS) {
-        return response;
+    // we are done with this lobby if the request is successful
+    if (response.status == StatusCode::SUCCESS) {
+        closeLobbyChannels();
     }
 
-    // cool ternary operator
-    return restoreListeningPort() == StatusCode::SUCCESS
-               ? response
-               : ServerResponse::ErrorResponse(
-                   INVALID_ID, StatusCode::ERROR_RESTORING_PORT);
+    return response;
 }
 
 ServerResponse
@@ -311,13 +327,11 @@ GameRequestManager::readyUp(const std::string &token) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::READY;
     request.params["token"] = token;
 
     // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    return sendRequest(Endpoint::Lobby, request).get();
 }
 
 ServerResponse
@@ -328,13 +342,11 @@ GameRequestManager::unreadyUp(const std::string &token) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::UNREADY;
     request.params["token"] = token;
 
     // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    return sendRequest(Endpoint::Lobby, request).get();
 }
 
 // game stuff
@@ -346,16 +358,22 @@ GameRequestManager::sendKeyStroke(const std::string &token,
     // it will send a request to the game server to send a key stroke
     // it will return the response from the server
 
+    return sendKeyStrokeAsync(token, keyStroke).get();
+}
+
+std::future<ServerResponse>
+GameRequestManager::sendKeyStrokeAsync(const std::string &token,
+                                       const KeyStrokePacket &keyStroke) {
+    // same as sendKeyStroke, without waiting for the answer
+
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::KEY_STROKE;
     request.params["token"] = token;
     request.params["keystroke"] = keyStroke.serialize();
 
-    // send the request
-    (void) sendRequest(request);
-    return receiveResponse();
+    // send the request (never again : the server would apply it twice)
+    return sendRequest(Endpoint::Game, request);
 }
 
 ServerResponse
@@ -364,16 +382,32 @@ GameRequestManager::getGameState(const std::string &token) {
     // it will send a request to the game server to get the state of the game
     // it will return the response from the server
 
+    return getGameStateAsync(token).get();
+}
+
+std::future<ServerResponse>
+GameRequestManager::getGameStateAsync(const std::string &token) {
+    // same as getGameState, without waiting for the answer
+
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::GET_GAME_STATE;
     request.params["token"] = token;
 
-    // send the request
+    // send the request, it only reads so it can be sent again if lost
+    return sendRequest(Endpoint::Game, request, READ_RETRIES);
+}
+
+ServerResponse
+GameRequestManager::getGameOverview(const std::string &token) {
+    // this method is used to get the overview of the game (every board, low
+    // resolution), it only reads so it can be sent again if lost
+
+    ServerRequest request;
+    request.method = ServerMethods::GET_GAME_OVERVIEW;
+    request.params["token"] = token;
 
-    (void) sendRequest(request);
-    return receiveResponse();
+    return sendRequest(Endpoint::Game, request, READ_RETRIES).get();
 }
 
 ServerResponse
@@ -384,132 +418,91 @@ GameRequestManager::leaveGame(const std::string &token) {
 
     // create the request
     ServerRequest request;
-    request.id = generateRequestID();
     request.method = ServerMethods::LEAVE_GAME;
     request.params["token"] = token;
 
     // send the request
-    (void) sendRequest(request);
-    ServerResponse response = receiveResponse();
+    ServerResponse response = sendRequest(Endpoint::Game, request).get();
 
-    // restore the port if the request is successful
-    if (response.status != StatusCode::SUCCESS) {
-        return response;
-    } else {
-        return restoreListeningPort() == StatusCode::SUCCESS
-                   ? response
-                   : ServerResponse::ErrorResponse(
-                       INVALID_ID, StatusCode::ERROR_RESTORING_PORT);
+    // we are done with this game (and its lobby) if the request is successful
+    if (response.status == StatusCode::SUCCESS) {
+        closeLobbyChannels();
     }
+
+    return response;
 }
 
 // connectivity
 
-StatusCode
-GameRequestManager::sendRequest(const ServerRequest &request) {
-    // this method is used to send a request to the server
-    // it will serialize the request and send it to the server
-
-    // serialize the request
-    const std::string serializedRequest = request.serialize();
-    // send the request
-    const ssize_t sendLen = sendto(
-        clientSocket, serializedRequest.c_str(), serializedRequest.size(), 0,
-        reinterpret_cast<struct sockaddr *>(&serverAddress),
-        sizeof(serverAddress));
-    if (sendLen < 0) {
-        return StatusCode::ERROR_SENDING_REQUEST;
-    }
-
-    return StatusCode::SUCCESS;
-}
-
-ServerResponse
-GameRequestManager::receiveResponse() {
-    // this method is used to receive a response from the server
-    // it will receive the response from the server and deserialize it
-
-    // receive the response
-    char buffer[MAX_BUFFER_SIZE];
-    const ssize_t recvLen = recv(clientSocket, buffer, MAX_BUFFER_SIZE, 0);
-    if (recvLen < 0) {
-        return ServerResponse::ErrorResponse(
-            INVALID_ID, StatusCode::ERROR_RECEIVING_RESPONSE);
+std::future<ServerResponse>
+GameRequestManager::sendRequest(const Endpoint endpoint, ServerRequest &request,
+                                const int retries) {
+    // this method is used to send a request on the channel of the given
+    // endpoint, the future is set once the answer with its id arrives
+
+    const std::shared_ptr<ClientChannel> channel = getChannel(endpoint);
+    if (!channel) {
+        // not in a lobby / game, nobody to send this to
+        std::promise<ServerResponse> promise;
+        promise.set_value(ServerResponse::ErrorResponse(
+            INVALID_ID, StatusCode::ERROR_CLIENT_NOT_IN_LOBBY));
+        return promise.get_future();
     }
 
-    // deserialize the response
-    const std::string serializedResponse(buffer, recvLen);
-    return ServerResponse::deserialize(serializedResponse);
-}
-
-StatusCode
-GameRequestManager::setSocketOptions() {
-    // this method is used to set the socket options
-    // it will set the socket options for the client socket
-
-    // set the socket options
-    timeval timeout;
-    timeout.tv_sec = CLIENT_TIMEOUT_SEC;
-    timeout.tv_usec = TIMEOUT_USEC;
-
-    if (setsockopt(clientSocket, SOL_SOCKET, SO_RCVTIMEO, &timeout,
-                   sizeof(timeout)) < 0) {
-        return StatusCode::ERROR_SETTING_SOCKET_OPTIONS;
+    // the lobby server, the lobbies and the games all take it as a heartbeat
+    if (request.params.contains("token")) {
+        lastTokenSent = std::chrono::steady_clock::now().time_since_epoch().count();
     }
 
-    // set the server address / port
-    serverAddress.sin_family = AF_INET;
-    inet_pton(AF_INET, serverIP.c_str(), &serverAddress.sin_addr);
-    serverAddress.sin_port = htons(static_cast<uint16_t>(lobbyServerPort));
-
-    return StatusCode::SUCCESS;
+    return channel->send(request, retries);
 }
 
-int
-GameRequestManager::getCurrentPort() {
-    // this method is used to get the current port of the server
-    // it will return the port used by the current clientSocket
-
-    if (clientSocket == NO_FILE_DESCRIPTOR) {
-        return EMPTY_LOBBY_PORT;
+std::shared_ptr<ClientChannel>
+GameRequestManager::getChannel(const Endpoint endpoint) {
+    // this method returns the channel of the endpoint (null if there is none)
+
+    std::lock_guard lock(channelsMutex);
+    switch (endpoint) {
+        case Endpoint::LobbyServer:
+            return lobbyServerChannel;
+        case Endpoint::Lobby:
+            return lobbyChannel;
+        case Endpoint::Game:
+            return gameChannel;
+        default:
+            return nullptr;
     }
-
-    return ntohs(serverAddress.sin_port);
 }
 
 StatusCode
-GameRequestManager::changePort(int newPort) {
-    // this method is used to change the port of the server
-    // it will change the port of the server address
+GameRequestManager::openLobbyChannels(const int port) {
+    // this method is used to open the channels to the lobby we just joined,
+    // and to the game that will run on the same port
 
-    if (newPort == getCurrentPort()) {
-        // do nothing if the port is already the same
-        return StatusCode::SUCCESS;
-    }
+    auto lobby = std::make_shared<ClientChannel>(serverIP, port);
+    auto game = std::make_shared<ClientChannel>(serverIP, port);
 
-    if (newPort <= 0 || newPort > MAX_PORT) {
-        return StatusCode::ERROR_INVALID_PORT;
+    if (const StatusCode status = lobby->open(); status != StatusCode::SUCCESS) {
+        return status;
+    }
+    if (const StatusCode status = game->open(); status != StatusCode::SUCCESS) {
+        return status;
     }
 
-    // change the port
-    serverAddress.sin_port = htons(static_cast<uint16_t>(newPort));
+    std::lock_guard lock(channelsMutex);
+    lobbyChannel = std::move(lobby);
+    gameChannel = std::move(game);
 
     return StatusCode::SUCCESS;
 }
 
-StatusCode
-GameRequestManager::restoreListeningPort() {
-    // this method is used to restore the listening socket
-    // it will change the port of the server address to the lobby server port
-
-    // change the port
-    return changePort(lobbyServerPort);
-}
-
-int
-GameRequestManager::generateRequestID() {
-    // this method is used to generate a request ID
-    // it will return a random number between 0 and MAX_REQUEST_ID
+void
+GameRequestManager::closeLobbyChannels() {
+    // this method is used to forget the lobby and game channels. a request
+    // still in flight on one of them keeps it alive until it is answered,
+    // the last owner closes the socket
 
-    return rand() % MAX_REQUEST_ID;
+    std::lock_guard lock(channelsMutex);
+    lobbyChannel.reset();
+    gameChannel.reset();
 }
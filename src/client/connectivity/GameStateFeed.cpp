@@ -0,0 +1,219 @@
+#include "GameStateFeed.hpp"
+
+GameStateFeed::GameStateFeed(ClientSession &session, Callback onNewFrame)
+    : session_(session), onNewFrame_(std::move(onNewFrame)) {
+}
+
+GameStateFeed::~GameStateFeed() {
+    stop();
+}
+
+void
+GameStateFeed::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+
+    feedThread_ = std::thread(&GameStateFeed::feedLoop, this);
+}
+
+void
+GameStateFeed::stop() {
+    // whatever request is in flight finishes first (at worst after
+    // CLIENT_TIMEOUT_SEC), the queued ones are dropped
+
+    {
+        std::lock_guard lock(queueMutex_);
+        running_ = false;
+    }
+    queueCV_.notify_all();
+
+    if (feedThread_.joinable()) {
+        feedThread_.join();
+    }
+}
+
+void
+GameStateFeed::sendAction(const Action action) {
+    bool predicted = false;
+
+    {
+        std::lock_guard lock(frameMutex_);
+        const int sequence = session_.nextInputSequence();
+
+        if (!frontFrame_.isSpectator && predictor_.applyLocal(sequence, action)) {
+            frontFrame_.playerState.playerGrid = *predictor_.getPredictedGrid();
+            ++frontFrame_.sequence;
+            predicted = true;
+        }
+
+        // still under frameMutex_ so the queue is in sequence order
+        std::lock_guard queueLock(queueMutex_);
+        pendingActions_.emplace_back(sequence, action);
+    }
+    queueCV_.notify_all();
+
+    if (predicted && onNewFrame_) {
+        onNewFrame_();
+    }
+}
+
+void
+GameStateFeed::post(Task task) {
+    {
+        std::lock_guard lock(queueMutex_);
+        pendingTasks_.push_back(std::move(task));
+    }
+    queueCV_.notify_all();
+}
+
+GameFrame
+GameStateFeed::getFrame() {
+    std::lock_guard lock(frameMutex_);
+    return frontFrame_;
+}
+
+void
+GameStateFeed::feedLoop() {
+    // this is the body of the feed thread : send what was queued, then ask
+    // for the state. a key stroke wakes us up right away so its effect shows
+    // on the next poll instead of waiting for the timer
+
+    while (running_) {
+        std::deque<std::pair<int, Action>> actions;
+        std::deque<Task> tasks;
+
+        {
+            std::unique_lock lock(queueMutex_);
+            queueCV_.wait_for(lock, std::chrono::milliseconds(POLL_INTERVAL_MS), [this] {
+                return !running_ || !pendingActions_.empty() || !pendingTasks_.empty();
+            });
+
+            if (!running_) {
+                break;
+            }
+
+            actions.swap(pendingActions_);
+            tasks.swap(pendingTasks_);
+        }
+
+        StatusCode error = StatusCode::SUCCESS;
+        if (!actions.empty()) {
+            error = session_.sendKeyStrokes({actions.begin(), actions.end()});
+        }
+
+        for (const Task &task: tasks) {
+            task(session_);
+        }
+
+        if (error != StatusCode::SUCCESS) {
+            publish(error);
+        }
+
+        pollState();
+        pollOverview();
+    }
+}
+
+void
+GameStateFeed::pollState() {
+    std::string rawState;
+    const StatusCode result = session_.fetchGameState(rawState);
+
+    if (result != StatusCode::SUCCESS) {
+        publish(result);
+        return;
+    }
+
+    // same bytes as last time, nothing to redraw
+    if (rawState == lastRawState_) {
+        return;
+    }
+
+    try {
+        backFrame_.playerState = PlayerState::deserialize(rawState);
+        backFrame_.isSpectator = false;
+    } catch (const std::exception &) {
+        // not a player, so we are spectating someone
+        try {
+            backFrame_.spectatorState = SpectatorState::deserialize(rawState);
+            backFrame_.isSpectator = true;
+        } catch (const std::exception &) {
+            publish(StatusCode::ERROR);
+            return;
+        }
+    }
+
+    lastRawState_ = std::move(rawState);
+    publish(StatusCode::SUCCESS);
+}
+
+void
+GameStateFeed::pollOverview() {
+    // only royale games have a mini-map, and it doesn't need to be as fresh
+    // as our own board
+
+    const GameMode gameMode = backFrame_.isSpectator
+                                  ? backFrame_.spectatorState.gameMode
+                                  : backFrame_.playerState.gameMode;
+    if (gameMode != GameMode::ROYALE) {
+        return;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - lastOverviewPoll_ < std::chrono::milliseconds(OVERVIEW_UPDATE_INTERVAL)) {
+        return;
+    }
+    lastOverviewPoll_ = now;
+
+    GameOverview overview;
+    if (session_.fetchGameOverview(overview) != StatusCode::SUCCESS ||
+        overview.boards == backFrame_.overview.boards) {
+        return; // the last one stays on screen
+    }
+
+    // the back frame is only ever touched by this thread, the front one is
+    // updated in place so the ui doesn't wait for the next state
+    backFrame_.overview = overview;
+    {
+        std::lock_guard lock(frameMutex_);
+        frontFrame_.overview = std::move(overview);
+        ++frontFrame_.sequence;
+    }
+
+    if (onNewFrame_) {
+        onNewFrame_();
+    }
+}
+
+void
+GameStateFeed::publish(const StatusCode error) {
+    // a new state goes through the back buffer, an error only touches the
+    // front one so the last good frame stays on screen
+
+    {
+        std::lock_guard lock(frameMutex_);
+
+        if (error == StatusCode::SUCCESS) {
+            // what the server says, plus the key strokes it didn't apply yet
+            if (backFrame_.isSpectator) {
+                predictor_.reset();
+            } else {
+                predictor_.reconcile(backFrame_.playerState);
+                if (const auto grid = predictor_.getPredictedGrid()) {
+                    backFrame_.playerState.playerGrid = *grid;
+                }
+            }
+
+            backFrame_.sequence = frontFrame_.sequence + 1;
+            backFrame_.lastError = StatusCode::SUCCESS;
+            std::swap(frontFrame_, backFrame_);
+        } else {
+            frontFrame_.lastError = error;
+        }
+    }
+
+    if (onNewFrame_) {
+        onNewFrame_();
+    }
+}
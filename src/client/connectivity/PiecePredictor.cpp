@@ -0,0 +1,157 @@
+#include "PiecePredictor.hpp"
+#include "Common.hpp"
+
+#include <algorithm>
+
+bool
+PiecePredictor::isPredictable(const Action action) {
+    switch (action) {
+        case Action::MoveLeft:
+        case Action::MoveRight:
+        case Action::MoveDown:
+        case Action::RotateLeft:
+        case Action::RotateRight:
+        case Action::InstantFall:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void
+PiecePredictor::reconcile(const PlayerState &state) {
+    // the inputs the server already applied are in the state, the others
+    // are not : drop the first ones, replay the second ones
+
+    std::erase_if(pending_, [&state](const PendingInput &input) {
+        return input.sequence <= state.lastInputSequence;
+    });
+
+    const Clock::time_point now = Clock::now();
+    std::erase_if(pending_, [now](const PendingInput &input) {
+        return now - input.sentAt > std::chrono::milliseconds(PENDING_TIMEOUT_MS);
+    });
+
+    controlsReversed_ = state.controlsReversed;
+    controlsBlocked_ = state.controlsBlocked;
+
+    const tetroMat &grid = state.playerGrid;
+    if (state.isGameOver || state.currentTetro == PieceType::None || grid.empty() || grid[0].empty()) {
+        matrix_.reset();
+        return;
+    }
+
+    const int height = static_cast<int>(grid.size());
+    const int width = static_cast<int>(grid[0].size());
+    matrix_.emplace(width, height);
+
+    // the grid has the piece drawn in it, take it out so it doesn't collide
+    // with itself
+    tetroMat &board = matrix_->getBoard();
+    board = grid;
+
+    const auto [x, y] = state.currentPosition;
+    for (int i = 0; i < static_cast<int>(state.currentShape.size()); ++i) {
+        for (int j = 0; j < static_cast<int>(state.currentShape[i].size()); ++j) {
+            const int nx = x + j;
+            const int ny = y + i;
+            if (state.currentShape[i][j] && nx >= 0 && nx < width && ny >= 0 && ny < height) {
+                board[ny][nx] = static_cast<int>(PieceType::None);
+            }
+        }
+    }
+
+    matrix_->setCurrent(Tetromino(state.currentPosition, state.currentTetro, state.currentShape));
+
+    // past an input we can't predict (the bag swaps the piece) or an instant
+    // fall (the next piece comes out of the factory) we don't know what the
+    // piece looks like anymore, wait for the server
+    for (const PendingInput &input: pending_) {
+        if (!isPredictable(input.action) || !hasPiece()) {
+            break;
+        }
+        (void) applyOnMatrix(input.action);
+    }
+}
+
+bool
+PiecePredictor::applyLocal(const int sequence, const Action action) {
+    const bool waitingForServer = std::any_of(pending_.begin(), pending_.end(), [](const PendingInput &input) {
+        return !isPredictable(input.action);
+    });
+
+    pending_.push_back({sequence, action, Clock::now()});
+    if (pending_.size() > MAX_PENDING_INPUTS) {
+        pending_.pop_front();
+    }
+
+    if (!matrix_ || !hasPiece() || waitingForServer || !isPredictable(action)) {
+        return false;
+    }
+
+    return applyOnMatrix(action);
+}
+
+std::optional<tetroMat>
+PiecePredictor::getPredictedGrid() const {
+    if (!matrix_) {
+        return std::nullopt;
+    }
+
+    return matrix_->getBoardWithCurrentPiece();
+}
+
+std::size_t
+PiecePredictor::pendingCount() const {
+    return pending_.size();
+}
+
+void
+PiecePredictor::reset() {
+    matrix_.reset();
+    pending_.clear();
+    controlsReversed_ = false;
+    controlsBlocked_ = false;
+}
+
+bool
+PiecePredictor::applyOnMatrix(Action action) {
+    // same as Game::getActionFromKeyStroke on the server
+    if (controlsBlocked_) {
+        if (std::find(BLOCKED_ACTIONS.begin(), BLOCKED_ACTIONS.end(), action) != BLOCKED_ACTIONS.end()) {
+            return false;
+        }
+    } else if (controlsReversed_ && REVERSE_ACTIONS_MAP.contains(action)) {
+        action = REVERSE_ACTIONS_MAP.at(action);
+    }
+
+    switch (action) {
+        case Action::MoveLeft:
+            return matrix_->tryMoveLeft();
+        case Action::MoveRight:
+            return matrix_->tryMoveRight();
+        case Action::MoveDown:
+            return matrix_->tryMoveDown();
+        case Action::RotateLeft:
+            return matrix_->tryRotateLeft();
+        case Action::RotateRight:
+            return matrix_->tryRotateRight();
+        case Action::InstantFall:
+            // it lands, the server places it the next time gravity applies (it
+            // can't fall anymore) and we do it right away
+            (void) matrix_->tryInstantFall();
+            if (!matrix_->tryPlaceCurrentPiece()) {
+                return false;
+            }
+            matrix_->deleteCurrent();
+            (void) matrix_->clearFullLines();
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool
+PiecePredictor::hasPiece() const {
+    return matrix_ && matrix_->getCurrent() != nullptr;
+}
@@ -0,0 +1,166 @@
+#include "BoardWidget.hpp"
+#include "GameRenderGUI.hpp"
+
+#include <algorithm>
+
+
+BoardWidget::BoardWidget(bool isOpponentBoard, QWidget *parent) : QWidget(parent),
+    isOpponentBoard(isOpponentBoard), board(DEFAULT_ROWS, std::vector<int>(DEFAULT_COLS, 0)) {
+    // no background of our own, the game screen image shows through
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+
+    if (isOpponentBoard) {
+        setMaximumSize(300, 400); // plus petit
+    } else {
+        setMaximumSize(500, 800); // plus grand
+    }
+}
+
+QSize BoardWidget::sizeHint() const {
+    const int hintCell = isOpponentBoard ? 20 : 35;
+    return {DEFAULT_COLS * hintCell + 2 * BORDER_WIDTH, DEFAULT_ROWS * hintCell + 2 * BORDER_WIDTH};
+}
+
+void BoardWidget::setBoard(const tetroMat &newBoard) {
+    // this method only schedules a repaint of the cells that differ from the
+    // last board, most frames nothing or a single piece moved
+
+    const bool sameShape = newBoard.size() == board.size()
+        && std::equal(newBoard.begin(), newBoard.end(), board.begin(),
+                      [](const auto &a, const auto &b) { return a.size() == b.size(); });
+
+    if (!sameShape) {
+        // new game, opponent gone or back : everything moves
+        board = newBoard;
+        updateGeometryCache();
+        update();
+        return;
+    }
+
+    QRegion dirty;
+    for (int y = 0; y < static_cast<int>(board.size()); ++y) {
+        for (int x = 0; x < static_cast<int>(board[y].size()); ++x) {
+            if (board[y][x] != newBoard[y][x]) {
+                board[y][x] = newBoard[y][x];
+                dirty += cellRect(y, x);
+            }
+        }
+    }
+
+    if (!dirty.isEmpty()) {
+        update(dirty);
+    }
+}
+
+void BoardWidget::setGameOver(bool gameOver) {
+    if (gameOver != isGameOver) {
+        isGameOver = gameOver;
+        update();
+    }
+}
+
+void BoardWidget::resizeEvent(QResizeEvent *event) {
+    updateGeometryCache();
+    QWidget::resizeEvent(event);
+}
+
+void BoardWidget::updateGeometryCache() {
+    const int rows = static_cast<int>(board.size());
+    const int cols = board.empty() ? 0 : static_cast<int>(board[0].size());
+
+    int newCellSize = 0;
+    if (rows > 0 && cols > 0) {
+        newCellSize = std::max(1, std::min((width() - 2 * BORDER_WIDTH) / cols,
+                                           (height() - 2 * BORDER_WIDTH) / rows));
+    }
+
+    // the pixmaps are drawn for one cell size only
+    if (newCellSize != cellSize) {
+        cellSize = newCellSize;
+        cellPixmaps.clear();
+    }
+
+    gridOrigin = QPoint((width() - cols * cellSize) / 2, (height() - rows * cellSize) / 2);
+}
+
+QRect BoardWidget::cellRect(int row, int col) const {
+    return {gridOrigin.x() + col * cellSize, gridOrigin.y() + row * cellSize, cellSize, cellSize};
+}
+
+const QPixmap &BoardWidget::cellPixmap(int value) {
+    auto it = cellPixmaps.find(value);
+    if (it != cellPixmaps.end()) {
+        return it->second;
+    }
+
+    // same look as the old stylesheet : colored, cyan border, rounded corners
+    QPixmap pixmap(cellSize, cellSize);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(QPen(QColor(0, 180, 200), BORDER_WIDTH));
+    painter.setBrush(colorForValue(value));
+    painter.drawRoundedRect(QRectF(1, 1, cellSize - 2, cellSize - 2), 5, 5);
+    painter.end();
+
+    return cellPixmaps.emplace(value, std::move(pixmap)).first->second;
+}
+
+void BoardWidget::paintEvent(QPaintEvent *event) {
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const int rows = static_cast<int>(board.size());
+    const int cols = board.empty() ? 0 : static_cast<int>(board[0].size());
+
+    // Pas d'adversaire
+    if (isOpponentBoard && (rows == 0 || cols == 0)) {
+        const QRectF box = QRectF(rect()).adjusted(1, 1, -1, -1);
+        painter.setPen(QPen(QColor(0, 225, 255), BORDER_WIDTH, Qt::DashLine));
+        painter.setBrush(QColor(30, 30, 30, 180));
+        painter.drawRoundedRect(box, 8, 8);
+
+        QFont f = font();
+        f.setPixelSize(25);
+        f.setItalic(true);
+        painter.setFont(f);
+        painter.drawText(rect(), Qt::AlignCenter, "NO OPPONENT");
+        return;
+    }
+
+    const QRect grid(gridOrigin, QSize(cols * cellSize, rows * cellSize));
+    const QRect frame = grid.adjusted(-BORDER_WIDTH, -BORDER_WIDTH, BORDER_WIDTH, BORDER_WIDTH);
+
+    painter.setPen(QPen(QColor(0, 225, 255), BORDER_WIDTH));
+    painter.setBrush(QColor(0, 0, 0, 150));
+    painter.drawRoundedRect(QRectF(frame).adjusted(1, 1, -1, -1), 5, 5);
+
+    // only the cells Qt asked for, the clip takes care of the rest
+    if (cellSize > 0) {
+        const QRect area = event->rect().intersected(grid);
+        if (!area.isEmpty()) {
+            const int firstRow = (area.top() - grid.top()) / cellSize;
+            const int lastRow = std::min(rows - 1, (area.bottom() - grid.top()) / cellSize);
+            const int firstCol = (area.left() - grid.left()) / cellSize;
+            const int lastCol = std::min(cols - 1, (area.right() - grid.left()) / cellSize);
+
+            for (int y = firstRow; y <= lastRow; ++y) {
+                for (int x = firstCol; x <= lastCol; ++x) {
+                    if (board[y][x] != 0) {
+                        painter.drawPixmap(cellRect(y, x).topLeft(), cellPixmap(board[y][x]));
+                    }
+                }
+            }
+        }
+    }
+
+    if (isGameOver) {
+        QFont f = font();
+        f.setBold(true);
+        f.setPointSize(24);
+        painter.setFont(f);
+        painter.setPen(Qt::red);
+        painter.drawText(frame, Qt::AlignCenter, "GAME OVER");
+    }
+}
@@ -1,5 +1,6 @@
 
 #include "GameRenderGUI.hpp"
+#include "BoardWidget.hpp"
 
 
 QColor colorForValue(int value) {
@@ -16,7 +17,9 @@ QColor colorForValue(int value) {
     }
 }
 
-QWidget* renderBoard(const tetroMat &board, bool isOpponentBoard, bool isGameOver, QWidget *parent) {
+QWidget* renderBoard(BoardWidget *board, bool isOpponentBoard, QWidget *parent) {
+    // the board itself is kept by the caller and updated in place, this only
+    // puts the title on top of it once
     // 1) Conteneur avec mise en page verticale
     QWidget    *container  = new QWidget(parent);
     QVBoxLayout *mainLayout = new QVBoxLayout(container);
@@ -58,88 +61,9 @@ QWidget* renderBoard(const tetroMat &board, bool isOpponentBoard, bool isGameOve
     }
     mainLayout->addWidget(titleLabel);
 
-    // 4) Superposition facultative “GAME OVER” tout en haut
-    if (isGameOver) {
-        QLabel *goLabel = new QLabel("GAME OVER", container);
-        QFont f = goLabel->font();
-        f.setBold(true);
-        f.setPointSize(24);
-        goLabel->setFont(f);
-        goLabel->setAlignment(Qt::AlignCenter);
-        goLabel->setStyleSheet("color: red;");
-        if (isOpponentBoard) {
-            goLabel->setMaximumWidth(300);
-        } else {
-            goLabel->setMaximumWidth(500);
-        }
-        mainLayout->insertWidget(1, goLabel);
-    }
-
-    // Vérification si le board est vide (pour l'opponent)
-    if (isOpponentBoard && board.empty()) {
-        QLabel *noOpponentLabel = new QLabel("NO OPPONENT", container);
-        noOpponentLabel->setAlignment(Qt::AlignCenter);
-        noOpponentLabel->setStyleSheet(R"(
-            color: rgb(0, 225, 255);
-            background-color: rgba(30, 30, 30, 180);
-            border: 2px dashed rgb(0, 225, 255);
-            border-radius: 8px;
-            padding: 15px;
-            font-size: 25px;
-            font-style: italic;
-        )");
-        noOpponentLabel->setFixedSize(300, 400);
-        mainLayout->addWidget(noOpponentLabel);
-        return container;
-    }
-
-
-    // 3) Boîte du plateau : utiliser directement un QGridLayout dans le QGroupBox
-    QGroupBox *boardBox = new QGroupBox(container);
-    if (isOpponentBoard) {
-        boardBox->setMaximumSize(300, 400); // plus petit
-    } else {
-        boardBox->setMaximumSize(500, 800); // plus grand
-    }
-    boardBox->setTitle("");
-    boardBox->setStyleSheet(R"(
-        QGroupBox {
-            border: 2px solid rgb(0, 225, 255);
-            border-radius: 5px;
-            margin-top: 10px;
-            background-color: rgba(0, 0, 0, 150);
-        }
-    )");
-
-
-    // grille à l’intérieur de la boîte
-    QGridLayout *grid = new QGridLayout(boardBox);
-    grid->setSpacing(0);
-    grid->setContentsMargins(0,0,0,0);
-
-    int rows = static_cast<int>(board.size());
-    int cols = static_cast<int>(board.empty() ? 0 : board[0].size());
-    for (int y = 0; y < rows; ++y) {
-        for (int x = 0; x < cols; ++x) {
-            QLabel *cell = new QLabel(boardBox);
-            cell->setMargin(0);
-            cell->setContentsMargins(0, 0, 0, 0);
-            cell->setAlignment(Qt::AlignCenter);
-            cell->setText("");
-            // Si la cellule est activée (valeur non nulle), on lui applique une couleur de fond
-            if (board[y][x] != 0) {
-                cell->setStyleSheet(QString("background-color: %1; margin: 0; padding: 0;"
-                                            "border: 2px solid rgb(0, 180, 200);"
-                                            "border-radius: 5px;")
-                                        .arg(colorForValue(board[y][x]).name()));
-            } else {
-                // Cellule inactive : fond transparent
-                cell->setStyleSheet("background-color: transparent; margin: 0; padding: 0;");
-            }
-            grid->addWidget(cell, y, x);
-        }
-    }
-    mainLayout->addWidget(boardBox);
+    // 3) Le plateau (GAME OVER et NO OPPONENT sont dessinés par le BoardWidget)
+    board->setParent(container);
+    mainLayout->addWidget(board);
 
     return container;
 }
@@ -1,5 +1,6 @@
 
 #include "GameScreenGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 GameScreen::GameScreen(Config &config, ClientSession &session, QWidget *parent) : QWidget(parent), 
@@ -41,8 +42,12 @@ void GameScreen::setupUi()
     mainLayout->addLayout(rightColLayout,  1);
 
     // Prepare dynamic widgets
-    oppBoardWidget  = renderBoard(opponentBoard, true,  false, this);
-    mainBoardWidget = renderBoard(playerBoard,   false, false, this);
+    oppBoard  = new BoardWidget(true,  this);
+    mainBoard = new BoardWidget(false, this);
+    oppBoard->setBoard(opponentBoard);
+    mainBoard->setBoard(playerBoard);
+    oppBoardWidget  = renderBoard(oppBoard,  true,  this);
+    mainBoardWidget = renderBoard(mainBoard, false, this);
 
     statsWidget    = renderBox("Stats",       renderStats(0,  0,   0, this), this);
     holdWidget     = renderBox("Hold",        renderPiece(PieceType::I, 4, 4, this), this);
@@ -68,8 +73,13 @@ void GameScreen::setupUi()
     opponentNameLabel->setMaximumWidth(500);
     opponentNameLabel->setAlignment(Qt::AlignCenter);
 
+    // every opponent at once, shown when the game is a royale
+    miniMap = new MiniMapWidget(opponentContainer);
+    miniMap->hide();
+
     opLayout->addWidget(oppBoardWidget);
     opLayout->addWidget(opponentNameLabel);
+    opLayout->addWidget(miniMap);
 
     // Assemble in left, middle, and right
     leftColLayout->addWidget(opponentContainer);
@@ -138,6 +148,7 @@ void GameScreen::onUpdateTimer()
         auto ps = session.getPlayerState();
         isSpectator = false;
         setupPlayerUI(ps);
+        updateMiniMap(ps);
     } catch (...) {
         try {
             auto ss = session.getSpectatorState();
@@ -151,51 +162,108 @@ void GameScreen::onUpdateTimer()
 
 void GameScreen::setupPlayerUI(const PlayerState &ps)
 {
-    // Update main board
-    auto *nbrd = renderBoard(ps.playerGrid, false, ps.isGameOver, this);
-    replaceWidgetInLayout(middleColLayout, mainBoardWidget, nbrd);
+    // Update boards, only the cells that changed get repainted
+    mainBoard->setBoard(ps.playerGrid);
+    mainBoard->setGameOver(ps.isGameOver);
+    oppBoard->setBoard(ps.targetGrid);
 
-    // Update opponent view & name
+    // Update opponent name
     opponentNameLabel->setText(QString("Spectating : %1").arg(QString::fromStdString(ps.targetUsername)));
-    auto *obrd = renderBoard(ps.targetGrid, true, false, opponentContainer);
-    opponentContainer->layout()->replaceWidget(oppBoardWidget, obrd);
-    oppBoardWidget->deleteLater();
-    oppBoardWidget = obrd;
-
-    // Update right-side panels
-    auto *nstats  = renderBox("Stats",      renderStats(ps.playerScore, ps.playerLevel, ps.playerLines, this), this);
-    auto *nhold   = renderBox("Hold",       renderPiece(ps.holdTetro, 4,4, this),                         this);
-    auto *nnext   = renderBox("Next",       renderPiece(ps.nextTetro, 4,4, this),                         this);
-    auto *nenergy = renderBox("Energy Bar", renderEnergyBar(ps.playerEnergy, MAX_ENERGY, this),               this);
-
-    replaceWidgetInLayout(rightColLayout, statsWidget,   nstats);
-    replaceWidgetInLayout(rightColLayout, holdWidget,    nhold);
-    replaceWidgetInLayout(rightColLayout, nextWidget,    nnext);
-    replaceWidgetInLayout(rightColLayout, energyWidget,  nenergy);
+
+    // Update right-side panels, most frames none of them changed
+    const auto &shown = shownPlayerState;
+    if (!shown || shown->playerScore != ps.playerScore || shown->playerLevel != ps.playerLevel
+        || shown->playerLines != ps.playerLines) {
+        auto *nstats = renderBox("Stats", renderStats(ps.playerScore, ps.playerLevel, ps.playerLines, this), this);
+        replaceWidgetInLayout(rightColLayout, statsWidget, nstats);
+    }
+    if (!shown || shown->holdTetro != ps.holdTetro) {
+        auto *nhold = renderBox("Hold", renderPiece(ps.holdTetro, 4,4, this), this);
+        replaceWidgetInLayout(rightColLayout, holdWidget, nhold);
+    }
+    if (!shown || shown->nextTetro != ps.nextTetro) {
+        auto *nnext = renderBox("Next", renderPiece(ps.nextTetro, 4,4, this), this);
+        replaceWidgetInLayout(rightColLayout, nextWidget, nnext);
+    }
+    if (!shown || shown->playerEnergy != ps.playerEnergy) {
+        auto *nenergy = renderBox("Energy Bar", renderEnergyBar(ps.playerEnergy, MAX_ENERGY, this), this);
+        replaceWidgetInLayout(rightColLayout, energyWidget, nenergy);
+    }
+
+    shownPlayerState = ps;
+}
+
+void GameScreen::updateMiniMap(const PlayerState &ps)
+{
+    // the overview is rebuilt by the server every OVERVIEW_UPDATE_INTERVAL,
+    // no need to ask for it on every frame
+    if (!miniMap || ps.gameMode != GameMode::ROYALE) {
+        return;
+    }
+
+    msSinceOverview += updateTimer->interval();
+    if (msSinceOverview < OVERVIEW_UPDATE_INTERVAL) {
+        return;
+    }
+    msSinceOverview = 0;
+
+    GameOverview overview;
+    if (session.fetchGameOverview(overview) != StatusCode::SUCCESS) {
+        return; // keep the last one
+    }
+
+    miniMap->setOverview(overview, ps.playerUsername, static_cast<int>(ps.playerGrid.size()));
+    miniMap->show();
 }
 
 
 void GameScreen::setupSpectatorUI(const SpectatorState &ss)
+{
+    if (!shownSpectatorState) {
+        buildSpectatorUI();
+    }
+
+    spectatingLabel->setText("SPECTATING : " + QString::fromStdString(ss.playerUsername));
+    spectatedBoard->setBoard(ss.playerGrid);
+    spectatedBoard->setGameOver(ss.isGameOver);
+
+    const auto &shown = shownSpectatorState;
+    if (!shown || shown->holdTetro != ss.holdTetro) {
+        auto *nhold = renderBox("HOLD", renderPiece(ss.holdTetro, 4, 4, this), this);
+        replaceWidgetInLayout(leftColLayout, holdWidget, nhold);
+    }
+    if (!shown || shown->nextTetro != ss.nextTetro) {
+        auto *nnext = renderBox("NEXT", renderPiece(ss.nextTetro, 4, 4, this), this);
+        replaceWidgetInLayout(rightColLayout, nextWidget, nnext);
+    }
+
+    shownSpectatorState = ss;
+}
+
+
+void GameScreen::buildSpectatorUI()
 {
     //qWarning() << "Entering spectator mode";
     clearLayout(leftColLayout);
     clearLayout(middleColLayout);
     clearLayout(rightColLayout);
+    miniMap = nullptr; // went with the opponent container
 
     // Titre principal en haut (milieu)
-    QLabel *title = new QLabel("SPECTATING : " + QString::fromStdString(ss.playerUsername), this);
-    title->setStyleSheet("color: rgb(0,225,255); font-size:24px; font-weight:bold;");
-    title->setAlignment(Qt::AlignHCenter | Qt::AlignTop);
-    title->setFixedHeight(50);
-    title->setMaximumWidth(500);
-    applyDropShadow(title);
+    spectatingLabel = new QLabel("SPECTATING", this);
+    spectatingLabel->setStyleSheet("color: rgb(0,225,255); font-size:24px; font-weight:bold;");
+    spectatingLabel->setAlignment(Qt::AlignHCenter | Qt::AlignTop);
+    spectatingLabel->setFixedHeight(50);
+    spectatingLabel->setMaximumWidth(500);
+    applyDropShadow(spectatingLabel);
 
     // Board
-    auto *nbrd = renderBoard(ss.playerGrid, false, ss.isGameOver, this);
+    spectatedBoard = new BoardWidget(false, this);
+    auto *nbrd = renderBoard(spectatedBoard, false, this);
 
-    // Hold / Next
-    auto *hold   = renderBox("HOLD", renderPiece(ss.holdTetro, 4, 4, this), this);
-    auto *next   = renderBox("NEXT", renderPiece(ss.nextTetro, 4, 4, this), this);
+    // Hold / Next (filled by setupSpectatorUI)
+    holdWidget = renderBox("HOLD", renderPiece(PieceType::None, 4, 4, this), this);
+    nextWidget = renderBox("NEXT", renderPiece(PieceType::None, 4, 4, this), this);
 
     // Noms des joueurs et flèches
     QLabel *prevLabel = new QLabel(" ← Previous Opponent", this);
@@ -220,11 +288,11 @@ void GameScreen::setupSpectatorUI(const SpectatorState &ss)
     leftColLayout->addWidget(prevLabel);
     leftColLayout->addWidget(prevUsername);
     leftColLayout->addSpacerItem(new QSpacerItem(0, 20));
-    leftColLayout->addWidget(hold);
+    leftColLayout->addWidget(holdWidget);
     leftColLayout->setContentsMargins(170, 0, 90, 170);
 
     // MIDDLE: Title + board
-    middleColLayout->addWidget(title);
+    middleColLayout->addWidget(spectatingLabel);
     middleColLayout->addSpacerItem(new QSpacerItem(0, 20));
     middleColLayout->addWidget(nbrd);
 
@@ -232,7 +300,7 @@ void GameScreen::setupSpectatorUI(const SpectatorState &ss)
     rightColLayout->addWidget(nextLabel);
     rightColLayout->addWidget(nextUsername);
     rightColLayout->addSpacerItem(new QSpacerItem(0, 20));
-    rightColLayout->addWidget(next);
+    rightColLayout->addWidget(nextWidget);
     rightColLayout->setContentsMargins(0, 0, 290, 90);
 
     // Exit hint
@@ -301,9 +369,9 @@ void GameScreen::onEscapePressed()
 void GameScreen::paintEvent(QPaintEvent *event)
 {
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap bg(bgPath);
-    QPixmap scaled = bg.scaled(size(), Qt::KeepAspectRatioByExpanding);
+    // decoded and scaled once, see BackgroundCache (this one repaints on
+    // every game frame)
+    const QPixmap &scaled = BackgroundCache::instance().scaled(size(), Qt::KeepAspectRatioByExpanding);
     painter.drawPixmap((width()-scaled.width())/2,
                        (height()-scaled.height())/2,
                        scaled);
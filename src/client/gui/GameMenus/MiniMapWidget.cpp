@@ -0,0 +1,85 @@
+#include "MiniMapWidget.hpp"
+
+#include <algorithm>
+
+
+MiniMapWidget::MiniMapWidget(QWidget *parent) : QWidget(parent) {
+    // no background of our own, the game screen image shows through
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+}
+
+QSize MiniMapWidget::sizeHint() const {
+    const int count = std::max(1, static_cast<int>(opponents.size()));
+    const int rows = (count + BOARDS_PER_ROW - 1) / BOARDS_PER_ROW;
+    const int cols = std::min(count, BOARDS_PER_ROW);
+    return {cols * (TILE_WIDTH + SPACING), rows * (TILE_HEIGHT + NAME_HEIGHT + SPACING)};
+}
+
+void MiniMapWidget::setOverview(const GameOverview &overview, const std::string &ownUsername, int newBoardHeight) {
+    std::vector<BoardOverview> newOpponents;
+    for (const BoardOverview &board : overview.boards) {
+        if (board.username != ownUsername) {
+            newOpponents.push_back(board);
+        }
+    }
+
+    newBoardHeight = std::max(1, newBoardHeight);
+    if (newOpponents == opponents && newBoardHeight == boardHeight) {
+        return;
+    }
+
+    const bool resized = newOpponents.size() != opponents.size();
+    opponents = std::move(newOpponents);
+    boardHeight = newBoardHeight;
+
+    if (resized) {
+        setFixedHeight(sizeHint().height());
+        updateGeometry();
+    }
+    update();
+}
+
+void MiniMapWidget::paintEvent(QPaintEvent *) {
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QFont f = font();
+    f.setPixelSize(NAME_HEIGHT - 2);
+    painter.setFont(f);
+
+    for (int i = 0; i < static_cast<int>(opponents.size()); ++i) {
+        const BoardOverview &board = opponents[i];
+        const int left = (i % BOARDS_PER_ROW) * (TILE_WIDTH + SPACING);
+        const int top = (i / BOARDS_PER_ROW) * (TILE_HEIGHT + NAME_HEIGHT + SPACING);
+
+        // same frame as the boards, grayed out once the opponent lost
+        const QColor accent = board.isGameOver ? QColor(110, 110, 110) : QColor(0, 225, 255);
+
+        painter.setPen(accent);
+        painter.drawText(QRect(left, top, TILE_WIDTH, NAME_HEIGHT), Qt::AlignCenter,
+                         QString::fromStdString(board.username));
+
+        const QRect tile(left, top + NAME_HEIGHT, TILE_WIDTH, TILE_HEIGHT);
+        painter.setPen(QPen(accent, 1));
+        painter.setBrush(QColor(0, 0, 0, 150));
+        painter.drawRoundedRect(QRectF(tile).adjusted(0.5, 0.5, -0.5, -0.5), 4, 4);
+
+        const std::vector<int> heights = GameOverview::decodeSkyline(board.skyline);
+        if (heights.empty()) {
+            continue;
+        }
+
+        const QRect inner = tile.adjusted(3, 3, -3, -3);
+        const int barWidth = std::max(1, inner.width() / static_cast<int>(heights.size()));
+        const int barsLeft = inner.left() + (inner.width() - barWidth * static_cast<int>(heights.size())) / 2;
+
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(accent);
+        for (int x = 0; x < static_cast<int>(heights.size()); ++x) {
+            const int h = std::min(heights[x], boardHeight) * inner.height() / boardHeight;
+            if (h > 0) {
+                painter.drawRect(barsLeft + x * barWidth, inner.bottom() + 1 - h, barWidth - 1, h);
+            }
+        }
+    }
+}
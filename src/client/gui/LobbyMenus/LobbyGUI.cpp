@@ -1,5 +1,6 @@
 
 #include "LobbyGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 std::string getGameModeString(GameMode mode) {
@@ -36,9 +37,8 @@ void Lobby::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
 
     // Draw the background image
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QMainWindow::paintEvent(event);
 }
@@ -1,5 +1,6 @@
 
 #include "LoginScreenGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 LoginScreen::LoginScreen(ClientSession &session, QWidget *parent) : QWidget(parent), session(session){
@@ -94,10 +95,8 @@ void LoginScreen::paintEvent(QPaintEvent *event) {
     // Paints the background
 
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QWidget::paintEvent(event);
 }
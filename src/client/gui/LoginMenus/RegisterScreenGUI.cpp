@@ -1,5 +1,6 @@
 
 #include "RegisterScreenGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 RegisterScreen::RegisterScreen(ClientSession &session, QWidget *parent) : QWidget(parent), session(session){
@@ -96,10 +97,8 @@ void RegisterScreen::paintEvent(QPaintEvent *event) {
     // Paints the background
 
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QWidget::paintEvent(event);
 }
@@ -0,0 +1,31 @@
+#include "BackgroundCache.hpp"
+
+
+void BackgroundCache::preload() {
+    if (source.isNull()) {
+        source.load(BACKGROUND_PATH);
+    }
+}
+
+const QPixmap& BackgroundCache::scaled(const QSize &size, Qt::AspectRatioMode mode) {
+    const auto key = std::make_tuple(size.width(), size.height(), static_cast<int>(mode));
+
+    auto it = scaledCopies.find(key);
+    if (it != scaledCopies.end()) {
+        return it->second;
+    }
+
+    // first paint at this size (new screen, or the window was resized)
+    preload();
+    if (scaledCopies.size() >= MAX_SCALED_COPIES) {
+        scaledCopies.clear();
+    }
+
+    QPixmap copy = source.isNull() ? QPixmap() : source.scaled(size, mode, Qt::SmoothTransformation);
+    return scaledCopies.emplace(key, std::move(copy)).first->second;
+}
+
+void BackgroundCache::clear() {
+    scaledCopies.clear();
+    source = QPixmap();
+}
@@ -1,5 +1,6 @@
 
 #include "FriendsListWidget.hpp"
+#include "BackgroundCache.hpp"
 
 
 FriendsList::FriendsList(ClientSession &session,QWidget *parent) : QMainWindow(parent),session(session)
@@ -53,20 +54,43 @@ FriendsList::FriendsList(ClientSession &session,QWidget *parent) : QMainWindow(p
     
     (void) session.fetchPlayerData();
     populateFriends();  
+    // friend list changes and new messages are pushed by the db server, the
+    // callback runs on the session thread so we bounce it to the gui thread
+    notificationSubscription = session.subscribeNotifications([this](const Notification &notification) {
+        QMetaObject::invokeMethod(this, [this, notification]() {
+            handleNotification(notification);
+        }, Qt::QueuedConnection);
+    });
+
+    // the online / in game status of friends lives on the game server, that's
+    // the only thing left to poll here
     refreshTimer = new QTimer(this);
-    connect(refreshTimer, &QTimer::timeout, this, [this, &session]() {
-        QLayoutItem *item;
-        while ((item = friendsListLayout->takeAt(0)) != nullptr) {
-            delete item->widget();
-            delete item;
-        }
-        (void) session.fetchPlayerData();
+    connect(refreshTimer, &QTimer::timeout, this, [this]() {
         populateFriends();
-        createBottomLayout();
     });
     refreshTimer->start(5000); 
 }
 
+FriendsList::~FriendsList() {
+    // once this returns, the session won't call our callback anymore
+    session.unsubscribeNotifications(notificationSubscription);
+}
+
+void FriendsList::handleNotification(const Notification &notification) {
+    if (notification.type == "message") {
+        // the session already synced the conversation, just show it
+        if (refreshChat && notification.fromID == chatFriendID) {
+            refreshChat();
+        }
+        return;
+    }
+
+    // friend request / accept / decline / remove, or a friend's new name
+    (void) session.fetchPlayerData();
+    populateFriends();
+    createBottomLayout();
+}
+
 void FriendsList::createSearchBar() {
     QWidget *searchBarWidget = new QWidget(this);
     searchBarWidget->setStyleSheet("border: none; background-color: transparent;");
@@ -135,37 +159,56 @@ void FriendsList::showChat(const QString &friendName) {
     inputLayout->addWidget(sendButton);
     chatLayout->addLayout(inputLayout);
 
-    connect(sendButton, &QPushButton::clicked, this, [this, messageInput, friendID]() {
-        QString message = messageInput->text();
-        if (!message.isEmpty()) {
-            (void) session.sendMessage(friendID, message.toStdString());
-            messageInput->clear();
-        }
-    });
-
     // Safe pointer to avoid dangling pointer issues
     QPointer<QListWidget> safeMessageList = messageList;
 
-    messageTimer = new QTimer(this);
-    connect(messageTimer, &QTimer::timeout, this, [this, friendID, safeMessageList]() {
+    // the session keeps the conversation cached, so we only have to append
+    // what we haven't shown yet instead of rebuilding the whole list
+    auto shownMessages = std::make_shared<std::size_t>(0);
+
+    auto appendNewMessages = [this, friendID, safeMessageList, shownMessages]() {
         if (!safeMessageList) return;
 
-        std::vector<ChatMessage> messages = session.getPlayerMessages(friendID);
+        const std::vector<ChatMessage> messages = session.getConversation(friendID);
         if (messages.empty()) {
-            if (safeMessageList->count() == 0) {
+            if (*shownMessages > 0 || safeMessageList->count() == 0) {
+                safeMessageList->clear();
                 safeMessageList->addItem("No messages yet.");
+                *shownMessages = 0;
             }
-        } else {
+            return;
+        }
+
+        if (*shownMessages == 0 || messages.size() < *shownMessages) {
+            // first messages (or the cache got reset), drop the placeholder
             safeMessageList->clear();
-            // oldest message on top
-            for (auto it = messages.rbegin(); it != messages.rend(); ++it) {
-                QString msgText = QString::fromStdString(it->from + ":" + it->text);
-                safeMessageList->addItem(msgText);
+            *shownMessages = 0;
+        }
 
-            }
+        // oldest message on top
+        for (std::size_t i = *shownMessages; i < messages.size(); ++i) {
+            safeMessageList->addItem(QString::fromStdString(messages[i].from + ":" + messages[i].text));
+        }
+        if (messages.size() > *shownMessages) {
+            safeMessageList->scrollToBottom();
+        }
+        *shownMessages = messages.size();
+    };
+
+    connect(sendButton, &QPushButton::clicked, this, [this, messageInput, friendID, appendNewMessages]() {
+        QString message = messageInput->text();
+        if (!message.isEmpty()) {
+            (void) session.sendMessage(friendID, message.toStdString());
+            messageInput->clear();
+            appendNewMessages();
         }
     });
-    messageTimer->start(100);
+
+    (void) session.syncMessages(friendID);
+    appendNewMessages();
+
+    chatFriendID = friendID;
+    refreshChat = appendNewMessages;
 
     chatWidget->show();
     mainLayout->addWidget(chatWidget);
@@ -218,8 +261,7 @@ void FriendsList::createBottomLayout(){
     }
 }
 
-void FriendsList::addFriendWidget(const QString &friendName) {
-    ClientStatus status = session.getClientStatus(friendName.toStdString());
+void FriendsList::addFriendWidget(const QString &friendName, ClientStatus status) {
     FriendWidget::State state;
 
     switch (status) {
@@ -302,8 +344,17 @@ void FriendsList::populateFriends() {
 
     std::vector<std::string> &Friendslist = session.getFriendList();
 
+    std::vector<std::string> usernames;
+    usernames.reserve(Friendslist.size());
     for (const auto &id : Friendslist) {
-        addFriendWidget(QString::fromStdString(session.getFriendUsername(id)));
+        usernames.push_back(session.getFriendUsername(id));
+    }
+
+    // one request for the whole list instead of one per friend
+    std::unordered_map<std::string, ClientStatus> statuses = session.getClientStatuses(usernames);
+
+    for (const auto &username : usernames) {
+        addFriendWidget(QString::fromStdString(username), statuses[username]);
     }
 }
 
@@ -315,9 +366,8 @@ void FriendsList::sendInvite(const std::string &friendID) {
 
 void FriendsList::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap backgroundPixmap(bgPath);
-    painter.drawPixmap(this->rect(), backgroundPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QMainWindow::paintEvent(event);
 }
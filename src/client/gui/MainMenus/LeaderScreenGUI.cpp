@@ -1,5 +1,6 @@
 
 #include "LeaderScreenGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 LeaderScreen::LeaderScreen(MainMenu *mainMenuView, ClientSession &session, QWidget *parent) : QWidget(parent), mainMenu(mainMenuView),session(session){
@@ -74,6 +75,21 @@ LeaderScreen::LeaderScreen(MainMenu *mainMenuView, ClientSession &session, QWidg
     
         table->setItem(i, 0, new QTableWidgetItem(QString::fromStdString(player.name)));
         table->setItem(i, 1, new QTableWidgetItem(QString::number(player.score)));
+        table->setVerticalHeaderItem(i, new QTableWidgetItem(QString::number(player.rank)));
+    }
+
+    // if we're not in the top, show where we are (and who is right next to us)
+    for (const auto &player : session.getLeaderboardAroundMe()) {
+        const bool alreadyShown = std::any_of(leaderboard.begin(), leaderboard.end(),
+            [&player](const PlayerScore &top) { return top.name == player.name; });
+        if (alreadyShown) continue;
+
+        const int row = table->rowCount();
+        table->insertRow(row);
+
+        table->setItem(row, 0, new QTableWidgetItem(QString::fromStdString(player.name)));
+        table->setItem(row, 1, new QTableWidgetItem(QString::number(player.score)));
+        table->setVerticalHeaderItem(row, new QTableWidgetItem(QString::number(player.rank)));
     }
     
     backToMainButton = new QPushButton("Back to main menu", this);
@@ -95,9 +111,8 @@ void LeaderScreen::paintEvent(QPaintEvent *event) {
     // Paints the background
 
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QWidget::paintEvent(event);
 }
@@ -1,5 +1,6 @@
 
 #include "MainMenuGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 MainMenu::MainMenu(ClientSession &session, QWidget *parent) : QWidget(parent), session(session) {
@@ -49,19 +50,31 @@ MainMenu::MainMenu(ClientSession &session, QWidget *parent) : QWidget(parent), s
     connect(settingsButton, &QPushButton::clicked, this, &MainMenu::openSettings);
     connect(leaderboardButton, &QPushButton::clicked, this, &MainMenu::openLeaderboard);
 
+    // the lobby server can end the session (this client was unreachable for
+    // too long), the callback runs on the session thread
+    notificationSubscription = session.subscribeNotifications([this](const Notification &notification) {
+        if (notification.type != "session_expired") {
+            return;
+        }
+        QMetaObject::invokeMethod(this, [this]() {
+            QMessageBox::information(nullptr, "Session expired", "You were logged out, please log in again.");
+            backToLogin();
+        }, Qt::QueuedConnection);
+    });
 
     setLayout(mainLayout);
     setWindowTitle("Main Menu");
 }
 
-MainMenu::~MainMenu() {}
+MainMenu::~MainMenu() {
+    // once this returns, the session won't call our callback anymore
+    session.unsubscribeNotifications(notificationSubscription);
+}
 
 void MainMenu::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QWidget::paintEvent(event);
 }
@@ -104,14 +117,18 @@ void MainMenu::openLeaderboard(){
 
 void MainMenu::logout() {
     if(session.endSession() == StatusCode::SUCCESS){
-        if (FriendsListManager::instance().friendsListWindow) {
-            FriendsListManager::instance().friendsListWindow->close();
-        }
-        // Ouvrir ici le menu LOGIN
-        LoginScreen *loginScreen = new LoginScreen(session);
-        loginScreen->showMaximized();
+        backToLogin();
+    }
+}
 
-        this->close();
+void MainMenu::backToLogin() {
+    if (FriendsListManager::instance().friendsListWindow) {
+        FriendsListManager::instance().friendsListWindow->close();
     }
+    // Ouvrir ici le menu LOGIN
+    LoginScreen *loginScreen = new LoginScreen(session);
+    loginScreen->showMaximized();
+
+    this->close();
 }
 
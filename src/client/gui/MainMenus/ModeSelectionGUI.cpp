@@ -1,5 +1,6 @@
 
 #include "ModeSelectionGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 ModeSelection::ModeSelection(ClientSession &session, MainMenu* mainMenuView, QWidget *parent) : QWidget(parent), mainMenu(mainMenuView), session(session){
@@ -67,10 +68,8 @@ ModeSelection::ModeSelection(ClientSession &session, MainMenu* mainMenuView, QWi
 
 void ModeSelection::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QWidget::paintEvent(event);
 }
@@ -1,5 +1,6 @@
 
 #include "SettingsMenuGUI.hpp"
+#include "BackgroundCache.hpp"
 
 
 SettingsScreen::SettingsScreen(MainMenu* mainMenuView, QWidget *parent): QWidget(parent), mainMenu(mainMenuView){
@@ -103,10 +104,8 @@ SettingsScreen::SettingsScreen(MainMenu* mainMenuView, QWidget *parent): QWidget
 
 void SettingsScreen::paintEvent(QPaintEvent *event) {
     QPainter painter(this);
-    QString bgPath = QString(TETRIS_ASSETS_DIR) + "/tetris_main.png";
-    QPixmap screenPixmap(bgPath);
-    
-    painter.drawPixmap(this->rect(), screenPixmap);
+    // decoded and scaled once, see BackgroundCache
+    painter.drawPixmap(0, 0, BackgroundCache::instance().scaled(size()));
 
     QWidget::paintEvent(event);
 }
@@ -79,6 +79,52 @@ Element renderEnergyBar(const int energy) {
     });
 }
 
+// Render the opponents' skylines, each column is a bar made of eighth blocks
+Element renderMiniMap(const GameOverview &overview, const std::string &ownUsername, const int boardHeight) {
+    constexpr int miniMapRows = 4;
+    constexpr int boardsPerLine = 4;
+    static const std::vector<std::string> levels = {" ", "▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+    const int height = std::max(boardHeight, 1);
+
+    Elements lines;
+    Elements boards;
+    for (const BoardOverview &board: overview.boards) {
+        if (board.username == ownUsername) {
+            continue;
+        }
+
+        const std::vector<int> heights = GameOverview::decodeSkyline(board.skyline);
+
+        Elements rows;
+        for (int row = miniMapRows - 1; row >= 0; --row) {
+            std::string line;
+            for (const int h: heights) {
+                const int scaled = std::min(h, height) * miniMapRows * 8 / height;
+                line += levels[std::clamp(scaled - row * 8, 0, 8)];
+            }
+            rows.push_back(text(line));
+        }
+
+        boards.push_back(window(text(board.username) | bold, vbox(rows))
+                         | color(board.isGameOver ? Color::GrayDark : Color::Cyan));
+
+        if (static_cast<int>(boards.size()) == boardsPerLine) {
+            lines.push_back(hbox(boards));
+            boards.clear();
+        }
+    }
+
+    if (!boards.empty()) {
+        lines.push_back(hbox(boards));
+    }
+    if (lines.empty()) {
+        lines.push_back(text("No opponents") | center);
+    }
+
+    return window(text("OPPONENTS") | bold | color(Color::White), vbox(lines));
+}
+
 // Render a tetromino preview (hold/next)
 Element renderPiece(PieceType type, const int height, const int width) {
     // Initialize an empty canvas grid
@@ -189,24 +235,63 @@ void showGameScreen(ClientSession &session, Config &config) {
     auto screen = ScreenInteractive::TerminalOutput();
     currentScreen = ScreenState::Exit;
 
-    // Track player view (for cycling through opponents)
-    bool isSpectator = false;
+    // everything that talks to the game server happens on the feed thread,
+    // the renderer and the key handlers below only read its last frame or
+    // queue work for it, so they never wait on the network
+    GameStateFeed feed(session, [&screen] {
+        screen.PostEvent(Event::Custom);
+    });
+
+    std::mutex messageMutex;
     std::string errorMessage;
+    std::atomic<ClientStatus> status{ClientStatus::IN_GAME};
+    std::atomic_bool leaving{false};
+    std::atomic_bool leftGame{false};
     constexpr bool darkMode = false;
 
+    auto setErrorMessage = [&](const std::string &message) {
+        std::lock_guard lock(messageMutex);
+        errorMessage = message;
+    };
+
     // Check player status to determine if we're already in a game
-    ClientStatus status = session.getOwnStatus();
-    if (status != ClientStatus::IN_GAME) {
-        errorMessage = "Not in game! Current status: " + std::to_string(static_cast<int>(status));
-    }
+    feed.post([&](ClientSession &s) {
+        status = s.getOwnStatus();
+        if (status != ClientStatus::IN_GAME) {
+            setErrorMessage("Not in game! Current status: " + std::to_string(static_cast<int>(status.load())));
+        }
+    });
 
-    // Create a renderer with continuous polling
+    // Create a renderer fed by the feed thread
     const Component empty = Container::Vertical({});
     const auto renderer = Renderer(empty, [&] {
-        // Try to get player state first
-        try {
-            const PlayerState state = session.getPlayerState();
-            isSpectator = false;
+        const GameFrame frame = feed.getFrame();
+
+        std::string message;
+        {
+            std::lock_guard lock(messageMutex);
+            message = errorMessage;
+        }
+        if (message.empty() && frame.lastError != StatusCode::SUCCESS && frame.sequence != 0) {
+            message = "Command failed: " + getStatusCodeString(frame.lastError);
+        }
+
+        if (frame.sequence == 0) {
+            // nothing received yet
+            // Check if we're in game at all
+            const ClientStatus currentStatus = status;
+            if (currentStatus != ClientStatus::IN_GAME) {
+                return vbox({
+                           text("Not in game - Status: " + std::to_string(static_cast<int>(currentStatus))),
+                           text("Press Esc to return to menu")
+                       }) | center | border;
+            }
+
+            return text("Waiting for game state...") | center | border;
+        }
+
+        if (!frame.isSpectator) {
+            const PlayerState &state = frame.playerState;
 
             // main game board & opponent view
             auto mainBoard = renderBoard(state.playerGrid, darkMode, false, state.isGameOver);
@@ -231,8 +316,8 @@ void showGameScreen(ClientSession &session, Config &config) {
             Elements content;
 
             // Add error message if any
-            if (!errorMessage.empty()) {
-                content.push_back(text(errorMessage) | color(Color::Red));
+            if (!message.empty()) {
+                content.push_back(text(message) | color(Color::Red));
             }
 
             // Add main content - centered layout
@@ -261,213 +346,143 @@ void showGameScreen(ClientSession &session, Config &config) {
                 }) | center
             );
 
+            // every other opponent, without cycling through them
+            if (state.gameMode == GameMode::ROYALE && !frame.overview.boards.empty()) {
+                content.push_back(renderMiniMap(frame.overview, state.playerUsername,
+                                                static_cast<int>(state.playerGrid.size())) | center);
+            }
+
             return vbox(content) | border | color(Color::Green);
-        } catch (...) {
-            // If player state fails, try spectator state
-            try {
-                const SpectatorState state = session.getSpectatorState();
-                isSpectator = true;
+        }
 
-                Elements content;
+        const SpectatorState &state = frame.spectatorState;
 
-                // Add error message if any
-                if (!errorMessage.empty()) {
-                    content.push_back(text(errorMessage) | color(Color::Red));
-                }
+        Elements content;
 
-                // Add spectator content
-                content.push_back(text("SPECTATING: " + state.playerUsername) | bold | center);
-                content.push_back(separator());
-
-                // Pieces display
-                auto holdPieceDisplay = renderBox("HOLD", renderPiece(state.holdTetro, 4, 5));
-                auto nextPieceDisplay = renderBox("NEXT", renderPiece(state.nextTetro, 4, 5));
-
-                content.push_back(
-                    hbox({
-                        // Left side - pieces and stats
-                        vbox({
-                            holdPieceDisplay,
-                            nextPieceDisplay,
-                            text("Press Esc to exit") | center
-                        }),
-
-                        // Center - main board
-                        renderBoard(state.playerGrid, darkMode, false, state.isGameOver) 
-                    }) | center
-                );
-
-                return vbox(content) | border;
-            } catch (...) {
-                // If both fail, show waiting message
-                // Check if we're in game at all
-                ClientStatus currentStatus = session.getOwnStatus();
-                if (currentStatus != ClientStatus::IN_GAME) {
-                    return vbox({
-                               text("Not in game - Status: " + std::to_string(static_cast<int>(currentStatus))),
-                               text("Press Esc to return to menu")
-                           }) | center | border;
-                }
+        // Add error message if any
+        if (!message.empty()) {
+            content.push_back(text(message) | color(Color::Red));
+        }
 
-                return text("Waiting for game state...") | center | border;
-            }
+        // Add spectator content
+        content.push_back(text("SPECTATING: " + state.playerUsername) | bold | center);
+        content.push_back(separator());
+
+        // Pieces display
+        auto holdPieceDisplay = renderBox("HOLD", renderPiece(state.holdTetro, 4, 5));
+        auto nextPieceDisplay = renderBox("NEXT", renderPiece(state.nextTetro, 4, 5));
+
+        content.push_back(
+            hbox({
+                // Left side - pieces and stats
+                vbox({
+                    holdPieceDisplay,
+                    nextPieceDisplay,
+                    text("Press Esc to exit") | center
+                }),
+
+                // Center - main board
+                renderBoard(state.playerGrid, darkMode, false, state.isGameOver)
+            }) | center
+        );
+
+        if (state.gameMode == GameMode::ROYALE && !frame.overview.boards.empty()) {
+            content.push_back(renderMiniMap(frame.overview, state.playerUsername,
+                                            static_cast<int>(state.playerGrid.size())) | center);
         }
+
+        return vbox(content) | border;
     });
 
+    // key -> action, the key strokes are only queued here
+    const std::vector<std::pair<std::vector<Event>, Action>> keyBindings = {
+        {{Event::ArrowLeft, Event::Character(config.get("MoveLeft"))}, Action::MoveLeft},
+        {{Event::ArrowRight, Event::Character(config.get("MoveRight"))}, Action::MoveRight},
+        {{Event::ArrowDown, Event::Character(config.get("MoveDown"))}, Action::MoveDown},
+        {{Event::Character(config.get("RotateRight"))}, Action::RotateRight},
+        {{Event::Character(config.get("RotateLeft"))}, Action::RotateLeft},
+        {{Event::Character(' '), Event::Character(config.get("InstantFall"))}, Action::InstantFall},
+        {{Event::Character(config.get("UseBag"))}, Action::UseBag},
+        {{Event::Character(config.get("UseBonus"))}, Action::UseBonus},
+        {{Event::Character(config.get("UseMalus"))}, Action::UseMalus},
+        {{Event::Character(config.get("SeePreviousOpponent"))}, Action::SeePreviousOpponent},
+        {{Event::Character(config.get("SeeNextOpponent"))}, Action::SeeNextOpponent},
+    };
+
     // Add key event handler
     auto rendererWithKeys = CatchEvent(renderer, [&](Event event) {
-        // Only handle keys if not in spectator mode
-        if (isSpectator) {
-            if (event == Event::Escape) {
-                StatusCode result = session.leaveLobby();
-                if (result == StatusCode::SUCCESS) {
-                    currentScreen = ScreenState::MainMenu;
-                    screen.Exit();
-                } else {
-                    errorMessage = "Failed to leave lobby: " + getStatusCodeString(result);
-                }
+        // the feed thread is done leaving, we can go
+        if (event == Event::Custom) {
+            if (leftGame) {
+                currentScreen = ScreenState::MainMenu;
+                screen.Exit();
                 return true;
             }
             return false;
         }
 
-        // Game controls for player mode
-        if (event == Event::ArrowLeft || event == Event::Character(config.get("MoveLeft"))) {
-            StatusCode result = session.sendKeyStroke(Action::MoveLeft);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::ArrowRight || event == Event::Character(config.get("MoveRight"))) {
-            StatusCode result = session.sendKeyStroke(Action::MoveRight);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::ArrowDown || event == Event::Character(config.get("MoveDown"))) {
-            StatusCode result = session.sendKeyStroke(Action::MoveDown);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("RotateRight"))) {
-            StatusCode result = session.sendKeyStroke(Action::RotateRight);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("RotateLeft"))) {
-            StatusCode result = session.sendKeyStroke(Action::RotateLeft);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(' ') || event == Event::Character(config.get("InstantFall"))) {
-            StatusCode result = session.sendKeyStroke(Action::InstantFall);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("UseBag"))) {
-            StatusCode result = session.sendKeyStroke(Action::UseBag);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("UseBonus"))) {
-            StatusCode result = session.sendKeyStroke(Action::UseBonus);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("UseMalus"))) {
-            StatusCode result = session.sendKeyStroke(Action::UseMalus);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("SeePreviousOpponent"))) {
-            StatusCode result = session.sendKeyStroke(Action::SeePreviousOpponent);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
-            }
-            return true;
-        }
-        if (event == Event::Character(config.get("SeeNextOpponent"))) {
-            StatusCode result = session.sendKeyStroke(Action::SeeNextOpponent);
-            if (result != StatusCode::SUCCESS) {
-                errorMessage = "Command failed: " + getStatusCodeString(result);
+        if (event == Event::Escape) {
+            if (leaving.exchange(true)) {
+                return true;
             }
-            return true;
-        }
 
-        if (event == Event::Escape) {
-            // Check current status to determine if we're in lobby or game
-            ClientStatus currentStatus = session.getOwnStatus();
-            if (currentStatus == ClientStatus::IN_GAME) {
-                const PlayerState state = session.getPlayerState();
-                if (state.gameMode == GameMode::ENDLESS) {
-                    // update score if solo
-                    int currentScore = state.playerScore;
-                    int bestScore = session.getBestScore();
-                    if (currentScore > bestScore) {
-                        StatusCode postScoreResult = session.postScore(currentScore);
-                        if (postScoreResult != StatusCode::SUCCESS) {
-                            errorMessage = "Failed to update score: " + getStatusCodeString(postScoreResult);
-                        } else {
-                            session.setBestScore(currentScore);
+            // leaving needs the server, it is done on the feed thread
+            const bool isSpectator = feed.getFrame().isSpectator;
+            feed.post([&, isSpectator](ClientSession &s) {
+                StatusCode result = StatusCode::SUCCESS;
+
+                if (isSpectator) {
+                    result = s.leaveLobby();
+                } else if (s.getOwnStatus() == ClientStatus::IN_GAME) {
+                    // Check current status to determine if we're in lobby or game
+                    const PlayerState state = feed.getFrame().playerState;
+                    if (state.gameMode == GameMode::ENDLESS) {
+                        // update score if solo
+                        int currentScore = state.playerScore;
+                        int bestScore = s.getBestScore();
+                        if (currentScore > bestScore) {
+                            StatusCode postScoreResult = s.postScore(currentScore);
+                            if (postScoreResult != StatusCode::SUCCESS) {
+                                setErrorMessage("Failed to update score: " + getStatusCodeString(postScoreResult));
+                            } else {
+                                s.setBestScore(currentScore);
+                            }
                         }
                     }
+                    result = s.leaveGame();
                 }
-                StatusCode result = session.leaveGame();
+
                 if (result == StatusCode::SUCCESS) {
-                    currentScreen = ScreenState::MainMenu;
-                    screen.Exit();
+                    leftGame = true;
                 } else {
-                    errorMessage = "Failed to leave lobby: " + getStatusCodeString(result);
+                    setErrorMessage("Failed to leave lobby: " + getStatusCodeString(result));
+                    leaving = false;
                 }
-            } else {
-                currentScreen = ScreenState::MainMenu;
-                screen.Exit();
-            }
+                screen.PostEvent(Event::Custom);
+            });
             return true;
         }
 
-        return false;
-    });
+        // Only handle keys if not in spectator mode
+        if (feed.getFrame().isSpectator) {
+            return false;
+        }
 
-    // Controlled polling
-    std::atomic_bool running{true};
-    std::mutex mtx;
-    std::condition_variable cv;
-
-    // Start the polling thread
-    std::thread pollingThread([&screen, &running, &mtx, &cv] {
-        std::unique_lock lock(mtx);
-        while (running) {
-            // Wait for 50ms or until notified
-            if (cv.wait_for(lock, std::chrono::milliseconds(50)) == std::cv_status::timeout) {
-                screen.PostEvent(Event::Custom);
+        // Game controls for player mode
+        for (const auto &[events, action]: keyBindings) {
+            if (std::ranges::find(events, event) != events.end()) {
+                feed.sendAction(action);
+                return true;
             }
         }
+
+        return false;
     });
 
     // Main event loop
+    feed.start();
     screen.Loop(rendererWithKeys);
 
-    // After exiting the loop, signal the polling thread to stop.
-    running = false;
-    cv.notify_all();
-    if (pollingThread.joinable()) {
-        pollingThread.join();
-    }
+    // After exiting the loop, stop the feed thread.
+    feed.stop();
 }
@@ -55,14 +55,9 @@ void showMainMenu(ClientSession &session) {
     auto sendMessageButton = Button("Send", [&] {
         if (!messageInput.empty() && !friendList.empty()) {
             const std::string recipient = friendList[selectedFriendIndex];
+            // sending also pulls the message back into the session cache
             (void) session.sendMessage(recipient, messageInput);
             messageInput.clear();
-
-            // Poll multiple times after sending to ensure message appears (magic numbers, sorta)
-            for (int i = 0; i < 3; i++) {
-                (void) session.getPlayerMessages(recipient);
-                std::this_thread::sleep_for(std::chrono::milliseconds(50));
-            }
         }
     });
 
@@ -187,10 +182,16 @@ void showMainMenu(ClientSession &session) {
                 if (friendList.empty()) {
                     friendElements.push_back(text("You have no friends yet"));
                 } else {
+                    // we get the usernames from the friendIDs, then all their
+                    // statuses in one request
+                    std::vector<std::string> friendUsernames;
                     for (const auto &friendID: friendList) {
-                        // we get the username from the friendID and it's status
-                        std::string friendUsername = session.getFriendUsername(friendID);
-                        std::string status = getClientStatusString(session.getClientStatus(friendUsername));
+                        friendUsernames.push_back(session.getFriendUsername(friendID));
+                    }
+                    auto statuses = session.getClientStatuses(friendUsernames);
+
+                    for (const auto &friendUsername: friendUsernames) {
+                        std::string status = getClientStatusString(statuses[friendUsername]);
                         friendElements.push_back(
                             hbox({
                                 text(friendUsername),
@@ -234,7 +235,8 @@ void showMainMenu(ClientSession &session) {
                 } else {
                     const std::string selectedFriendID = friendList[selectedFriendIndex];
                     const std::string friendUsername   = friendNames[selectedFriendIndex];
-                    std::vector<ChatMessage> messages = session.getPlayerMessages(selectedFriendID);
+                    // render from the cache, the polling thread keeps it in sync
+                    std::vector<ChatMessage> messages = session.getConversation(selectedFriendID);
 
                     Elements messageElements;
                     if (messages.empty()) {
@@ -303,38 +305,39 @@ void showMainMenu(ClientSession &session) {
     });
 
     std::atomic_bool running{true};
+    std::atomic_bool friendsDirty{false};
     std::mutex mtx;
     std::condition_variable cv;
 
-    // Counters for polling intervals
-    int fetchDataCounter = 0;
-    int fetchMessageCounter = 0;
-    constexpr int FETCH_DATA_INTERVAL = 100; // ~5000ms (100 * 50ms)
-    constexpr int FETCH_MESSAGE_INTERVAL = 5; // ~250ms (5 * 50ms)
+    // new messages and friend list changes are pushed by the db server, so
+    // the refresh thread only has to hit the network when something happened
+    const int subscription = session.subscribeNotifications([&](const Notification &notification) {
+        if (notification.type == "session_expired") {
+            // the lobby server ended our session, log in again
+            screen.Post([&] {
+                currentScreen = ScreenState::Login;
+                screen.Exit();
+            });
+            return;
+        }
+        if (notification.type != "message") {
+            friendsDirty = true;
+        }
+        cv.notify_all();
+    });
 
-    std::thread pollingThread([&] {
+    std::thread refreshThread([&] {
         std::unique_lock lock(mtx);
         while (running) {
-            if (activeTab == 2 && !friendList.empty()) {
-                fetchMessageCounter++;
-
-                if (fetchMessageCounter >= FETCH_MESSAGE_INTERVAL) {
-                    std::string selectedFriend = friendList[selectedFriendIndex];
-                    (void) session.getPlayerMessages(selectedFriend);
-                    fetchMessageCounter = 0;
-                }
+            if (friendsDirty.exchange(false)) {
+                (void) session.fetchPlayerData();
+            }
 
-                if (selectedFriendIndex != previousFriendIndex) {
-                    std::string selectedFriend = friendList[selectedFriendIndex];
-                    (void) session.getPlayerMessages(selectedFriend);
-                    previousFriendIndex = selectedFriendIndex;
-                }
-            } else {
-                fetchDataCounter++;
-                if (fetchDataCounter >= FETCH_DATA_INTERVAL) {
-                    (void) session.fetchPlayerData();
-                    fetchDataCounter = 0;
-                }
+            // a conversation we never opened isn't in the cache yet
+            if (activeTab == 2 && !friendList.empty() && selectedFriendIndex != previousFriendIndex) {
+                std::string selectedFriend = friendList[selectedFriendIndex];
+                (void) session.syncMessages(selectedFriend);
+                previousFriendIndex = selectedFriendIndex;
             }
 
             screen.PostEvent(Event::Custom);
@@ -345,10 +348,11 @@ void showMainMenu(ClientSession &session) {
     // Main loop
     screen.Loop(renderer);
 
-    // Cleanup polling thread
+    // Cleanup refresh thread
+    session.unsubscribeNotifications(subscription);
     running = false;
     cv.notify_all();
-    if (pollingThread.joinable()) {
-        pollingThread.join();
+    if (refreshThread.joinable()) {
+        refreshThread.join();
     }
 }
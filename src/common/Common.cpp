@@ -10,6 +10,8 @@ getStatusCodeString(StatusCode code) {
             return "SUCCESS";
         case StatusCode::SUCCESS_REPLACED_SESSION:
             return "SUCCESS_REPLACED_SESSION";
+        case StatusCode::SUCCESS_NOT_MODIFIED:
+            return "SUCCESS_NOT_MODIFIED";
         case StatusCode::ERROR:
             return "ERROR";
         case StatusCode::ERROR_CREATING_SOCKET:
@@ -86,6 +88,10 @@ getStatusCodeString(StatusCode code) {
 std::string
 getServerMethodString(const ServerMethods method) {
     switch (method) {
+        case ServerMethods::GET_CLIENT_STATUS:
+            return "GET_CLIENT_STATUS";
+        case ServerMethods::GET_CLIENT_STATUSES:
+            return "GET_CLIENT_STATUSES";
         case ServerMethods::GET_CURRENT_LOBBY:
             return "GET_CURRENT_LOBBY";
         case ServerMethods::LEAVE_LOBBY:
@@ -96,8 +102,12 @@ getServerMethodString(const ServerMethods method) {
             return "UNREADY";
         case ServerMethods::GET_GAME_STATE:
             return "GET_GAME_STATE";
+        case ServerMethods::GET_GAME_OVERVIEW:
+            return "GET_GAME_OVERVIEW";
         case ServerMethods::KEY_STROKE:
             return "KEY_STROKE";
+        case ServerMethods::LEAVE_GAME:
+            return "LEAVE_GAME";
         case ServerMethods::START_SESSION:
             return "START_SESSION";
         case ServerMethods::END_SESSION:
@@ -112,6 +122,8 @@ getServerMethodString(const ServerMethods method) {
             return "JOIN_LOBBY";
         case ServerMethods::SPECTATE_LOBBY:
             return "SPECTATE_LOBBY";
+        case ServerMethods::HEARTBEAT:
+            return "HEARTBEAT";
         case ServerMethods::NONE:
             return "NONE";
         default:
@@ -0,0 +1,191 @@
+#include "Fragmentation.hpp"
+
+#include <random>
+
+#include <arpa/inet.h>
+
+std::string
+FragmentHeader::serialize() const {
+    // magic, then the fields in network byte order
+    std::string header(SIZE, '\0');
+
+    header[0] = static_cast<char>(FRAGMENT_MAGIC);
+    for (int i = 0; i < 4; ++i) {
+        header[static_cast<std::size_t>(1 + i)] =
+            static_cast<char>((messageID >> (8 * (3 - i))) & 0xFF);
+    }
+    header[5] = static_cast<char>((index >> 8) & 0xFF);
+    header[6] = static_cast<char>(index & 0xFF);
+    header[7] = static_cast<char>((count >> 8) & 0xFF);
+    header[8] = static_cast<char>(count & 0xFF);
+
+    return header;
+}
+
+std::optional<FragmentHeader>
+FragmentHeader::deserialize(const char *data, const std::size_t length) {
+    // nothing if this datagram is not a fragment
+
+    if (length < SIZE || static_cast<unsigned char>(data[0]) != FRAGMENT_MAGIC) {
+        return std::nullopt;
+    }
+
+    const auto byte = [data](const std::size_t i) {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(data[i]));
+    };
+
+    FragmentHeader header;
+    header.messageID = (byte(1) << 24) | (byte(2) << 16) | (byte(3) << 8) | byte(4);
+    header.index = static_cast<std::uint16_t>((byte(5) << 8) | byte(6));
+    header.count = static_cast<std::uint16_t>((byte(7) << 8) | byte(8));
+
+    return header;
+}
+
+FragmentWriter::FragmentWriter() {
+    // random first ID, so the fragments of a restarted sender are not taken
+    // for the ones of a message it sent before
+    std::random_device rd;
+    nextMessageID = static_cast<std::uint32_t>(rd());
+}
+
+std::vector<std::string>
+FragmentWriter::split(const std::string &message) {
+    // this method is used to cut a message in datagrams of at most
+    // MAX_DATAGRAM_SIZE bytes
+
+    constexpr std::size_t datagramSize = static_cast<std::size_t>(MAX_DATAGRAM_SIZE);
+    if (message.size() <= datagramSize) {
+        return {message};
+    }
+
+    constexpr std::size_t chunkSize = datagramSize - FragmentHeader::SIZE;
+    const std::size_t count = (message.size() + chunkSize - 1) / chunkSize;
+    if (count > FragmentHeader::MAX_FRAGMENTS) {
+        return {};
+    }
+
+    FragmentHeader header;
+    header.messageID = nextMessageID++;
+    header.count = static_cast<std::uint16_t>(count);
+
+    std::vector<std::string> datagrams;
+    datagrams.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        header.index = static_cast<std::uint16_t>(i);
+        datagrams.push_back(header.serialize() + message.substr(i * chunkSize, chunkSize));
+    }
+
+    return datagrams;
+}
+
+StatusCode
+FragmentWriter::send(const int socket, const std::string &message,
+                     const sockaddr *address, const socklen_t addressLength) {
+    // this method is used to send a whole message, in as many datagrams as
+    // needed
+
+    const std::vector<std::string> datagrams = split(message);
+    if (datagrams.empty()) {
+        return StatusCode::ERROR_SENDING_REQUEST; // too big
+    }
+
+    for (const std::string &datagram: datagrams) {
+        const ssize_t sentLen = sendto(socket, datagram.data(), datagram.size(), 0,
+                                       address, addressLength);
+        if (sentLen < 0) {
+            return StatusCode::ERROR_SENDING_REQUEST;
+        }
+    }
+
+    return StatusCode::SUCCESS;
+}
+
+std::optional<std::string>
+FragmentReader::feed(const std::string &sender, const char *data,
+                     const std::size_t length) {
+    // this method is used to give a received datagram to the reader. a whole
+    // message comes back as it is, a fragment is kept until the others arrive
+
+    const std::optional<FragmentHeader> header = FragmentHeader::deserialize(data, length);
+    if (!header) {
+        return std::string(data, length);
+    }
+
+    // a fragment that makes no sense is dropped
+    if (header->count == 0 || header->count > FragmentHeader::MAX_FRAGMENTS ||
+        header->index >= header->count) {
+        return std::nullopt;
+    }
+
+    std::lock_guard lock(partialsMutex);
+
+    const auto key = std::make_pair(sender, header->messageID);
+    auto it = partials.find(key);
+    if (it == partials.end()) {
+        if (partials.size() >= MAX_PARTIAL_MESSAGES) {
+            return std::nullopt; // too many messages on the way, the sender will retry
+        }
+
+        PartialMessage partial;
+        partial.fragments.resize(header->count);
+        partial.received.resize(header->count, false);
+        partial.deadline = Clock::now() + std::chrono::milliseconds(FRAGMENT_TIMEOUT_MS);
+        it = partials.emplace(key, std::move(partial)).first;
+    }
+
+    PartialMessage &partial = it->second;
+    if (partial.fragments.size() != header->count || partial.received[header->index]) {
+        return std::nullopt; // duplicated (a retry), or not the same message
+    }
+
+    partial.fragments[header->index].assign(data + FragmentHeader::SIZE,
+                                            length - FragmentHeader::SIZE);
+    partial.received[header->index] = true;
+    partial.size += length - FragmentHeader::SIZE;
+
+    if (++partial.receivedCount < partial.fragments.size()) {
+        return std::nullopt;
+    }
+
+    // every fragment is here
+    std::string message;
+    message.reserve(partial.size);
+    for (const std::string &fragment: partial.fragments) {
+        message += fragment;
+    }
+
+    partials.erase(it);
+    return message;
+}
+
+void
+FragmentReader::expire() {
+    // this method is used to drop the messages that will never be complete
+    // (a fragment got lost)
+
+    std::lock_guard lock(partialsMutex);
+    const Clock::time_point now = Clock::now();
+
+    for (auto it = partials.begin(); it != partials.end();) {
+        if (now >= it->second.deadline) {
+            it = partials.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::size_t
+FragmentReader::pendingCount() const {
+    std::lock_guard lock(partialsMutex);
+    return partials.size();
+}
+
+std::string
+FragmentReader::senderKey(const sockaddr_in &address) {
+    // ip:port of the sender
+    char ip[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &address.sin_addr, ip, sizeof(ip));
+    return std::string(ip) + ":" + std::to_string(ntohs(address.sin_port));
+}
@@ -0,0 +1,91 @@
+#include "GameOverview.hpp"
+
+#include <algorithm>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+std::string
+GameOverview::encodeSkyline(const tetroMat &board) {
+    // the board rows go from the top (0) to the bottom, so the height of a
+    // column is given by the first row that has a block in it
+
+    const std::size_t rows = board.size();
+    const std::size_t columns = board.empty() ? 0 : board[0].size();
+
+    std::string skyline(columns, SKYLINE_DIGITS[0]);
+    for (std::size_t x = 0; x < columns; ++x) {
+        for (std::size_t y = 0; y < rows; ++y) {
+            if (x < board[y].size() && board[y][x] != 0) {
+                skyline[x] = SKYLINE_DIGITS[std::min(rows - y, MAX_SKYLINE_HEIGHT)];
+                break;
+            }
+        }
+    }
+
+    return skyline;
+}
+
+std::vector<int>
+GameOverview::decodeSkyline(const std::string &skyline) {
+    // unknown characters count as an empty column
+
+    const std::string digits(SKYLINE_DIGITS);
+
+    std::vector<int> heights;
+    heights.reserve(skyline.size());
+    for (const char c: skyline) {
+        const std::size_t height = digits.find(c);
+        heights.push_back(height == std::string::npos ? 0 : static_cast<int>(height));
+    }
+
+    return heights;
+}
+
+std::string
+GameOverview::serialize() const {
+    // serialize the overview, the usernames are cut so that the size only
+    // depends on the number of boards
+
+    nlohmann::json j = nlohmann::json::array();
+    for (const BoardOverview &board: boards) {
+        j.push_back({
+            {"username", board.username.substr(0, OVERVIEW_NAME_LENGTH)},
+            {"skyline", board.skyline},
+            {"isGameOver", board.isGameOver},
+        });
+    }
+
+    return j.dump();
+}
+
+GameOverview
+GameOverview::deserialize(const std::string &data) {
+    // deserialize the overview
+    nlohmann::json j;
+
+    try {
+        j = nlohmann::json::parse(data);
+    } catch (nlohmann::json::parse_error &e) {
+        throw std::runtime_error(
+            "[error] Parsing failed while deserializing GameOverview: " +
+            std::string(e.what()));
+    }
+
+    GameOverview overview;
+
+    try {
+        for (const nlohmann::json &board: j) {
+            overview.boards.push_back({
+                board.at("username").get<std::string>(),
+                board.at("skyline").get<std::string>(),
+                board.at("isGameOver").get<bool>(),
+            });
+        }
+    } catch (nlohmann::json::exception &e) {
+        throw std::runtime_error(
+            "[error] Unknown json error while deserializing GameOverview: " +
+            std::string(e.what()));
+    }
+
+    return overview;
+}
@@ -103,6 +103,13 @@ PlayerState::serialize() const {
     j["targetGrid"] = targetGrid;
     j["isGameOver"] = isGameOver;
     j["gameMode"] = gameMode;
+    j["currentTetro"] = currentTetro;
+    j["currentX"] = currentPosition.x;
+    j["currentY"] = currentPosition.y;
+    j["currentShape"] = currentShape;
+    j["lastInputSequence"] = lastInputSequence;
+    j["controlsReversed"] = controlsReversed;
+    j["controlsBlocked"] = controlsBlocked;
     return j.dump();
 }
 
@@ -139,6 +146,14 @@ PlayerState::deserialize(const std::string &data) {
         state.targetGrid = j["targetGrid"].get<tetroMat>();
         state.isGameOver = j["isGameOver"].get<bool>();
         state.gameMode = j["gameMode"].get<GameMode>();
+
+        // optional, older servers don't send them
+        state.currentTetro = j.value("currentTetro", PieceType::None);
+        state.currentPosition = {j.value("currentX", 0), j.value("currentY", 0)};
+        state.currentShape = j.value("currentShape", tetroShape());
+        state.lastInputSequence = j.value("lastInputSequence", 0);
+        state.controlsReversed = j.value("controlsReversed", false);
+        state.controlsBlocked = j.value("controlsBlocked", false);
     } catch (nlohmann::json::exception &e) {
         throw std::runtime_error(
             "[error] Unknown json error while deserializing PlayerState: " +
@@ -7,6 +7,7 @@ KeyStrokePacket::serialize() const {
 
     j["action"] = action;
     j["token"] = token;
+    j["sequence"] = sequence;
 
     return j.dump();
 }
@@ -35,6 +36,7 @@ KeyStrokePacket::deserialize(const std::string &data) {
     try {
         packet.action = static_cast<Action>(j["action"].get<int>());
         packet.token = j["token"].get<std::string>();
+        packet.sequence = j.value("sequence", 0);
     } catch (nlohmann::json::exception &e) {
         throw std::runtime_error(
             "[error] Unknown json error while deserializing KeyStrokePacket: " +
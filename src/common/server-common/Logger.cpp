@@ -0,0 +1,295 @@
+#include "Logger.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <iomanip>
+
+Logger::Logger()
+    : slots(std::make_unique<Slot[]>(CAPACITY)), output(&std::cout),
+      dropped(MetricsRegistry::instance().counter(
+          "tetris_log_dropped_total", "Log records dropped because the log buffer was full")) {
+    for (std::size_t position = 0; position < CAPACITY; ++position) {
+        slots[position].sequence.store(position, std::memory_order_relaxed);
+    }
+    for (std::atomic<int> &level: levels) {
+        level.store(static_cast<int>(MessageType::INFO), std::memory_order_relaxed);
+    }
+
+    writerThread = std::thread(&Logger::writerLoop, this);
+}
+
+Logger::~Logger() {
+    // the writer drains what is left before it stops
+    stopping.store(true, std::memory_order_release);
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+bool
+Logger::enabled(const MessageType level, const LogComponent component) const {
+    if (level == MessageType::NONE) {
+        return false;
+    }
+
+    const auto index = static_cast<std::size_t>(component);
+    // records without a component follow the lowest level of all
+    if (index >= levels.size()) {
+        int lowest = static_cast<int>(MessageType::NONE);
+        for (const std::atomic<int> &componentLevel: levels) {
+            lowest = std::min(lowest, componentLevel.load(std::memory_order_relaxed));
+        }
+        return static_cast<int>(level) >= lowest;
+    }
+
+    return static_cast<int>(level) >= levels[index].load(std::memory_order_relaxed);
+}
+
+void
+Logger::setLevel(const MessageType level) {
+    for (std::atomic<int> &componentLevel: levels) {
+        componentLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+}
+
+void
+Logger::setLevel(const LogComponent component, const MessageType level) {
+    const auto index = static_cast<std::size_t>(component);
+    if (index < levels.size()) {
+        levels[index].store(static_cast<int>(level), std::memory_order_relaxed);
+    }
+}
+
+void
+Logger::setFormat(const LogFormat format) {
+    this->format.store(format, std::memory_order_relaxed);
+}
+
+void
+Logger::setOutput(std::ostream &output) {
+    // everything logged before goes to the old output
+    flush();
+    std::lock_guard lock(outputMutex);
+    this->output = &output;
+}
+
+void
+Logger::flush() {
+    // the records claimed before now are written once the writer has gone
+    // past them and flushed its batch (a producer in the middle of its copy
+    // is waited for too)
+    const std::size_t target = enqueuePosition.load(std::memory_order_acquire);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+
+    while (writtenPosition.load(std::memory_order_acquire) < target &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+std::uint64_t
+Logger::droppedRecords() const {
+    return dropped.value();
+}
+
+std::optional<MessageType>
+Logger::parseLevel(const std::string &name) {
+    if (name == "debug") return MessageType::DEBUG;
+    if (name == "info") return MessageType::INFO;
+    if (name == "warning") return MessageType::WARNING;
+    if (name == "error") return MessageType::ERROR;
+    if (name == "critical") return MessageType::CRITICAL;
+    if (name == "off") return MessageType::NONE;
+    return std::nullopt;
+}
+
+std::optional<LogComponent>
+Logger::parseComponent(const std::string &name) {
+    if (name == "master") return LogComponent::MASTER_SERVER;
+    if (name == "tetris-server") return LogComponent::TETRIS_SERVER;
+    if (name == "lobby-server") return LogComponent::LOBBY_SERVER;
+    if (name == "lobby") return LogComponent::LOBBY;
+    if (name == "game-server") return LogComponent::GAME_SERVER;
+    if (name == "game") return LogComponent::GAME;
+    return std::nullopt;
+}
+
+// ==================================================== //
+//                      Ring buffer                     //
+// ==================================================== //
+
+Logger::Slot *
+Logger::claim(std::size_t &position) {
+    position = enqueuePosition.load(std::memory_order_relaxed);
+
+    while (true) {
+        Slot &slot = slots[position & (CAPACITY - 1)];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) -
+                                static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0) {
+            // free : try to take it (on failure, position is reloaded)
+            if (enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                      std::memory_order_relaxed)) {
+                return &slot;
+            }
+        } else if (difference < 0) {
+            // the writer did not get there yet : full
+            return nullptr;
+        } else {
+            // someone else took it first
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void
+Logger::publish(Slot *slot, const std::size_t position) {
+    slot->sequence.store(position + 1, std::memory_order_release);
+}
+
+bool
+Logger::writeNext(std::string &batch) {
+    // only called by the writer thread, no one else takes from the queue
+    const std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    Slot &slot = slots[position & (CAPACITY - 1)];
+
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+        return false;
+    }
+
+    formatRecord(slot.record, batch);
+
+    slot.sequence.store(position + CAPACITY, std::memory_order_release);
+    dequeuePosition.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+// ==================================================== //
+//                        Writer                        //
+// ==================================================== //
+
+static const char *
+levelName(const MessageType level) {
+    switch (level) {
+        case MessageType::DEBUG:
+            return "DEBUG";
+        case MessageType::INFO:
+            return "INFO";
+        case MessageType::WARNING:
+            return "WARNING";
+        case MessageType::ERROR:
+            return "ERROR";
+        case MessageType::CRITICAL:
+            return "CRITICAL";
+        default:
+            return "UNKNOWN";
+    }
+}
+
+static const char *
+componentName(const LogComponent component) {
+    switch (component) {
+        case LogComponent::MASTER_SERVER:
+            return "master";
+        case LogComponent::TETRIS_SERVER:
+            return "tetris-server";
+        case LogComponent::LOBBY_SERVER:
+            return "lobby-server";
+        case LogComponent::LOBBY:
+            return "lobby";
+        case LogComponent::GAME_SERVER:
+            return "game-server";
+        case LogComponent::GAME:
+            return "game";
+        default:
+            return "none";
+    }
+}
+
+// 2026-01-01T12:00:00.000Z
+static std::string
+formatTime(const std::chrono::system_clock::time_point time) {
+    const std::time_t seconds = std::chrono::system_clock::to_time_t(time);
+    const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  time.time_since_epoch()).count() % 1000;
+
+    std::tm utc{};
+    gmtime_r(&seconds, &utc);
+
+    std::ostringstream out;
+    out << std::put_time(&utc, "%Y-%m-%dT%H:%M:%S") << '.'
+        << std::setw(3) << std::setfill('0') << milliseconds << 'Z';
+    return out.str();
+}
+
+void
+Logger::formatRecord(Record &record, std::string &batch) const {
+    std::string message;
+    record.render(record.payload.data(), message);
+    record.render = nullptr;
+
+    if (format.load(std::memory_order_relaxed) == LogFormat::JSON) {
+        nlohmann::json line = {
+            {"time", formatTime(record.time)},
+            {"level", levelName(record.level)},
+            {"component", componentName(record.component)},
+            {"message", message},
+        };
+        if (!record.context.empty()) {
+            line["context"] = record.context;
+        }
+        // the text comes from the clients too : never fail on bad UTF-8
+        batch += line.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+    } else {
+        batch += formatTime(record.time);
+        batch += " [";
+        batch += componentName(record.component);
+        if (!record.context.empty()) {
+            batch += '-';
+            batch += record.context;
+        }
+        batch += "] [";
+        batch += levelName(record.level);
+        batch += "] ";
+        batch += message;
+    }
+    batch += '\n';
+}
+
+void
+Logger::writerLoop() {
+    std::string batch;
+
+    while (true) {
+        // read before draining : once stopping is seen, one last pass
+        // empties the queue
+        const bool lastPass = stopping.load(std::memory_order_acquire);
+
+        std::size_t written = 0;
+        while (written < MAX_BATCH && writeNext(batch)) {
+            ++written;
+        }
+
+        if (!batch.empty()) {
+            // one write and one flush for the whole batch
+            std::lock_guard lock(outputMutex);
+            output->write(batch.data(), static_cast<std::streamsize>(batch.size()));
+            output->flush();
+            batch.clear();
+        }
+        writtenPosition.store(dequeuePosition.load(std::memory_order_relaxed),
+                              std::memory_order_release);
+
+        if (written == MAX_BATCH) {
+            continue;
+        }
+        if (lastPass) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_WAIT_MS));
+    }
+}
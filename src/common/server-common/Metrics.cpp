@@ -0,0 +1,264 @@
+#include "Metrics.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+// ==================================================== //
+//                   Counter / Gauge                    //
+// ==================================================== //
+
+void
+Counter::increment(const std::uint64_t amount) {
+    count.fetch_add(amount, std::memory_order_relaxed);
+}
+
+std::uint64_t
+Counter::value() const {
+    return count.load(std::memory_order_relaxed);
+}
+
+void
+Gauge::set(const std::int64_t newValue) {
+    current.store(newValue, std::memory_order_relaxed);
+}
+
+void
+Gauge::add(const std::int64_t amount) {
+    current.fetch_add(amount, std::memory_order_relaxed);
+}
+
+std::int64_t
+Gauge::value() const {
+    return current.load(std::memory_order_relaxed);
+}
+
+// ==================================================== //
+//                      Histogram                       //
+// ==================================================== //
+
+std::size_t
+Histogram::bucketOf(const std::uint64_t value) {
+    // the first SUB_BUCKETS values have a bucket each, then every power of
+    // two [2^m, 2^(m+1)) is cut in SUB_BUCKETS buckets of 2^(m-4) values
+
+    if (value < SUB_BUCKETS) {
+        return static_cast<std::size_t>(value);
+    }
+
+    const int magnitude = static_cast<int>(std::bit_width(value)) - 1;
+    const int shift = magnitude - SUB_BUCKET_BITS;
+    const std::uint64_t subBucket = (value >> shift) - SUB_BUCKETS;
+    const std::size_t bucket = static_cast<std::size_t>(
+        SUB_BUCKETS + static_cast<std::uint64_t>(shift) * SUB_BUCKETS + subBucket);
+
+    return std::min(bucket, BUCKETS - 1);
+}
+
+std::uint64_t
+Histogram::highestValueOf(const std::size_t bucket) {
+    if (bucket < SUB_BUCKETS) {
+        return bucket;
+    }
+
+    const std::uint64_t shift = (bucket - SUB_BUCKETS) / SUB_BUCKETS;
+    const std::uint64_t subBucket = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+    return ((SUB_BUCKETS + subBucket + 1) << shift) - 1;
+}
+
+void
+Histogram::record(const std::uint64_t microseconds) {
+    buckets[bucketOf(microseconds)].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+    sumOfValues.fetch_add(microseconds, std::memory_order_relaxed);
+}
+
+void
+Histogram::record(const std::chrono::steady_clock::duration duration) {
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    record(static_cast<std::uint64_t>(std::max<std::int64_t>(0, microseconds)));
+}
+
+std::uint64_t
+Histogram::count() const {
+    return total.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::sum() const {
+    return sumOfValues.load(std::memory_order_relaxed);
+}
+
+std::uint64_t
+Histogram::quantile(const double q) const {
+    // the buckets keep moving while we read them, the answer is only as
+    // exact as the snapshot
+    const std::uint64_t count = this->count();
+    if (count == 0) {
+        return 0;
+    }
+
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return highestValueOf(bucket);
+        }
+    }
+    return highestValueOf(BUCKETS - 1);
+}
+
+ScopedTimer::ScopedTimer(Histogram &histogram)
+    : histogram(histogram), start(std::chrono::steady_clock::now()) {
+}
+
+ScopedTimer::~ScopedTimer() {
+    histogram.record(std::chrono::steady_clock::now() - start);
+}
+
+// ==================================================== //
+//                   MetricsRegistry                    //
+// ==================================================== //
+
+template<typename T>
+T &
+MetricsRegistry::getOrAdd(std::map<std::string, Family<T>> &families,
+                          const std::string &name, const std::string &help,
+                          const std::string &labels) {
+    std::lock_guard lock(registryMutex);
+
+    Family<T> &family = families[name];
+    if (family.help.empty()) {
+        family.help = help;
+    }
+
+    std::unique_ptr<T> &metric = family.series[labels];
+    if (!metric) {
+        metric = std::make_unique<T>();
+    }
+    return *metric;
+}
+
+Counter &
+MetricsRegistry::counter(const std::string &name, const std::string &help,
+                         const std::string &labels) {
+    return getOrAdd(counters, name, help, labels);
+}
+
+Gauge &
+MetricsRegistry::gauge(const std::string &name, const std::string &help,
+                       const std::string &labels) {
+    return getOrAdd(gauges, name, help, labels);
+}
+
+Histogram &
+MetricsRegistry::histogram(const std::string &name, const std::string &help,
+                           const std::string &labels) {
+    return getOrAdd(histograms, name, help, labels);
+}
+
+// name{labels,extra}, without the braces if there is no label at all
+static std::string
+seriesName(const std::string &name, const std::string &labels,
+           const std::string &extra = "") {
+    std::string all = labels;
+    if (!extra.empty()) {
+        all += (all.empty() ? "" : ",") + extra;
+    }
+    return all.empty() ? name : name + "{" + all + "}";
+}
+
+std::string
+MetricsRegistry::render() const {
+    std::lock_guard lock(registryMutex);
+    std::ostringstream out;
+    // sums in seconds, down to the microsecond
+    out << std::setprecision(15);
+
+    for (const auto &[name, family]: counters) {
+        out << "# HELP " << name << ' ' << family.help << '\n'
+            << "# TYPE " << name << " counter\n";
+        for (const auto &[labels, counter]: family.series) {
+            out << seriesName(name, labels) << ' ' << counter->value() << '\n';
+        }
+    }
+
+    for (const auto &[name, family]: gauges) {
+        out << "# HELP " << name << ' ' << family.help << '\n'
+            << "# TYPE " << name << " gauge\n";
+        for (const auto &[labels, gauge]: family.series) {
+            out << seriesName(name, labels) << ' ' << gauge->value() << '\n';
+        }
+    }
+
+    // microseconds in, seconds out
+    auto seconds = [](const std::uint64_t microseconds) {
+        return static_cast<double>(microseconds) / 1e6;
+    };
+
+    for (const auto &[name, family]: histograms) {
+        out << "# HELP " << name << ' ' << family.help << '\n'
+            << "# TYPE " << name << " summary\n";
+        for (const auto &[labels, histogram]: family.series) {
+            for (const double q: QUANTILES) {
+                std::ostringstream quantileLabel;
+                quantileLabel << "quantile=\"" << q << '"';
+                out << seriesName(name, labels, quantileLabel.str()) << ' ';
+                // nothing recorded yet : no quantile at all
+                if (histogram->count() == 0) {
+                    out << "NaN\n";
+                } else {
+                    out << seconds(histogram->quantile(q)) << '\n';
+                }
+            }
+            out << seriesName(name + "_sum", labels) << ' ' << seconds(histogram->sum()) << '\n'
+                << seriesName(name + "_count", labels) << ' ' << histogram->count() << '\n';
+        }
+    }
+
+    return out.str();
+}
+
+// ==================================================== //
+//                    RequestMetrics                    //
+// ==================================================== //
+
+RequestMetrics::RequestMetrics()
+    : bytesIn(MetricsRegistry::instance().counter(
+          "tetris_udp_received_bytes_total", "Bytes received by the lobby and game servers")),
+      bytesOut(MetricsRegistry::instance().counter(
+          "tetris_udp_sent_bytes_total", "Bytes sent by the lobby and game servers")),
+      deserializeFailures(MetricsRegistry::instance().counter(
+          "tetris_udp_deserialize_failures_total", "Requests that could not be deserialized")) {
+    for (std::size_t method = 0; method < durations.size(); ++method) {
+        durations[method] = &MetricsRegistry::instance().histogram(
+            "tetris_request_duration_seconds", "Time to handle a request, per method",
+            "method=\"" + getServerMethodString(static_cast<ServerMethods>(method)) + "\"");
+    }
+}
+
+void
+RequestMetrics::received(const std::size_t bytes) {
+    bytesIn.increment(bytes);
+}
+
+void
+RequestMetrics::sent(const std::size_t bytes) {
+    bytesOut.increment(bytes);
+}
+
+void
+RequestMetrics::deserializeFailed() {
+    deserializeFailures.increment();
+}
+
+Histogram &
+RequestMetrics::duration(const ServerMethods method) {
+    const auto index = static_cast<std::size_t>(method);
+    return *durations[std::min(index, durations.size() - 1)];
+}
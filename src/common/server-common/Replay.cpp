@@ -0,0 +1,345 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <unordered_map>
+#include <utility>
+
+static constexpr std::string_view REPLAY_MAGIC = "TRRP";
+static constexpr std::uint8_t REPLAY_VERSION = 2; // 2 : effects applied at the end of the tick
+
+// ==================================================== //
+//                       Decoding                       //
+// ==================================================== //
+
+namespace {
+
+// reads the bytes one after the other, anything past the end fails
+class ByteReader
+{
+  public:
+    explicit ByteReader(const std::string_view data) : data(data) {}
+
+    [[nodiscard]] bool atEnd() const {
+        return position >= data.size();
+    }
+
+    [[nodiscard]] std::optional<std::uint8_t> byte() {
+        if (atEnd()) {
+            return std::nullopt;
+        }
+        return static_cast<std::uint8_t>(data[position++]);
+    }
+
+    // 7 bits per byte, lowest first, the high bit set on all but the last
+    [[nodiscard]] std::optional<std::uint64_t> varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const std::optional<std::uint8_t> next = byte();
+            if (!next) {
+                return std::nullopt;
+            }
+            value |= static_cast<std::uint64_t>(*next & 0x7F) << shift;
+            if ((*next & 0x80) == 0) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    [[nodiscard]] std::optional<std::string> string() {
+        const std::optional<std::uint64_t> length = varint();
+        if (!length || *length > data.size() - position) {
+            return std::nullopt;
+        }
+        std::string text(data.substr(position, *length));
+        position += *length;
+        return text;
+    }
+
+    [[nodiscard]] std::optional<ReplayScore> score() {
+        const auto player = varint();
+        const auto score = varint();
+        const auto lines = varint();
+        if (!player || !score || !lines) {
+            return std::nullopt;
+        }
+        return ReplayScore{static_cast<std::uint32_t>(*player), static_cast<int>(*score),
+                           static_cast<int>(*lines)};
+    }
+
+  private:
+    std::string_view data;
+    std::size_t position = 0;
+};
+
+} // namespace
+
+std::optional<Replay>
+Replay::parse(const std::string_view data) {
+    if (!data.starts_with(REPLAY_MAGIC)) {
+        return std::nullopt;
+    }
+    ByteReader reader(data.substr(REPLAY_MAGIC.size()));
+
+    // the header has to be whole
+    const auto version = reader.byte();
+    const auto mode = reader.byte();
+    const auto startTime = reader.varint();
+    const auto playerCount = reader.varint();
+    if (!version || *version != REPLAY_VERSION || !mode || !startTime || !playerCount ||
+        *mode >= static_cast<std::uint8_t>(GameMode::NONE) ||
+        *playerCount > static_cast<std::uint64_t>(MAX_LOBBY_SIZE)) {
+        return std::nullopt;
+    }
+
+    Replay replay;
+    replay.gameMode = static_cast<GameMode>(*mode);
+    replay.startTime = *startTime;
+
+    for (std::uint64_t i = 0; i < *playerCount; ++i) {
+        auto name = reader.string();
+        const auto seed = reader.varint();
+        if (!name || !seed) {
+            return std::nullopt;
+        }
+        replay.players.push_back({std::move(*name), static_cast<std::uint32_t>(*seed)});
+    }
+    for (std::uint64_t i = 0; i < *playerCount; ++i) {
+        const auto index = reader.varint();
+        if (!index || *index >= *playerCount) {
+            return std::nullopt;
+        }
+        replay.tickOrder.push_back(static_cast<std::uint32_t>(*index));
+    }
+
+    // then the records, until the end or the first one that isn't whole
+    std::uint64_t tick = 0;
+    while (!reader.atEnd() && !replay.complete) {
+        const auto type = reader.byte();
+        const auto delta = reader.varint();
+        if (!type || !delta) {
+            break;
+        }
+
+        ReplayEvent event;
+        event.type = static_cast<ReplayEventType>(*type);
+        event.tick = tick + *delta;
+
+        bool whole = true;
+        switch (event.type) {
+            case ReplayEventType::INPUT: {
+                const auto player = reader.varint();
+                const auto action = reader.byte();
+                whole = player && action && *player < *playerCount &&
+                        *action <= static_cast<std::uint8_t>(Action::SeeNextOpponent);
+                if (whole) {
+                    event.player = static_cast<std::uint32_t>(*player);
+                    event.action = static_cast<Action>(*action);
+                }
+                break;
+            }
+            case ReplayEventType::LEAVE: {
+                const auto player = reader.varint();
+                const auto after = reader.varint();
+                const auto score = reader.varint();
+                const auto lines = reader.varint();
+                whole = player && after && score && lines && *player < *playerCount;
+                if (whole) {
+                    event.player = static_cast<std::uint32_t>(*player);
+                    event.after = static_cast<std::uint32_t>(*after);
+                    event.scores.push_back({event.player, static_cast<int>(*score),
+                                            static_cast<int>(*lines)});
+                }
+                break;
+            }
+            case ReplayEventType::END: {
+                const auto count = reader.varint();
+                whole = count && *count <= *playerCount;
+                for (std::uint64_t i = 0; whole && i < *count; ++i) {
+                    const auto score = reader.score();
+                    whole = score && score->player < *playerCount;
+                    if (whole) {
+                        event.scores.push_back(*score);
+                    }
+                }
+                replay.complete = whole;
+                break;
+            }
+            default:
+                whole = false;
+                break;
+        }
+
+        if (!whole) {
+            break;
+        }
+        tick = event.tick;
+        replay.events.push_back(std::move(event));
+    }
+
+    return replay;
+}
+
+// ==================================================== //
+//                       Encoding                       //
+// ==================================================== //
+
+ReplayEncoder::ReplayEncoder(const GameMode gameMode, const std::uint64_t startTime,
+                             const std::vector<ReplayPlayer> &players,
+                             const std::vector<std::uint32_t> &tickOrder) {
+    pending += REPLAY_MAGIC;
+    pending += static_cast<char>(REPLAY_VERSION);
+    pending += static_cast<char>(gameMode);
+    writeVarint(startTime);
+
+    writeVarint(players.size());
+    for (const ReplayPlayer &player: players) {
+        writeVarint(player.name.size());
+        pending += player.name;
+        writeVarint(player.seed);
+    }
+    for (const std::uint32_t index: tickOrder) {
+        writeVarint(index);
+    }
+}
+
+void
+ReplayEncoder::writeVarint(std::uint64_t value) {
+    while (value >= 0x80) {
+        pending += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    pending += static_cast<char>(value);
+}
+
+void
+ReplayEncoder::record(const ReplayEventType type, const std::uint64_t tick) {
+    // the ticks only go forward, a late record is put on the last one
+    const std::uint64_t delta = tick > lastTick ? tick - lastTick : 0;
+    lastTick += delta;
+
+    pending += static_cast<char>(type);
+    writeVarint(delta);
+}
+
+void
+ReplayEncoder::input(const std::uint64_t tick, const std::uint32_t player, const Action action) {
+    record(ReplayEventType::INPUT, tick);
+    writeVarint(player);
+    pending += static_cast<char>(action);
+}
+
+void
+ReplayEncoder::leave(const std::uint64_t tick, const std::uint32_t after,
+                     const ReplayScore &score) {
+    record(ReplayEventType::LEAVE, tick);
+    writeVarint(score.player);
+    writeVarint(after);
+    writeVarint(static_cast<std::uint64_t>(std::max(0, score.score)));
+    writeVarint(static_cast<std::uint64_t>(std::max(0, score.lines)));
+}
+
+void
+ReplayEncoder::end(const std::uint64_t tick, const std::vector<ReplayScore> &scores) {
+    record(ReplayEventType::END, tick);
+    writeVarint(scores.size());
+    for (const ReplayScore &score: scores) {
+        writeVarint(score.player);
+        writeVarint(static_cast<std::uint64_t>(std::max(0, score.score)));
+        writeVarint(static_cast<std::uint64_t>(std::max(0, score.lines)));
+    }
+}
+
+std::string
+ReplayEncoder::take() {
+    return std::exchange(pending, std::string());
+}
+
+// ==================================================== //
+//                        Writer                        //
+// ==================================================== //
+
+ReplayWriter::ReplayWriter() {
+    writerThread = std::thread(&ReplayWriter::writerLoop, this);
+}
+
+ReplayWriter::~ReplayWriter() {
+    // what is left is written before the thread stops
+    {
+        std::lock_guard lock(writerMutex);
+        stopping = true;
+    }
+    wakeUp.notify_one();
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+}
+
+void
+ReplayWriter::setDirectory(const std::string &directory) {
+    std::lock_guard lock(writerMutex);
+    this->directory = directory;
+}
+
+std::string
+ReplayWriter::getDirectory() const {
+    std::lock_guard lock(writerMutex);
+    return directory;
+}
+
+void
+ReplayWriter::append(const std::string &path, std::string bytes, const bool last) {
+    {
+        std::lock_guard lock(writerMutex);
+        chunks.push_back({path, std::move(bytes), last});
+    }
+    wakeUp.notify_one();
+}
+
+void
+ReplayWriter::flush() {
+    std::unique_lock lock(writerMutex);
+    drained.wait(lock, [this] { return chunks.empty() && !writing; });
+}
+
+void
+ReplayWriter::writerLoop() {
+    // the files of the matches being played stay open
+    std::unordered_map<std::string, std::ofstream> files;
+
+    std::unique_lock lock(writerMutex);
+    while (true) {
+        wakeUp.wait(lock, [this] { return stopping || !chunks.empty(); });
+        if (chunks.empty()) {
+            break; // stopping, and nothing left
+        }
+
+        Chunk chunk = std::move(chunks.front());
+        chunks.pop_front();
+        writing = true;
+        lock.unlock();
+
+        std::ofstream &file = files[chunk.path];
+        if (!file.is_open()) {
+            std::error_code error;
+            std::filesystem::create_directories(
+                std::filesystem::path(chunk.path).parent_path(), error);
+            file.open(chunk.path, std::ios::binary | std::ios::app);
+        }
+        if (file) {
+            file.write(chunk.bytes.data(), static_cast<std::streamsize>(chunk.bytes.size()));
+            file.flush();
+        }
+        if (chunk.last) {
+            files.erase(chunk.path);
+        }
+
+        lock.lock();
+        writing = false;
+        if (chunks.empty()) {
+            drained.notify_all();
+        }
+    }
+}
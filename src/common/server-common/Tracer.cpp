@@ -0,0 +1,176 @@
+#include "Tracer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+
+static std::int64_t
+toNanoseconds(const std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+void
+Tracer::start() {
+    {
+        std::lock_guard lock(buffersMutex);
+        // the threads that are gone took nothing with them but their buffer
+        std::erase_if(buffers, [](const std::shared_ptr<ThreadBuffer> &buffer) {
+            return buffer.use_count() == 1;
+        });
+        for (const std::shared_ptr<ThreadBuffer> &buffer: buffers) {
+            std::lock_guard bufferLock(buffer->mutex);
+            buffer->spans.clear();
+            buffer->dropped = 0;
+        }
+    }
+
+    originNs.store(toNanoseconds(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+    enabled.store(true, std::memory_order_release);
+}
+
+void
+Tracer::stop() {
+    enabled.store(false, std::memory_order_release);
+}
+
+Tracer::ThreadBuffer &
+Tracer::localBuffer() {
+    // created the first time a thread records something (or is named).
+    // every game names two threads even if nobody ever traces, so the
+    // buffers of the threads that are gone are dropped here too, not only by
+    // start : those with nothing in them, the others wait for the dump
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard lock(buffersMutex);
+        std::erase_if(buffers, [](const std::shared_ptr<ThreadBuffer> &other) {
+            if (other.use_count() != 1) {
+                return false;
+            }
+            std::lock_guard bufferLock(other->mutex);
+            return other->spans.empty() && other->dropped == 0;
+        });
+        buffer->id = nextThreadID++;
+        buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void
+Tracer::setThreadName(const std::string &name) {
+    ThreadBuffer &buffer = localBuffer();
+    std::lock_guard lock(buffer.mutex);
+    buffer.name = name;
+}
+
+void
+Tracer::record(const char *name, const char *category,
+               const std::chrono::steady_clock::time_point start,
+               const std::chrono::steady_clock::time_point end) {
+    ThreadBuffer &buffer = localBuffer();
+    std::lock_guard lock(buffer.mutex);
+
+    if (buffer.spans.size() >= MAX_SPANS_PER_THREAD) {
+        ++buffer.dropped;
+        return;
+    }
+    if (buffer.spans.empty()) {
+        buffer.spans.reserve(1024);
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+    buffer.spans.push_back({name, category, toNanoseconds(start), duration.count()});
+}
+
+std::size_t
+Tracer::spanCount() const {
+    std::lock_guard lock(buffersMutex);
+    std::size_t count = 0;
+    for (const std::shared_ptr<ThreadBuffer> &buffer: buffers) {
+        std::lock_guard bufferLock(buffer->mutex);
+        count += buffer->spans.size();
+    }
+    return count;
+}
+
+std::string
+Tracer::toChromeJson() const {
+    // "X" events (a start and a duration), in microseconds since start, and
+    // one "M" event per thread for its name
+    const std::int64_t origin = originNs.load(std::memory_order_relaxed);
+    const auto pid = static_cast<int>(getpid());
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    auto separator = [&out, &first] {
+        if (!first) {
+            out << ",\n";
+        }
+        first = false;
+    };
+
+    std::lock_guard lock(buffersMutex);
+    for (const std::shared_ptr<ThreadBuffer> &buffer: buffers) {
+        std::lock_guard bufferLock(buffer->mutex);
+
+        if (!buffer->name.empty()) {
+            separator();
+            out << nlohmann::json{{"name", "thread_name"}, {"ph", "M"}, {"pid", pid},
+                                  {"tid", buffer->id}, {"args", {{"name", buffer->name}}}}
+                       .dump();
+        }
+        if (buffer->dropped > 0) {
+            separator();
+            out << "{\"name\":\"dropped spans\",\"ph\":\"C\",\"pid\":" << pid
+                << ",\"tid\":" << buffer->id << ",\"ts\":0,\"args\":{\"count\":"
+                << buffer->dropped << "}}";
+        }
+
+        // names and categories are literals of ours, nothing to escape
+        for (const Span &span: buffer->spans) {
+            separator();
+            out << "{\"name\":\"" << span.name << "\",\"cat\":\"" << span.category
+                << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << buffer->id
+                << ",\"ts\":" << static_cast<double>(span.startNs - origin) / 1000.0
+                << ",\"dur\":" << static_cast<double>(span.durationNs) / 1000.0 << '}';
+        }
+    }
+
+    out << "]}\n";
+    return out.str();
+}
+
+StatusCode
+Tracer::dump(const std::string &path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        return StatusCode::ERROR;
+    }
+
+    file << toChromeJson();
+    return file ? StatusCode::SUCCESS : StatusCode::ERROR;
+}
+
+const char *
+Tracer::methodName(const ServerMethods method) {
+    // built once, the pointers stay valid
+    static const std::array<std::string, static_cast<std::size_t>(ServerMethods::NONE) + 1> names =
+        [] {
+            std::array<std::string, static_cast<std::size_t>(ServerMethods::NONE) + 1> all;
+            for (std::size_t index = 0; index < all.size(); ++index) {
+                all[index] = getServerMethodString(static_cast<ServerMethods>(index));
+            }
+            return all;
+        }();
+
+    const auto index = static_cast<std::size_t>(method);
+    return names[std::min(index, names.size() - 1)].c_str();
+}
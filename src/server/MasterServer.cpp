@@ -1,8 +1,9 @@
 #include "MasterServer.hpp"
 
 MasterServer::MasterServer(const std::string &_ip, const int _lobbyPort,
-                           const int _DBPort, const bool _debug)
-    : ip(_ip), lobbyPort(_lobbyPort), dbPort(_DBPort), debug(_debug) {
+                           const int _DBPort, const int _maxSessions)
+    : ip(_ip), lobbyPort(_lobbyPort), dbPort(_DBPort),
+      maxSessions(_maxSessions) {
     // constructor for MasterServer
     printMessage("MasterServer created", MessageType::INFO);
 }
@@ -20,7 +21,7 @@ MasterServer::startMasterServer() {
     // return OK if successful, otherwise return ERROR
 
     // Start TetrisServer
-    tetrisServer = std::make_shared<TetrisServer>(ip, lobbyPort, debug);
+    tetrisServer = std::make_shared<TetrisServer>(ip, lobbyPort, maxSessions);
     if (tetrisServer->startTetrisServer() != StatusCode::SUCCESS) {
         // I think both display the error message actually so it can be done
         // this way
@@ -135,35 +136,10 @@ MasterServer::isDBServerRunning() const {
 void
 MasterServer::printMessage(const std::string &message,
                            const MessageType msgtype) const {
-    // print a message to the console
-    // based on the message type, print the message in a certain color
+    // print a message to the console, through the logger (its level
+    // and the one of the master server decide if it is written)
 
-    if (!debug) {
-        return;
-    }
-
-    const std::string senderIdentifier = "[MASTER SERVER] ";
-    std::string msgIdentifier;
-
-    switch (msgtype) {
-        case MessageType::INFO:
-            msgIdentifier = "[INFO] ";
-            break;
-        case MessageType::WARNING:
-            msgIdentifier = "[WARNING] ";
-            break;
-        case MessageType::ERROR:
-            msgIdentifier = "[ERROR] ";
-            break;
-        case MessageType::CRITICAL:
-            msgIdentifier = "[CRITICAL] ";
-            break;
-        default:
-            msgIdentifier = "[UNKNOWN] ";
-            break;
-    }
-
-    std::cout << senderIdentifier << msgIdentifier << message << std::endl;
+    Logger::instance().log(msgtype, LogComponent::MASTER_SERVER, "", message);
 }
 
 void
@@ -178,6 +154,22 @@ MasterServer::handleCommand(const std::string &command) {
         std::cout << "Lobbies: " << countLobbies() << std::endl;
     } else if (command == "games") {
         std::cout << "Games: " << countGames() << std::endl;
+    } else if (command == "metrics") {
+        // what GET /metrics answers
+        std::cout << MetricsRegistry::instance().render() << std::flush;
+    } else if (command == "trace start") {
+        Tracer::instance().start();
+        std::cout << "Tracing" << std::endl;
+    } else if (command.starts_with("trace stop")) {
+        // trace stop [FILE], to open in chrome://tracing or ui.perfetto.dev
+        const std::string path = command.size() > 11 ? command.substr(11) : DEFAULT_TRACE_FILE;
+        Tracer::instance().stop();
+        if (Tracer::instance().dump(path) != StatusCode::SUCCESS) {
+            std::cout << "Could not write " << path << std::endl;
+        } else {
+            std::cout << Tracer::instance().spanCount() << " spans written to " << path
+                      << std::endl;
+        }
     } else {
         std::cout << "Unknown command" << std::endl;
     }
@@ -188,13 +180,57 @@ main(int argc, char *argv[]) {
     // entry point for server stuff
     // create a MasterServer and start it
 
-    // we are not using the arguments for now
-    (void) argc;
-    (void) argv;
+    // TetrisRoyaleMasterServer [--max-sessions N] [--log-level [COMPONENT=]LEVEL]...
+    //                          [--log-json] [--replay-dir DIR | --no-replays]
+    int maxSessions = MAX_SESSIONS;
+    ReplayWriter::instance().setDirectory(REPLAY_DIRECTORY);
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--log-level" && i + 1 < argc) {
+            // "debug" for every component, "game=debug" for one of them
+            const std::string value = argv[++i];
+            const size_t separator = value.find('=');
+            const auto level = Logger::parseLevel(
+                separator == std::string::npos ? value : value.substr(separator + 1));
+            const auto component = separator == std::string::npos
+                                       ? std::optional<LogComponent>(LogComponent::NONE)
+                                       : Logger::parseComponent(value.substr(0, separator));
+            if (!level || !component) {
+                std::cerr << "Invalid value for --log-level" << std::endl;
+                return EXIT_FAILURE;
+            }
+            if (*component == LogComponent::NONE) {
+                Logger::instance().setLevel(*level);
+            } else {
+                Logger::instance().setLevel(*component, *level);
+            }
+        } else if (arg == "--log-json") {
+            Logger::instance().setFormat(LogFormat::JSON);
+        } else if (arg == "--replay-dir" && i + 1 < argc) {
+            ReplayWriter::instance().setDirectory(argv[++i]);
+        } else if (arg == "--no-replays") {
+            ReplayWriter::instance().setDirectory("");
+        } else if (arg == "--max-sessions" && i + 1 < argc) {
+            try {
+                maxSessions = std::stoi(argv[++i]);
+            } catch (const std::exception &) {
+                maxSessions = 0;
+            }
+            if (maxSessions <= 0) {
+                std::cerr << "Invalid value for --max-sessions" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--max-sessions N] [--log-level [COMPONENT=]LEVEL]... [--log-json]"
+                      << " [--replay-dir DIR | --no-replays]"
+                      << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
 
-    constexpr bool DEBUG = true;
     MasterServer masterServer(MASTER_SERVER_IP, LOBBY_SERVER_PORT,
-                              DB_SERVER_PORT, DEBUG);
+                              DB_SERVER_PORT, maxSessions);
     if (masterServer.startMasterServer() != StatusCode::SUCCESS) {
         return EXIT_FAILURE;
     }
@@ -217,7 +253,12 @@ main(int argc, char *argv[]) {
     }
 
     // we are done, close the MasterServer
-    if (masterServer.closeMasterServer() != StatusCode::SUCCESS) {
+    const StatusCode closed = masterServer.closeMasterServer();
+    // the last lines are still in the logger's buffer, the end of the
+    // replays in the replay writer's
+    Logger::instance().flush();
+    ReplayWriter::instance().flush();
+    if (closed != StatusCode::SUCCESS) {
         return EXIT_FAILURE;
     }
 
@@ -0,0 +1,174 @@
+#include "Replay.hpp"
+#include "ReplaySimulator.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Plays the replays the master server recorded (see Replay.hpp) again,
+// headless and as fast as the engine goes, and checks the scores they end
+// with are the ones the server saw. Exits with 1 if one of them is
+// unreadable or doesn't match.
+
+static std::string
+gameModeName(const GameMode gameMode) {
+    switch (gameMode) {
+        case GameMode::CLASSIC:
+            return "CLASSIC";
+        case GameMode::ROYALE:
+            return "ROYALE";
+        case GameMode::DUEL:
+            return "DUEL";
+        case GameMode::ENDLESS:
+            return "ENDLESS";
+        case GameMode::NONE:
+        default:
+            return "NONE";
+    }
+}
+
+// the file as it is on disk, for as long as it is looked at
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string &path) {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+        struct stat info {};
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            size = static_cast<std::size_t>(info.st_size);
+            void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped != MAP_FAILED) {
+                data = static_cast<const char *>(mapped);
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data) {
+            munmap(const_cast<char *>(data), size);
+        }
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    [[nodiscard]] bool isOpen() const {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] std::string_view view() const {
+        return {data, size};
+    }
+
+  private:
+    const char *data = nullptr;
+    std::size_t size = 0;
+};
+
+static bool
+replayFile(const std::string &path, const int repeat) {
+    std::cout << path << std::endl;
+
+    const MappedFile file(path);
+    if (!file.isOpen()) {
+        std::cout << "  cannot read the file" << std::endl;
+        return false;
+    }
+    const std::optional<Replay> replay = Replay::parse(file.view());
+    if (!replay) {
+        std::cout << "  not a replay (or of another version of the server)" << std::endl;
+        return false;
+    }
+
+    // the first run gives the outcome, the others only the timing
+    const auto start = std::chrono::steady_clock::now();
+    std::optional<ReplayResult> result;
+    for (int run = 0; run < repeat; ++run) {
+        result = ReplaySimulator::simulate(*replay);
+        if (!result) {
+            std::cout << "  cannot simulate a " << gameModeName(replay->gameMode) << " game" << std::endl;
+            return false;
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double played = static_cast<double>(result->ticks) * GAME_UPDATE_INTERVAL / 1000.0;
+    const double simulated = elapsed.count() / repeat;
+    std::cout << std::fixed << std::setprecision(1)
+              << "  " << gameModeName(replay->gameMode) << ", " << replay->players.size()
+              << " players, " << result->ticks << " ticks (" << played << " s of play)"
+              << (replay->complete ? "" : ", truncated") << std::endl
+              << "  simulated in " << std::setprecision(3) << simulated * 1000.0 << " ms ("
+              << std::setprecision(0) << (simulated > 0 ? played / simulated : 0.0)
+              << "x real time)" << std::endl;
+
+    for (const ReplayOutcome &outcome: result->players) {
+        std::cout << "  " << std::left << std::setw(16) << outcome.name << std::right
+                  << " score " << std::setw(7) << outcome.score
+                  << " lines " << std::setw(4) << outcome.lines
+                  << (outcome.left ? "  left     " : outcome.gameOver ? "  game over" : "  playing  ");
+        if (!outcome.recorded) {
+            std::cout << "  (nothing recorded)";
+        } else if (outcome.matches()) {
+            std::cout << "  ok";
+        } else {
+            std::cout << "  MISMATCH, recorded score " << outcome.recorded->score
+                      << " lines " << outcome.recorded->lines;
+        }
+        std::cout << std::endl;
+    }
+
+    return result->verified();
+}
+
+int
+main(int argc, char *argv[]) {
+    // TetrisRoyaleReplay [--repeat N] FILE...
+    const std::string usage = std::string("Usage: ") + argv[0] + " [--repeat N] FILE...";
+
+    int repeat = 1;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            try {
+                repeat = std::stoi(argv[++i]);
+            } catch (const std::exception &) {
+                repeat = 0;
+            }
+            if (repeat <= 0) {
+                std::cerr << "Invalid value for --repeat" << std::endl;
+                return EXIT_FAILURE;
+            }
+        } else if (arg.starts_with("--")) {
+            std::cerr << usage << std::endl;
+            return EXIT_FAILURE;
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    if (paths.empty()) {
+        std::cerr << usage << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool verified = true;
+    for (const std::string &path: paths) {
+        verified = replayFile(path, repeat) && verified;
+    }
+    return verified ? EXIT_SUCCESS : EXIT_FAILURE;
+}
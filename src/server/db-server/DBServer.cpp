@@ -31,6 +31,7 @@ TetrisDBServer::TetrisDBServer(const std::string &address,
 
         std::cout << "[DBServer] Database opened at " << dbFile << std::endl;
         initializeDatabase();
+        loadLeaderboard();
     } catch (const std::exception &e) {
         std::cerr << "[DBServer] Error initializing database: " << e.what()
                 << std::endl;
@@ -89,6 +90,12 @@ TetrisDBServer::closeDBServer() {
         stopFlag_ = true; // Signal shutdown
         this->stop(); // Stop HTTP server
 
+        // wake up the long-polling sessions so they can answer and exit
+        {
+            std::lock_guard lock(notificationsMutex_);
+        }
+        notificationsCV_.notify_all();
+
         if (dbThread_.joinable()) {
             dbThread_.join(); // Wait for the server thread to finish
         }
@@ -147,6 +154,8 @@ TetrisDBServer::initializeDatabase() const {
             FOREIGN KEY (senderID) REFERENCES players(accountID),
             FOREIGN KEY (receiverID) REFERENCES players(accountID)
         );
+        CREATE INDEX IF NOT EXISTS idx_messages_sender_receiver
+            ON messages (senderID, receiverID);
     )sql";
 
     char *errMsg = nullptr;
@@ -157,6 +166,34 @@ TetrisDBServer::initializeDatabase() const {
     }
 }
 
+void
+TetrisDBServer::loadLeaderboard() {
+    // this is the only time the whole players table gets read for the
+    // ranking, from here on handleRegister / handlePostScore / handleUpdate
+    // keep the in-memory copy up to date
+
+    leaderboard_.clear();
+
+    sqlite3_stmt *stmt = nullptr;
+    const auto sql = "SELECT accountID, userName, bestScore FROM players;";
+    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "SQL error while loading the leaderboard: "
+                << sqlite3_errmsg(db_) << std::endl;
+        std::exit(EXIT_FAILURE);
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        leaderboard_.setPlayer(
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)),
+            reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)),
+            sqlite3_column_int(stmt, 2));
+    }
+    sqlite3_finalize(stmt);
+
+    std::cout << "[DBServer] Leaderboard loaded (" << leaderboard_.size()
+            << " players)" << std::endl;
+}
+
 // ----------------------- Utility Functions -----------------------
 void
 TetrisDBServer::sendJSONResponse(http::response<http::string_body> &res,
@@ -204,10 +241,89 @@ TetrisDBServer::parseQuery(const std::string &query) {
     return params;
 }
 
+boost::property_tree::ptree
+TetrisDBServer::leaderboardToJSON(const std::vector<LeaderboardEntry> &entries) {
+    boost::property_tree::ptree array;
+
+    for (const LeaderboardEntry &entry: entries) {
+        boost::property_tree::ptree item;
+        item.put("rank", entry.rank);
+        item.put("accountID", entry.accountID);
+        item.put("userName", entry.userName);
+        item.put("bestScore", entry.score);
+        array.push_back(std::make_pair("", item));
+    }
+
+    return array;
+}
+
+void
+TetrisDBServer::pushNotification(const std::string &accountID,
+                                 const std::string &type,
+                                 const std::string &fromID) {
+    // this method queues an event for accountID and wakes up whoever is long
+    // polling. the queue is bounded, a client that never polls can't make us
+    // grow forever (it will resync anyway when it comes back)
+
+    {
+        std::lock_guard lock(notificationsMutex_);
+        std::deque<Notification> &queue = notifications_[accountID];
+        queue.push_back({++lastNotificationSeq_, type, fromID});
+
+        while (queue.size() > MAX_PENDING_NOTIFICATIONS) {
+            queue.pop_front();
+        }
+    }
+
+    notificationsCV_.notify_all();
+}
+
+// ----------------------- Metrics -----------------------
+TetrisDBServer::DBLock::DBLock(std::mutex &mutex)
+    : waitStart(std::chrono::steady_clock::now()), lock(mutex),
+      lockedAt(std::chrono::steady_clock::now()) {
+    static Histogram &wait = MetricsRegistry::instance().histogram(
+        "tetris_db_lock_wait_seconds", "Time a request waits for the database");
+    wait.record(lockedAt - waitStart);
+}
+
+TetrisDBServer::DBLock::~DBLock() {
+    // the sum of this one is the time sqlite was busy
+    static Histogram &busy = MetricsRegistry::instance().histogram(
+        "tetris_db_busy_seconds", "Time a request holds the database");
+    busy.record(std::chrono::steady_clock::now() - lockedAt);
+}
+
+Histogram &
+TetrisDBServer::endpointDuration(const std::string &path) {
+    static const std::unordered_map<std::string, Histogram *> ENDPOINTS = [] {
+        std::unordered_map<std::string, Histogram *> endpoints;
+        for (const std::string endpoint: {
+                 "/get_leaderboard", "/get_rank", "/get_player", "/get_messages",
+                 "/poll_notifications", "/get_account_id", "/get_username",
+                 "/register", "/login", "/update", "/post_score",
+                 "/send_friend_request", "/accept_friend_request",
+                 "/decline_friend_request", "/remove_friend", "/post_message",
+                 "/delete_message", "/resolve_accounts", "other"}) {
+            endpoints[endpoint] = &MetricsRegistry::instance().histogram(
+                "tetris_db_request_duration_seconds",
+                "Time to answer a request, per endpoint",
+                "endpoint=\"" + endpoint + "\"");
+        }
+        return endpoints;
+    }();
+
+    const auto it = ENDPOINTS.find(path);
+    return *(it != ENDPOINTS.end() ? it->second : ENDPOINTS.at("other"));
+}
+
 // ----------------------- HTTP Request Dispatch -----------------------
 void
 TetrisDBServer::handleRequest(http::request<http::string_body> req,
                               http::response<http::string_body> &res) {
+    const std::string target(req.target());
+    const ScopedTimer timer(endpointDuration(target.substr(0, target.find('?'))));
+
     if (req.method() == http::verb::get) {
         handleGetRequest(req, res);
     } else if (req.method() == http::verb::post) {
@@ -235,6 +351,8 @@ TetrisDBServer::handleGetRequest(const http::request<http::string_body> &req,
     const std::string target(req.target());
     if (target.find("/get_leaderboard") == 0) {
         handleGetLeaderboard(req.version(), res, target);
+    } else if (target.find("/get_rank") == 0) {
+        handleGetRank(target, req.version(), res);
     } else if (target.find("/get_player") == 0) {
         if (const auto pos = target.find('?'); pos != std::string::npos) {
             auto params = parseQuery(target.substr(pos + 1));
@@ -253,6 +371,8 @@ TetrisDBServer::handleGetRequest(const http::request<http::string_body> &req,
                           "Missing query parameters", req.version());
     } else if (target.find("/get_messages") == 0) {
         handleGetMessages(target, req.version(), res);
+    } else if (target.find("/poll_notifications") == 0) {
+        handlePollNotifications(target, req.version(), res);
     } else if (target.find("/get_account_id") == 0) {
         if (const auto pos = target.find('?'); pos != std::string::npos) {
             auto params = parseQuery(target.substr(pos + 1));
@@ -295,7 +415,7 @@ void
 TetrisDBServer::handleGetAccountIDByUsername(const std::string &username,
                                              const unsigned int version,
                                              http::response<http::string_body> &res) {
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
 
     const auto sql = "SELECT accountID FROM players WHERE userName = ?;";
@@ -329,7 +449,7 @@ void
 TetrisDBServer::handleGetUsernameByAccountID(const std::string &accountID,
                                              const unsigned int version,
                                              http::response<http::string_body> &res) {
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
 
     const auto sql = "SELECT userName FROM players WHERE accountID = ?;";
@@ -384,6 +504,8 @@ TetrisDBServer::handlePostRequest(const std::string &target,
         handlePostMessage(pt, version, res);
     } else if (target == "/delete_message") {
         handleDeleteMessage(pt, version, res);
+    } else if (target == "/resolve_accounts") {
+        handleResolveAccounts(pt, version, res);
     } else {
         sendErrorResponse(res, http::status::not_found, "Unknown POST endpoint",
                           version);
@@ -406,7 +528,7 @@ TetrisDBServer::handleRegister(const boost::property_tree::ptree &pt,
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
 
     const auto checkSql = "SELECT userName FROM players WHERE userName = ?;";
@@ -445,6 +567,8 @@ TetrisDBServer::handleRegister(const boost::property_tree::ptree &pt,
     }
     sqlite3_finalize(stmt);
 
+    leaderboard_.setPlayer(accountID, userName, 0);
+
     boost::property_tree::ptree resp;
     resp.put("accountID", accountID);
     resp.put("userName", userName);
@@ -464,7 +588,7 @@ TetrisDBServer::handleLogin(const boost::property_tree::ptree &pt,
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     const auto sql =
             "SELECT accountID, hashedPassword FROM players WHERE userName = ?;";
@@ -516,7 +640,7 @@ TetrisDBServer::handleUpdate(const boost::property_tree::ptree &pt,
     const std::string newName = pt.get<std::string>("newName", "");
     const std::string newPassword = pt.get<std::string>("newPassword", "");
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     if (!newName.empty()) {
         const auto checkSql =
@@ -596,12 +720,108 @@ TetrisDBServer::handleUpdate(const boost::property_tree::ptree &pt,
 
     sqlite3_finalize(stmt);
 
+    if (!newName.empty()) {
+        leaderboard_.setUserName(accountID, finalName);
+
+        // whoever shows our name (friends, people we sent a request to) has
+        // it cached, tell them it changed
+        const auto contactsSql =
+                "SELECT friendID FROM friends WHERE accountID = ? "
+                "UNION SELECT receiverID FROM friend_requests WHERE senderID = ?;";
+        if (sqlite3_prepare_v2(db_, contactsSql, -1, &stmt, nullptr) == SQLITE_OK) {
+            sqlite3_bind_text(stmt, 1, accountID.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, accountID.c_str(), -1, SQLITE_STATIC);
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                pushNotification(reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)),
+                                 "rename", accountID);
+            }
+            sqlite3_finalize(stmt);
+        }
+    }
+
     boost::property_tree::ptree resp;
     resp.put("accountID", accountID);
     resp.put("userName", finalName);
     sendJSONResponse(res, http::status::ok, resp, version);
 }
 
+// POST /resolve_accounts { "accountIDs": [...], "userNames": [...] }
+// resolves a whole list at once (both arrays are optional), the accounts that
+// exist come back as { accountID, userName } pairs, the others are left out
+void
+TetrisDBServer::handleResolveAccounts(const boost::property_tree::ptree &pt,
+                                      const unsigned int version,
+                                      http::response<http::string_body> &res) {
+    std::vector<std::string> accountIDs;
+    std::vector<std::string> userNames;
+
+    if (const auto ids = pt.get_child_optional("accountIDs")) {
+        for (const auto &item: *ids) {
+            accountIDs.push_back(item.second.data());
+        }
+    }
+    if (const auto names = pt.get_child_optional("userNames")) {
+        for (const auto &item: *names) {
+            userNames.push_back(item.second.data());
+        }
+    }
+
+    if (accountIDs.size() + userNames.size() > MAX_RESOLVE_ACCOUNTS) {
+        sendErrorResponse(res, http::status::bad_request,
+                          "Too many accounts to resolve", version);
+        return;
+    }
+
+    boost::property_tree::ptree accounts;
+
+    if (!accountIDs.empty() || !userNames.empty()) {
+        // one query for everything : accountID IN (?, ...) OR userName IN (?, ...)
+        auto placeholders = [](const std::size_t count) {
+            std::string list;
+            for (std::size_t i = 0; i < count; ++i) {
+                list += (i == 0) ? "?" : ", ?";
+            }
+            return list;
+        };
+
+        const std::string sql =
+                "SELECT accountID, userName FROM players WHERE accountID IN (" +
+                placeholders(accountIDs.size()) + ") OR userName IN (" +
+                placeholders(userNames.size()) + ");";
+
+        const DBLock lock(dbMutex_);
+        sqlite3_stmt *stmt = nullptr;
+
+        if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            sendErrorResponse(res, http::status::internal_server_error,
+                              "DB error", version);
+            return;
+        }
+
+        int index = 1;
+        for (const auto &accountID: accountIDs) {
+            sqlite3_bind_text(stmt, index++, accountID.c_str(), -1, SQLITE_STATIC);
+        }
+        for (const auto &userName: userNames) {
+            sqlite3_bind_text(stmt, index++, userName.c_str(), -1, SQLITE_STATIC);
+        }
+
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            boost::property_tree::ptree account;
+            account.put("accountID",
+                        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+            account.put("userName",
+                        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+            accounts.push_back(std::make_pair("", account));
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    boost::property_tree::ptree root;
+    root.add_child("accounts", accounts);
+    sendJSONResponse(res, http::status::ok, root, version);
+}
+
 // POST /post_score { "accountID": "...", "score": <number> }
 void
 TetrisDBServer::handlePostScore(const boost::property_tree::ptree &pt,
@@ -615,7 +835,7 @@ TetrisDBServer::handlePostScore(const boost::property_tree::ptree &pt,
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     const auto sql = "UPDATE players SET bestScore = ? WHERE accountID = ?;";
     if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
@@ -635,50 +855,76 @@ TetrisDBServer::handlePostScore(const boost::property_tree::ptree &pt,
 
     sqlite3_finalize(stmt);
 
+    // unknown accounts didn't match any row either, nothing to rank
+    (void) leaderboard_.setScore(accountID, score);
+
     boost::property_tree::ptree resp;
     resp.put("message", "Score updated successfully");
     sendJSONResponse(res, http::status::ok, resp, version);
 }
 
 // GET /get_leaderboard?limit=...
+// served from the in-memory leaderboard, the players table is not touched
 void
 TetrisDBServer::handleGetLeaderboard(const unsigned int version,
                                      http::response<http::string_body> &res,
                                      const std::string &query) {
-    int limit = 10;
+    int limit = DEFAULT_LEADERBOARD_LIMIT;
     auto params = parseQuery(query.substr(query.find('?') + 1));
-    if (params.contains("limit")) {
-        limit = std::stoi(params["limit"]);
-    }
-
-    std::lock_guard lock(dbMutex_);
-    sqlite3_stmt *stmt = nullptr;
-    std::string sql =
-            "SELECT accountID, userName, bestScore FROM players ORDER BY bestScore "
-            "DESC LIMIT " +
-            std::to_string(limit) + ";";
-    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
-        sendErrorResponse(res, http::status::internal_server_error, "DB error",
+    try {
+        if (params.contains("limit")) {
+            limit = std::max(0, std::stoi(params["limit"]));
+        }
+    } catch (const std::exception &) {
+        sendErrorResponse(res, http::status::bad_request, "Invalid limit",
                           version);
         return;
     }
 
-    boost::property_tree::ptree leaderboard;
+    boost::property_tree::ptree root;
+    root.add_child("leaderboard", leaderboardToJSON(leaderboard_.getTop(
+                       static_cast<std::size_t>(limit))));
+    sendJSONResponse(res, http::status::ok, root, version);
+}
 
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        boost::property_tree::ptree entry;
-        entry.put("accountID",
-                  reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
-        entry.put("userName",
-                  reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
-        entry.put("bestScore", sqlite3_column_int(stmt, 2));
-        leaderboard.push_back(std::make_pair("", entry));
+// GET /get_rank?accountID=...[&around=...]
+// rank of the player, plus the players right above and below it
+void
+TetrisDBServer::handleGetRank(const std::string &query,
+                              const unsigned int version,
+                              http::response<http::string_body> &res) {
+    auto params = parseQuery(query.substr(query.find('?') + 1));
+    if (!params.contains("accountID") || params["accountID"].empty()) {
+        sendErrorResponse(res, http::status::bad_request,
+                          "Missing accountID param", version);
+        return;
     }
 
-    sqlite3_finalize(stmt);
+    int radius = DEFAULT_RANK_RADIUS;
+    try {
+        if (params.contains("around")) {
+            radius = std::max(0, std::stoi(params["around"]));
+        }
+    } catch (const std::exception &) {
+        sendErrorResponse(res, http::status::bad_request, "Invalid around",
+                          version);
+        return;
+    }
+
+    const std::string accountID = params["accountID"];
+    const std::optional<LeaderboardEntry> entry = leaderboard_.getEntry(accountID);
+    if (!entry) {
+        sendErrorResponse(res, http::status::not_found, "Player not found",
+                          version);
+        return;
+    }
 
     boost::property_tree::ptree root;
-    root.add_child("leaderboard", leaderboard);
+    root.put("rank", entry->rank);
+    root.put("bestScore", entry->score);
+    root.put("totalPlayers", leaderboard_.size());
+    root.add_child("around", leaderboardToJSON(leaderboard_.getAround(
+                       accountID, static_cast<std::size_t>(radius))));
     sendJSONResponse(res, http::status::ok, root, version);
 }
 
@@ -687,7 +933,7 @@ void
 TetrisDBServer::handleGetPlayer(const std::string &accountID,
                                 const unsigned int version,
                                 http::response<http::string_body> &res) {
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
 
     // Query basic player info
@@ -777,7 +1023,7 @@ TetrisDBServer::handleSendFriendRequest(const boost::property_tree::ptree &pt,
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     auto sql =
             "INSERT INTO friend_requests (senderID, receiverID) VALUES (?, ?);";
@@ -798,6 +1044,8 @@ TetrisDBServer::handleSendFriendRequest(const boost::property_tree::ptree &pt,
     }
     sqlite3_finalize(stmt);
 
+    pushNotification(receiver, "friend_request", sender);
+
     boost::property_tree::ptree resp;
     resp.put("message", "Friend request sent");
     sendJSONResponse(res, http::status::ok, resp, version);
@@ -816,7 +1064,7 @@ TetrisDBServer::handleAcceptFriendRequest(
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
 
     // Start a transaction
     if (sqlite3_exec(db_, "BEGIN TRANSACTION", nullptr, nullptr, nullptr) != SQLITE_OK) {
@@ -865,6 +1113,8 @@ TetrisDBServer::handleAcceptFriendRequest(
     // Commit or rollback the transaction
     if (success) {
         sqlite3_exec(db_, "COMMIT", nullptr, nullptr, nullptr);
+        pushNotification(sender, "friend_accept", receiver);
+
         boost::property_tree::ptree resp;
         resp.put("message", "Friend request accepted");
         sendJSONResponse(res, http::status::ok, resp, version);
@@ -888,7 +1138,7 @@ TetrisDBServer::handleDeclineFriendRequest(
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     auto sql =
             "DELETE FROM friend_requests WHERE senderID = ? AND receiverID = ?;";
@@ -909,6 +1159,8 @@ TetrisDBServer::handleDeclineFriendRequest(
     }
     sqlite3_finalize(stmt);
 
+    pushNotification(sender, "friend_decline", receiver);
+
     boost::property_tree::ptree resp;
     resp.put("message", "Friend request declined");
     sendJSONResponse(res, http::status::ok, resp, version);
@@ -927,7 +1179,7 @@ TetrisDBServer::handleRemoveFriend(const boost::property_tree::ptree &pt,
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     auto sql = "DELETE FROM friends WHERE (accountID = ? AND friendID = ?) OR "
             "(accountID = ? AND friendID "
@@ -951,12 +1203,18 @@ TetrisDBServer::handleRemoveFriend(const boost::property_tree::ptree &pt,
     }
     sqlite3_finalize(stmt);
 
+    pushNotification(user2, "friend_remove", user1);
+
     boost::property_tree::ptree resp;
     resp.put("message", "Friend removed successfully");
     sendJSONResponse(res, http::status::ok, resp, version);
 }
 
-// GET /get_messages?accountID=...&otherAccountID=...
+// GET /get_messages?accountID=...&otherAccountID=...[&since=...][&limit=...]
+// since is either the messageID of the last message the client already has,
+// or a "YYYY-MM-DD HH:MM:SS" timestamp. messages are returned oldest first,
+// so the client can append them to what it already has and use the last
+// messageID as the next cursor
 void
 TetrisDBServer::handleGetMessages(const std::string &query,
                                   const unsigned int version,
@@ -969,16 +1227,59 @@ TetrisDBServer::handleGetMessages(const std::string &query,
     }
     const std::string user1 = params["accountID"];
     const std::string user2 = params["otherAccountID"];
+    const std::string since = params.contains("since") ? params["since"] : "";
+
+    // a negative limit means "no limit" for sqlite
+    int limit = -1;
+    if (params.contains("limit")) {
+        try {
+            limit = std::stoi(params["limit"]);
+        } catch (const std::exception &) {
+            sendErrorResponse(res, http::status::bad_request, "Invalid limit",
+                              version);
+            return;
+        }
+    }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
-    const auto sql =
-            "SELECT messageID, senderID, receiverID, content, timestamp FROM "
-            "messages "
-            "WHERE (senderID = ? AND receiverID = ?) OR (senderID = ? AND "
-            "receiverID = ?) "
-            "ORDER BY timestamp DESC;";
-    if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+
+    // rowids only ever grow, so they give us a stable ordering even when
+    // several messages share the same (second resolution) timestamp
+    sqlite3_int64 sinceRowID = 0;
+    bool sinceIsTimestamp = false;
+
+    if (!since.empty()) {
+        const auto cursorSql = "SELECT rowid FROM messages WHERE messageID = ?;";
+        if (sqlite3_prepare_v2(db_, cursorSql, -1, &stmt, nullptr) != SQLITE_OK) {
+            sendErrorResponse(res, http::status::internal_server_error,
+                              "DB error", version);
+            return;
+        }
+
+        sqlite3_bind_text(stmt, 1, since.c_str(), -1, SQLITE_STATIC);
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            sinceRowID = sqlite3_column_int64(stmt, 0);
+        } else if (since.size() >= 10 && since[4] == '-' && since[7] == '-') {
+            sinceIsTimestamp = true;
+        } else {
+            // the cursor message is gone (deleted), the client has to reload
+            sqlite3_finalize(stmt);
+            sendErrorResponse(res, http::status::not_found, "Unknown cursor",
+                              version);
+            return;
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    const std::string sql =
+            std::string("SELECT messageID, senderID, receiverID, content, "
+                        "timestamp FROM messages "
+                        "WHERE ((senderID = ? AND receiverID = ?) OR "
+                        "(senderID = ? AND receiverID = ?)) ") +
+            (sinceIsTimestamp ? "AND timestamp > ? " : "AND rowid > ? ") +
+            "ORDER BY rowid ASC LIMIT ?;";
+    if (sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
         sendErrorResponse(res, http::status::internal_server_error, "DB error",
                           version);
         return;
@@ -988,12 +1289,21 @@ TetrisDBServer::handleGetMessages(const std::string &query,
     sqlite3_bind_text(stmt, 2, user2.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 3, user2.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 4, user1.c_str(), -1, SQLITE_STATIC);
+    if (sinceIsTimestamp) {
+        sqlite3_bind_text(stmt, 5, since.c_str(), -1, SQLITE_STATIC);
+    } else {
+        sqlite3_bind_int64(stmt, 5, sinceRowID);
+    }
+    sqlite3_bind_int(stmt, 6, limit);
+
     boost::property_tree::ptree messages;
+    std::string cursor = since;
+    int count = 0;
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
         boost::property_tree::ptree message;
-        message.put("messageID", reinterpret_cast<const char *>(
-                        sqlite3_column_text(stmt, 0)));
+        cursor = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+        message.put("messageID", cursor);
         message.put("senderID", reinterpret_cast<const char *>(
                         sqlite3_column_text(stmt, 1)));
         message.put("receiverID", reinterpret_cast<const char *>(
@@ -1003,11 +1313,14 @@ TetrisDBServer::handleGetMessages(const std::string &query,
         message.put("timestamp", reinterpret_cast<const char *>(
                         sqlite3_column_text(stmt, 4)));
         messages.push_back(std::make_pair("", message));
+        ++count;
     }
     sqlite3_finalize(stmt);
 
     boost::property_tree::ptree root;
     root.add_child("messages", messages);
+    root.put("cursor", cursor);
+    root.put("hasMore", limit >= 0 && count == limit);
     sendJSONResponse(res, http::status::ok, root, version);
 }
 
@@ -1028,7 +1341,7 @@ TetrisDBServer::handlePostMessage(const boost::property_tree::ptree &pt,
 
     const std::string messageID = generateUUID();
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     const auto sql =
             "INSERT INTO messages (messageID, senderID, receiverID, content) "
@@ -1051,6 +1364,8 @@ TetrisDBServer::handlePostMessage(const boost::property_tree::ptree &pt,
     }
     sqlite3_finalize(stmt);
 
+    pushNotification(receiver, "message", sender);
+
     boost::property_tree::ptree resp;
     resp.put("message", "Message posted successfully");
     sendJSONResponse(res, http::status::ok, resp, version);
@@ -1068,7 +1383,7 @@ TetrisDBServer::handleDeleteMessage(const boost::property_tree::ptree &pt,
         return;
     }
 
-    std::lock_guard lock(dbMutex_);
+    const DBLock lock(dbMutex_);
     sqlite3_stmt *stmt = nullptr;
     const auto sql = "DELETE FROM messages WHERE messageID = ?;";
     if (sqlite3_prepare_v2(db_, sql, -1, &stmt, nullptr) != SQLITE_OK) {
@@ -1090,3 +1405,84 @@ TetrisDBServer::handleDeleteMessage(const boost::property_tree::ptree &pt,
     resp.put("message", "Message deleted successfully");
     sendJSONResponse(res, http::status::ok, resp, version);
 }
+
+// GET /poll_notifications?accountID=...[&since=<seq>][&timeout=<seconds>]
+// long-poll : the request is held until there is something newer than since
+// for this account (or until the timeout), every connection has its own
+// session thread so holding it here doesn't block anybody else. without
+// since, it answers right away with the current cursor (handshake)
+void
+TetrisDBServer::handlePollNotifications(const std::string &query,
+                                        const unsigned int version,
+                                        http::response<http::string_body> &res) {
+    auto params = parseQuery(query.substr(query.find('?') + 1));
+    if (!params.contains("accountID") || params["accountID"].empty()) {
+        sendErrorResponse(res, http::status::bad_request,
+                          "Missing accountID param", version);
+        return;
+    }
+    const std::string accountID = params["accountID"];
+
+    std::uint64_t since = 0;
+    int timeout = DEFAULT_POLL_TIMEOUT_SEC;
+    try {
+        if (params.contains("since") && !params["since"].empty()) {
+            since = std::stoull(params["since"]);
+        }
+        if (params.contains("timeout")) {
+            timeout = std::clamp(std::stoi(params["timeout"]), 0,
+                                 MAX_POLL_TIMEOUT_SEC);
+        }
+    } catch (const std::exception &) {
+        sendErrorResponse(res, http::status::bad_request, "Invalid parameters",
+                          version);
+        return;
+    }
+
+    std::unique_lock lock(notificationsMutex_);
+
+    // a cursor this server never handed out comes from before a restart (the
+    // sequence starts over at 0), so everything we have is new to the client
+    if (since > lastNotificationSeq_) {
+        since = 0;
+    }
+
+    const auto hasNews = [this, &accountID, since] {
+        const auto it = notifications_.find(accountID);
+        return it != notifications_.end() && !it->second.empty() &&
+               it->second.back().seq > since;
+    };
+
+    boost::property_tree::ptree notifications;
+    std::uint64_t cursor = lastNotificationSeq_;
+
+    if (params.contains("since")) {
+        (void) notificationsCV_.wait_for(lock, std::chrono::seconds(timeout),
+                                         [this, &hasNews] {
+                                             return stopFlag_ || hasNews();
+                                         });
+
+        cursor = since;
+        if (const auto it = notifications_.find(accountID);
+            it != notifications_.end()) {
+            for (const Notification &notification: it->second) {
+                if (notification.seq <= since) {
+                    continue;
+                }
+
+                boost::property_tree::ptree entry;
+                entry.put("seq", notification.seq);
+                entry.put("type", notification.type);
+                entry.put("fromID", notification.fromID);
+                notifications.push_back(std::make_pair("", entry));
+                cursor = notification.seq;
+            }
+        }
+    }
+    lock.unlock();
+
+    boost::property_tree::ptree root;
+    root.add_child("notifications", notifications);
+    root.put("cursor", cursor);
+    sendJSONResponse(res, http::status::ok, root, version);
+}
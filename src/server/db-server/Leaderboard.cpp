@@ -0,0 +1,145 @@
+#include "Leaderboard.hpp"
+
+void
+Leaderboard::clear() {
+    std::lock_guard lock(leaderboardMutex);
+    ranking.clear();
+    players.clear();
+}
+
+void
+Leaderboard::setPlayer(const std::string &accountID, const std::string &userName,
+                       const int score) {
+    // this method inserts a player or moves it to its new score
+    // (remove + insert, both O(log n))
+
+    std::lock_guard lock(leaderboardMutex);
+
+    if (const auto it = players.find(accountID); it != players.end()) {
+        ranking.erase(RankKey{it->second.score, accountID});
+    }
+
+    ranking.insert(RankKey{score, accountID});
+    players[accountID] = PlayerInfo{userName, score};
+}
+
+bool
+Leaderboard::setScore(const std::string &accountID, const int score) {
+    std::lock_guard lock(leaderboardMutex);
+
+    const auto it = players.find(accountID);
+    if (it == players.end()) {
+        return false;
+    }
+
+    ranking.erase(RankKey{it->second.score, accountID});
+    ranking.insert(RankKey{score, accountID});
+    it->second.score = score;
+
+    return true;
+}
+
+void
+Leaderboard::setUserName(const std::string &accountID, const std::string &userName) {
+    // the name is not part of the key, nothing moves in the tree
+    std::lock_guard lock(leaderboardMutex);
+
+    if (const auto it = players.find(accountID); it != players.end()) {
+        it->second.userName = userName;
+    }
+}
+
+void
+Leaderboard::removePlayer(const std::string &accountID) {
+    std::lock_guard lock(leaderboardMutex);
+
+    if (const auto it = players.find(accountID); it != players.end()) {
+        ranking.erase(RankKey{it->second.score, accountID});
+        players.erase(it);
+    }
+}
+
+std::size_t
+Leaderboard::size() const {
+    std::lock_guard lock(leaderboardMutex);
+    return players.size();
+}
+
+std::vector<LeaderboardEntry>
+Leaderboard::getTop(const std::size_t count) const {
+    std::lock_guard lock(leaderboardMutex);
+    return listFrom(0, count);
+}
+
+std::optional<LeaderboardEntry>
+Leaderboard::getEntry(const std::string &accountID) const {
+    std::lock_guard lock(leaderboardMutex);
+
+    const auto it = players.find(accountID);
+    if (it == players.end()) {
+        return std::nullopt;
+    }
+
+    return LeaderboardEntry{rankOfScore(it->second.score), accountID,
+                            it->second.userName, it->second.score};
+}
+
+std::vector<LeaderboardEntry>
+Leaderboard::getAround(const std::string &accountID, const std::size_t radius) const {
+    // this method returns the window of players centered on accountID, which
+    // is what a "you are here" view of the leaderboard needs
+
+    std::lock_guard lock(leaderboardMutex);
+
+    const auto it = players.find(accountID);
+    if (it == players.end()) {
+        return {};
+    }
+
+    const std::size_t position = ranking.order_of_key(RankKey{it->second.score, accountID});
+    const std::size_t first = (position > radius) ? position - radius : 0;
+
+    return listFrom(first, position - first + radius + 1);
+}
+
+int
+Leaderboard::rankOfScore(const int score) const {
+    // players with the same score share the same rank (1, 2, 2, 4, ...)
+    // the empty accountID sorts before every real one, so this counts the
+    // players that have a strictly better score
+
+    return static_cast<int>(ranking.order_of_key(RankKey{score, ""})) + 1;
+}
+
+std::vector<LeaderboardEntry>
+Leaderboard::listFrom(const std::size_t position, const std::size_t count) const {
+    // lists 'count' players starting at the given position (0 is the best
+    // player), the lock must be held by the caller
+
+    std::vector<LeaderboardEntry> entries;
+    if (position >= ranking.size()) {
+        return entries;
+    }
+
+    entries.reserve(std::min(count, ranking.size() - position));
+
+    int rank = 0;
+    int previousScore = 0;
+
+    for (auto it = ranking.find_by_order(position);
+         it != ranking.end() && entries.size() < count; ++it) {
+        // only the first entry needs a lookup, the others follow from it
+        if (entries.empty()) {
+            rank = rankOfScore(it->score);
+        } else if (it->score != previousScore) {
+            rank = static_cast<int>(position + entries.size()) + 1;
+        }
+        previousScore = it->score;
+
+        entries.push_back(LeaderboardEntry{rank, it->accountID,
+                                           players.at(it->accountID).userName,
+                                           it->score});
+    }
+
+    return entries;
+}
@@ -1,5 +1,9 @@
 #include "HTTPServer.hpp"
 
+#include <cerrno>
+
+#include <poll.h>
+
 TetrisHTTPServer::TetrisHTTPServer(std::string address,
                                    const unsigned short port)
     : address_(std::move(address)), port_(port), ioc_(1), acceptor_(ioc_) {
@@ -75,6 +79,13 @@ TetrisHTTPServer::doSession(tcp::socket socket) {
     beast::flat_buffer buffer;
 
     for (;;) {
+        // a keep-alive connection the client forgot about would hold this
+        // thread forever (the read blocks), the buffer may already have the
+        // next pipelined request though
+        if (buffer.size() == 0 && !waitForRequest(socket)) {
+            break;
+        }
+
         http::request<http::string_body> req;
         http::read(socket, buffer, req, ec);
 
@@ -92,8 +103,12 @@ TetrisHTTPServer::doSession(tcp::socket socket) {
         http::response<http::string_body> res{http::status::ok, req.version()};
         res.set(http::field::content_type, "text/plain");
 
-        // Let the derived class handle this request
-        handleRequest(req, res);
+        // Let the derived class handle this request (but the metrics)
+        if (req.method() == http::verb::get && req.target() == "/metrics") {
+            handleMetricsRequest(req, res);
+        } else {
+            handleRequest(req, res);
+        }
 
         // Send the response
         http::write(socket, res, ec);
@@ -111,6 +126,24 @@ TetrisHTTPServer::doSession(tcp::socket socket) {
     socket.shutdown(tcp::socket::shutdown_send, ec);
 }
 
+bool
+TetrisHTTPServer::waitForRequest(tcp::socket &socket) {
+    // the synchronous reads of asio ignore SO_RCVTIMEO (they poll again when
+    // the socket times out), so we poll ourselves before reading
+
+    pollfd descriptor{};
+    descriptor.fd = socket.native_handle();
+    descriptor.events = POLLIN;
+
+    int ready;
+    do {
+        ready = ::poll(&descriptor, 1, HTTP_IDLE_TIMEOUT_SEC * 1000);
+    } while (ready < 0 && errno == EINTR);
+
+    // readable also means closed by the client, the read will tell
+    return ready > 0;
+}
+
 void
 TetrisHTTPServer::handleRequest(http::request<http::string_body> req,
                                 http::response<http::string_body> &res) {
@@ -118,6 +151,16 @@ TetrisHTTPServer::handleRequest(http::request<http::string_body> req,
     res.prepare_payload();
 }
 
+void
+TetrisHTTPServer::handleMetricsRequest(const http::request<http::string_body> &req,
+                                       http::response<http::string_body> &res) {
+    res.version(req.version());
+    res.result(http::status::ok);
+    res.set(http::field::content_type, "text/plain; version=0.0.4");
+    res.body() = MetricsRegistry::instance().render();
+    res.prepare_payload();
+}
+
 std::string
 TetrisHTTPServer::forwardRequest(const std::string &host,
                                  const std::string &port,
@@ -27,8 +27,8 @@ ClassicEngine::handleBasicPenalty(ClassicGame &game, const int linesCleared) {
         linesToAdd = MAX_COMBO;
     }
 
-    // add the penalty lines to the opponent
-    opponent->addPenaltyLines(linesToAdd);
+    // the penalty lines are added to the opponent at the end of the tick
+    game.emitEffect({EffectType::PenaltyLines, opponent, linesToAdd});
 }
 
 void
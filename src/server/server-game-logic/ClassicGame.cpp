@@ -88,7 +88,7 @@ ClassicGame::addPenaltyLines(int linesToAdd) {
     }
 
     // push the new lines into the board (at the bottom)
-    matrix.pushPenaltyLinesAtBottom(linesToAdd);
+    matrix.pushPenaltyLinesAtBottom(linesToAdd, random);
 }
 
 void
@@ -0,0 +1,76 @@
+#include "Effect.hpp"
+
+#include "TetrisGame.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+void
+Effect::apply() const {
+    // this method applies the effect to its target, what used to be done
+    // right away by the engine of the source
+
+    switch (type) {
+        case EffectType::PenaltyLines:
+            return target->addPenaltyLines(lines);
+
+        case EffectType::Malus:
+            switch (malus) {
+                case TypePowerUps::invertedControls:
+                    return target->startInvertedControls();
+                case TypePowerUps::blockControls:
+                    return target->startBlockControls();
+                case TypePowerUps::thunderStrike:
+                    return target->spawnThunderStrike();
+                case TypePowerUps::fastPieces:
+                    return target->increaseFallingSpeed();
+                case TypePowerUps::darkMode:
+                    return target->startDarkMode();
+
+                default:
+                    throw std::runtime_error("[err] Unexpected Malus");
+            }
+
+        default:
+            throw std::runtime_error("[err] Unexpected Effect");
+    }
+}
+
+void
+EffectQueue::collect(TetrisGame &source) {
+    for (const Effect &effect: source.takeEffects()) {
+        queued.push_back({&source, effect});
+    }
+}
+
+void
+EffectQueue::apply() {
+    // the effects on a board use its random numbers (penalty holes, thunder
+    // strikes) and can end it, so their order matters : it is the sources'
+    // names, whoever was simulated first. stable, so a source keeps its order
+    std::ranges::stable_sort(queued, {}, [](const Queued &entry) {
+        return entry.source->getPlayerName();
+    });
+
+    for (const Queued &entry: queued) {
+        entry.effect.apply();
+    }
+    queued.clear();
+}
+
+void
+EffectQueue::forget(const TetrisGame *game) {
+    std::erase_if(queued, [game](const Queued &entry) {
+        return entry.source == game || entry.effect.target == game;
+    });
+}
+
+bool
+EffectQueue::empty() const {
+    return queued.empty();
+}
+
+std::size_t
+EffectQueue::size() const {
+    return queued.size();
+}
@@ -1,5 +1,7 @@
 #include "GameEngine.hpp"
 
+#include "Tracer.hpp"
+
 bool
 GameEngine::handleAction(TetrisGame &game, const Action action) {
     // this method is responsible for handling the game logic
@@ -248,8 +250,12 @@ GameEngine::handlingRoutine(TetrisGame &game, const Action action) {
     // this method is responsible for handling the game routine
     // the game routine includes handling the action, the falling piece, the
     // placing piece and the game logic
+    // (each phase is a span of the trace, when tracing is on)
 
-    (void) handleAction(game, action);
+    {
+        const TraceSpan span("handleAction", "engine");
+        (void) handleAction(game, action);
+    }
 
     // if player is in a game over state, don't do anything
     if (game.isGameOver()) {
@@ -257,11 +263,19 @@ GameEngine::handlingRoutine(TetrisGame &game, const Action action) {
     }
 
     // if the piece could not fall, try to place it
-    if (!handleFallingPiece(game)) {
+    bool fell; {
+        const TraceSpan span("handleFallingPiece", "engine");
+        fell = handleFallingPiece(game);
+    }
+    if (!fell) {
+        const TraceSpan span("handlePlacingPiece", "engine");
         (void) handlePlacingPiece(game);
     }
 
-    handleGameLogic(game);
+    {
+        const TraceSpan span("handleGameLogic", "engine");
+        handleGameLogic(game);
+    }
     game.incrementFrameCount(1);
 }
 
@@ -457,16 +457,17 @@ GameMatrix::pushNewLinesAtBottom(const std::vector<std::vector<int> > newLines)
 }
 
 void
-GameMatrix::pushPenaltyLinesAtBottom(const int linesToAdd) {
+GameMatrix::pushPenaltyLinesAtBottom(const int linesToAdd, std::mt19937 &random) {
     // this method is used to push penalty lines at the bottom of the board
     // it is used to add penalty lines to the board when a player is hit by a
-    // penalty
+    // penalty (the holes come from the random numbers of the board's game)
 
     std::vector<std::vector<int> > newLines;
+    std::uniform_int_distribution<int> holes(0, getWidth() - 1);
 
     for (int i = 0; i < linesToAdd; ++i) {
         std::vector<int> line(getWidth(), static_cast<int>(PieceType::Single));
-        const int hole = rand() % getWidth();
+        const int hole = holes(random);
         line[hole] = static_cast<int>(PieceType::None);
         newLines.push_back(line);
     }
@@ -1,5 +1,7 @@
 #include "RoyalEngine.hpp"
 
+#include "Tracer.hpp"
+
 bool
 RoyalEngine::handleAction(TetrisGame &game, const Action action) {
     // this method is responsible for handling the game logic
@@ -96,8 +98,11 @@ RoyalEngine::handlingRoutine(TetrisGame &game, const Action action) {
     // call the handleAction method with the given action if the block flag is
     // not set, otherwise call the handleAction method with the None action ->
     // blocking effect
-    (void) handleAction(
-        royalGame, royalGame.getBlockControlsFlag() ? Action::None : action);
+    {
+        const TraceSpan span("handleAction", "engine");
+        (void) handleAction(
+            royalGame, royalGame.getBlockControlsFlag() ? Action::None : action);
+    }
 
     // if darkmode flag is enabled, will check if the current frame is the same
     // as the frame when the darkmode was enabled
@@ -114,7 +119,12 @@ RoyalEngine::handlingRoutine(TetrisGame &game, const Action action) {
     }
 
     // if the piece's is not falling, then try to place the piece
-    if (!handleFallingPiece(royalGame)) {
+    bool fell; {
+        const TraceSpan span("handleFallingPiece", "engine");
+        fell = handleFallingPiece(royalGame);
+    }
+    if (!fell) {
+        const TraceSpan span("handlePlacingPiece", "engine");
         bool couldPlace = handlePlacingPiece(royalGame);
 
         // if we were able to place, then we need to update the malus flags
@@ -123,7 +133,10 @@ RoyalEngine::handlingRoutine(TetrisGame &game, const Action action) {
         }
     }
 
-    handleGameLogic(game);
+    {
+        const TraceSpan span("handleGameLogic", "engine");
+        handleGameLogic(game);
+    }
     game.incrementFrameCount(1);
 }
 
@@ -168,7 +181,8 @@ RoyalEngine::handleBonus(TetrisGame &game) {
     }
 
     // select a random power up from the bonus vector (defined in 'types.hpp')
-    TypePowerUps randomBonus = bonusVector[rand() % bonusVector.size()];
+    TypePowerUps randomBonus = bonusVector[static_cast<std::size_t>(
+        royalGame.randomIndex(static_cast<int>(bonusVector.size())))];
 
     switch (randomBonus) {
         case TypePowerUps::singleBlocks:
@@ -204,26 +218,9 @@ RoyalEngine::handleMalus(TetrisGame &game) {
     }
 
     // select a random power up from the malus vector (defined in 'types.hpp')
-    TypePowerUps randomMalus = malusVector[rand() % malusVector.size()];
-
-    switch (randomMalus) {
-        case TypePowerUps::invertedControls:
-            opponent->startInvertedControls();
-            break;
-        case TypePowerUps::blockControls:
-            opponent->startBlockControls();
-            break;
-        case TypePowerUps::thunderStrike:
-            opponent->spawnThunderStrike();
-            break;
-        case TypePowerUps::fastPieces:
-            opponent->increaseFallingSpeed();
-            break;
-        case TypePowerUps::darkMode:
-            opponent->startDarkMode();
-            break;
+    TypePowerUps randomMalus = malusVector[static_cast<std::size_t>(
+        royalGame.randomIndex(static_cast<int>(malusVector.size())))];
 
-        default:
-            throw std::runtime_error("[err] Unexpected Malus");
-    }
+    // the opponent gets it at the end of the tick
+    royalGame.emitEffect({EffectType::Malus, opponent, 0, randomMalus});
 }
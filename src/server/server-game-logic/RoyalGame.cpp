@@ -14,7 +14,7 @@ RoyalGame::spawnThunderStrike() {
     // it will destroy a 2x2 area of blocks in a random column
 
     // find some column to destroy
-    const int col = rand() % gameMatrix.getWidth();
+    const int col = randomIndex(gameMatrix.getWidth());
 
     // this is the default y value the thunder will strike.
     // will remain -1 if no block is found in the column "col"
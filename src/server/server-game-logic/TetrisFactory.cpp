@@ -62,6 +62,17 @@ int TetrisFactory::getPoolSize() const {
     return static_cast<int>(pool.size());
 }
 
+void TetrisFactory::reseed(const std::uint32_t seed) {
+
+    // this function makes the pieces to come depend on the seed only
+    // (used by the games that are recorded, to be played again the same)
+
+    rng.seed(seed);
+    pool.clear();
+    fillPool();
+
+}
+
 void TetrisFactory::fillPool() {
     
     // this function fills the pool with new pieces
@@ -1,14 +1,39 @@
 #include "TetrisGame.hpp"
 
+#include <utility>
+
 TetrisGame::TetrisGame(const int gWidth, const int gHeight, const int gScore,
                        const int fc, const int lvl, const int totLinesCleared, const std::string &name)
-    : gameMatrix(gWidth, gHeight), score(gScore), frameCount(fc), level(lvl),
+    : gameMatrix(gWidth, gHeight), random(std::random_device{}()), score(gScore), frameCount(fc), level(lvl),
       totalLinesCleared(totLinesCleared), playerName(name) {
     // this is the constructor of the TetrisGame class
     // might need to write some code here someday
     gameMode = GameMode::NONE;
 }
 
+void
+TetrisGame::setSeed(const std::uint32_t seed) {
+    // the pieces and the rest don't draw from the same generator, one
+    // doesn't shift the other
+    factory.reseed(seed);
+    random.seed(seed ^ 0x9E3779B9U);
+}
+
+int
+TetrisGame::randomIndex(const int bound) {
+    return std::uniform_int_distribution<int>(0, bound - 1)(random);
+}
+
+void
+TetrisGame::emitEffect(const Effect &effect) {
+    effects.push_back(effect);
+}
+
+std::vector<Effect>
+TetrisGame::takeEffects() {
+    return std::exchange(effects, {});
+}
+
 GameMatrix &
 TetrisGame::getGameMatrix() {
     return gameMatrix;
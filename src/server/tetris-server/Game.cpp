@@ -1,8 +1,14 @@
 #include "Game.hpp"
 
-Game::Game(const std::string &ip, const LobbyState &lobbyState,
-           const bool debug)
-    : ip(ip), lobbyState(lobbyState), debug(debug) {
+// how many Game objects there are, whatever their state
+static Gauge &
+gamesGauge() {
+    static Gauge &games = MetricsRegistry::instance().gauge("tetris_games", "Games held by the game server");
+    return games;
+}
+
+Game::Game(const std::string &ip, const LobbyState &lobbyState)
+    : ip(ip), lobbyState(lobbyState) {
     // this is the constructor for the Game class
     // this will be used to create a new game instance, using lobbyState data to
     // initialize the game
@@ -19,6 +25,11 @@ Game::Game(const std::string &ip, const LobbyState &lobbyState,
     if (initializeEngine() != StatusCode::SUCCESS) {
         printMessage("Error initializing engine", MessageType::CRITICAL);
     }
+
+    // so there is an overview before the first update
+    updateOverview();
+
+    gamesGauge().add(1);
 }
 
 Game::~Game() {
@@ -26,6 +37,8 @@ Game::~Game() {
     // this will be used to close the game and free the resources
     // std::lock_guard<std::mutex> lock(runningMutex);
     // if (running) { (void) closeGame(); }
+
+    gamesGauge().add(-1);
 }
 
 StatusCode
@@ -97,6 +110,46 @@ Game::closeGame() {
     return StatusCode::SUCCESS;
 }
 
+bool
+Game::isRunning() {
+    // This method is used to check if the game is still running.
+    // It will return false once the update thread stopped it (everyone left)
+    // or once the game was closed.
+
+    std::lock_guard lock(runningMutex);
+    return running;
+}
+
+std::string
+Game::getGameID() const {
+    // the ID of the lobby the game was started from
+    return gameID;
+}
+
+std::uint64_t
+Game::getTicks() {
+    // how many ticks the game was updated for
+    std::lock_guard lock(gameMutex);
+    return ticks;
+}
+
+void
+Game::evictSession(const std::string &token) {
+    // the lobby server ended this session (its client stopped talking), it
+    // leaves the game as if it asked to
+
+    ServerRequest request;
+    request.method = ServerMethods::LEAVE_GAME;
+    request.params["token"] = token;
+    (void) handleLeaveGame(request);
+}
+
+void
+Game::setPresenceIndex(std::shared_ptr<PresenceIndex> index) {
+    // set by the game server before the game starts
+    presence = std::move(index);
+}
+
 bool
 Game::isSessionInGame(const std::string &token) {
     // This method is used to check if a session is in the game.
@@ -217,6 +270,38 @@ Game::initializeGames() {
         game.second->setPlayerName(lobbyState.players.at(gameToken));
     }
 
+    // every board gets its own seed, so the match can be played again from
+    // the seeds and the inputs alone (the roster is in the order the games
+    // were created in, the opponents of each board depend on it)
+    std::random_device seeds;
+    std::vector<ReplayPlayer> roster;
+    for (const std::string &token: playersToken) {
+        const auto game = games.find(token);
+        if (game == games.end()) {
+            continue; // endless only keeps the first one
+        }
+        const std::uint32_t seed = seeds();
+        game->second->setSeed(seed);
+        replaySeats[token].player = static_cast<std::uint32_t>(roster.size());
+        roster.push_back({game->second->getPlayerName(), seed});
+    }
+    std::vector<std::uint32_t> tickOrder;
+    for (const auto &game: games) {
+        replaySeats[game.first].position = static_cast<std::uint32_t>(tickOrder.size());
+        tickOrder.push_back(replaySeats[game.first].player);
+    }
+
+    const std::string replayDirectory = ReplayWriter::instance().getDirectory();
+    if (!replayDirectory.empty()) {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        replay.emplace(lobbyState.gameMode,
+                       std::chrono::duration_cast<std::chrono::milliseconds>(now).count(),
+                       roster, tickOrder);
+        replayPath = replayDirectory + "/" +
+                     std::to_string(std::chrono::duration_cast<std::chrono::seconds>(now).count()) +
+                     "-" + gameID + ".replay";
+    }
+
     return StatusCode::SUCCESS;
 }
 
@@ -257,6 +342,7 @@ Game::listen() {
 
     // set the game as listening
     std::lock_guard lock(listenMutex);
+    Tracer::instance().setThreadName("game-" + gameID + " requests");
 
     while (true) {
         // first, we need to check if the game is still running
@@ -273,21 +359,33 @@ Game::listen() {
         const ssize_t recvLen = recvfrom(
             gameSocket, buffer, MAX_BUFFER_SIZE, 0,
             reinterpret_cast<struct sockaddr *>(&clientAddr), &clientAddrLen);
+        fragmentReader.expire();
         if (recvLen < 0) {
             continue; // timeout
         }
+        RequestMetrics::instance().received(static_cast<std::size_t>(recvLen));
+
+        // a fragment of a bigger request is kept until the request is whole
+        const std::optional<std::string> requestContent = fragmentReader.feed(
+            FragmentReader::senderKey(clientAddr), buffer, static_cast<std::size_t>(recvLen));
+        if (!requestContent) {
+            continue;
+        }
 
         // handle the request
-        std::string requestContent(buffer, recvLen);
-        std::string responseContent = handleServerRequest(requestContent);
-
-        // send the response
-        const ssize_t sentLen = sendto(
-            gameSocket, responseContent.c_str(), responseContent.size(), 0,
-            reinterpret_cast<struct sockaddr *>(&clientAddr), clientAddrLen);
-        if (sentLen < 0) {
+        std::string responseContent = handleServerRequest(*requestContent);
+
+        // send the response (in several datagrams if it is too big for one)
+        StatusCode sent; {
+            const TraceSpan span("send", "socket");
+            sent = fragmentWriter.send(
+                gameSocket, responseContent,
+                reinterpret_cast<struct sockaddr *>(&clientAddr), clientAddrLen);
+        }
+        if (sent != StatusCode::SUCCESS) {
             continue; // ignore this, player will timeout and try again
         }
+        RequestMetrics::instance().sent(responseContent.size());
     }
 
     return StatusCode::SUCCESS;
@@ -307,7 +405,11 @@ Game::getGame(const std::string &token) {
     // This method is used to get the game of a player.
     // It will return the game of the player with the specified token.
 
-    std::lock_guard lock(gameMutex);
+    std::unique_lock lock(gameMutex, std::defer_lock); {
+        // the tick holds it while it updates every board
+        const TraceSpan span("wait gameMutex", "lock");
+        lock.lock();
+    }
     if (games.contains(token)) {
         return games[token];
     } else {
@@ -322,6 +424,14 @@ Game::updateGame() {
     // frame.
 
     std::lock_guard lock(updateMutex);
+    Tracer::instance().setThreadName("game-" + gameID + " tick");
+
+    // shared by every game of the server
+    static Histogram &tickDuration = MetricsRegistry::instance().histogram(
+        "tetris_game_tick_duration_seconds", "Time to update every board of a game once");
+    static Histogram &tickLateness = MetricsRegistry::instance().histogram(
+        "tetris_game_tick_lateness_seconds", "How much later than GAME_UPDATE_INTERVAL a tick starts");
+    std::optional<std::chrono::steady_clock::time_point> lastTickStart;
 
     while (true) {
         // first, we need to check if the game is still running
@@ -336,9 +446,18 @@ Game::updateGame() {
         // if the game is still running, we can update the game state
         // this will be done in a separate function
 
+        const auto tickStart = std::chrono::steady_clock::now();
+        if (lastTickStart) {
+            tickLateness.record(tickStart - *lastTickStart -
+                                std::chrono::milliseconds(GAME_UPDATE_INTERVAL));
+        }
+        lastTickStart = tickStart;
+
         // update the game state (we lock the game mutex to update the game
         // state)
         {
+            const TraceSpan tickSpan("tick", "game");
+
             // update the games using the engine (if the engine is initialized)
             if (!engine.get()) {
                 printMessage("Engine not initialized", MessageType::CRITICAL);
@@ -348,32 +467,86 @@ Game::updateGame() {
                 // we also fetch the actions from the players, stored in some
                 // action map
 
+                // gameMutex is held for the whole tick : a player leaving
+                // (its request, or the lobby server evicting its session)
+                // erases its board from games, which must not happen while
+                // the loop stands on it
+                std::string replayBytes;
+                std::unique_lock lock_(gameMutex, std::defer_lock); {
+                    // the request threads read the boards under it
+                    const TraceSpan span("wait gameMutex", "lock");
+                    lock_.lock();
+                }
+
                 for (auto &game: games) {
                     // get the action of the player
 
-                    Action currentAction; {
+                    Action currentAction = Action::None;
+                    std::optional<int> currentSequence; {
                         std::lock_guard lock__(actionMutex);
-                        if (actionMap.contains(game.first)) {
-                            currentAction = actionMap[game.first];
-                            actionMap.erase(game.first);
-                        } else {
-                            currentAction = Action::None;
+                        auto queue = actionQueues.find(game.first);
+                        if (queue != actionQueues.end() && !queue->second.empty()) {
+                            currentAction = queue->second.front().action;
+                            currentSequence = queue->second.front().sequence;
+                            queue->second.pop_front();
                         }
                     }
 
                     // update the game state
 
-                    {
-                        std::lock_guard lock_(gameMutex);
+                    if (currentAction != Action::None) {
+                        // once per input on the tick thread : nothing is
+                        // formatted here, the logger's thread does it
+                        Logger::instance().log(MessageType::DEBUG, LogComponent::GAME, gameID,
+                                               "Handling action: ", static_cast<int>(currentAction),
+                                               " from ", game.first);
+                    }
+                    if (replay) {
+                        const ReplaySeat &seat = replaySeats.at(game.first);
                         if (currentAction != Action::None) {
-                            printMessage("Handling action: " + std::to_string(static_cast<int>(currentAction)) + " from " + game.first, MessageType::INFO);
+                            replay->input(ticks, seat.player, currentAction);
                         }
-                        engine->handlingRoutine(*game.second, currentAction);
+                        updatedThisTick = seat.position + 1;
+                    }
+                    engine->handlingRoutine(*game.second, currentAction);
+                    effects.collect(*game.second);
+
+                    // only now is the input part of what getPlayerGameState sends
+                    if (currentSequence) {
+                        std::lock_guard lock__(actionMutex);
+                        lastInputSequence[game.first] = *currentSequence;
                     }
                 }
+
+                // then what the boards did to each other (whatever the order
+                // they were updated in, see Effect.hpp), and the replay gets
+                // to the disk about once a second
+                {
+                    const TraceSpan span("applyEffects", "game");
+                    effects.apply();
+                }
+                ++ticks;
+                updatedThisTick = 0;
+                if (replay && ticks % REPLAY_FLUSH_TICKS == 0) {
+                    replayBytes = replay->take();
+                }
+                lock_.unlock();
+
+                if (!replayBytes.empty()) {
+                    ReplayWriter::instance().append(replayPath, std::move(replayBytes));
+                }
+
+                // the overview doesn't need to follow every tick
+                if (++ticksSinceOverview * GAME_UPDATE_INTERVAL >= OVERVIEW_UPDATE_INTERVAL) {
+                    ticksSinceOverview = 0;
+                    const TraceSpan span("updateOverview", "game");
+                    updateOverview();
+                }
             }
         }
 
+        tickDuration.record(std::chrono::steady_clock::now() - tickStart);
+
         // sleep for a while (thx)
         std::this_thread::sleep_for(std::chrono::milliseconds(GAME_UPDATE_INTERVAL));
 
@@ -386,6 +559,61 @@ Game::updateGame() {
             }
         }
     }
+
+    // the match is over (or the server is closing), so is its replay
+    finishReplay();
+}
+
+void
+Game::finishReplay() {
+    // This method is used to end the replay of the match, with the scores of
+    // whoever is still in it. The rest of the file is written by the
+    // ReplayWriter, which closes it.
+
+    std::string replayBytes; {
+        std::lock_guard lock(gameMutex);
+        if (!replay) {
+            return;
+        }
+
+        std::vector<ReplayScore> scores;
+        for (const auto &game: games) {
+            scores.push_back({replaySeats.at(game.first).player, game.second->getScore(),
+                              game.second->getLinesCleared()});
+        }
+        replay->end(ticks, scores);
+        replayBytes = replay->take();
+        replay.reset();
+    }
+
+    ReplayWriter::instance().append(replayPath, std::move(replayBytes), true);
+}
+
+void
+Game::updateOverview() {
+    // This method is used to rebuild the overview of the game, the skyline of
+    // every board still in it. it is serialized here once, every request for
+    // it until the next rebuild gets the same string
+
+    GameOverview gameOverview;
+
+    {
+        std::lock_guard lock(gameMutex);
+        for (const auto &game: games) {
+            gameOverview.boards.push_back({
+                game.second->getPlayerName(),
+                GameOverview::encodeSkyline(game.second->getGameMatrix().getBoard()),
+                game.second->isGameOver(),
+            });
+        }
+    }
+
+    // same order every time, so the mini-maps don't shuffle around
+    std::ranges::sort(gameOverview.boards, {}, &BoardOverview::username);
+
+    std::string serialized = gameOverview.serialize();
+    std::lock_guard lock(overviewMutex);
+    overview = std::move(serialized);
 }
 
 std::unordered_map<std::string, std::string>
@@ -410,35 +638,9 @@ void
 Game::printMessage(const std::string &message, const MessageType msgtype) const {
     // This method is used to print a message to the console.
     // It will print the message with the specified message type.
-    // this will only print the message if the debug flag is set to true.
+    // this will only print the message if the log level of the game lets it through.
 
-    if (!debug) {
-        return;
-    }
-
-    const std::string gameIdentifier = "[GAME-" + gameID + "] ";
-    std::string messageType;
-
-    switch (msgtype) {
-        case MessageType::INFO:
-            messageType = "[INFO] ";
-            break;
-        case MessageType::WARNING:
-            messageType = "[WARNING] ";
-            break;
-        case MessageType::ERROR:
-            messageType = "[ERROR] ";
-            break;
-        case MessageType::CRITICAL:
-            messageType = "[CRITICAL] ";
-            break;
-        default:
-            messageType = "[UNKNOWN | DEBUG] ";
-            break;
-    }
-
-    const std::string messageToPrint = gameIdentifier + messageType + message;
-    std::cout << messageToPrint << std::endl;
+    Logger::instance().log(msgtype, LogComponent::GAME, gameID, message);
 }
 
 std::string
@@ -452,12 +654,14 @@ Game::handleServerRequest(const std::string &requestContent) {
 
     ServerRequest request;
     try {
+        const TraceSpan span("deserialize", "serialization");
         request = ServerRequest::deserialize(requestContent);
     } catch (std::runtime_error &e) {
         printMessage("Error deserializing request: " + std::string(e.what()),
                      MessageType::ERROR);
         // we use the INVALID ID since we have no way of knowing the ID of the
         // request that failed (not a valid deserializable JSON string)
+        RequestMetrics::instance().deserializeFailed();
         return ServerResponse::ErrorResponse(
                     INVALID_ID, StatusCode::ERROR_DESERIALIZING_REQUEST)
                 .serialize();
@@ -465,25 +669,43 @@ Game::handleServerRequest(const std::string &requestContent) {
 
     // Then, we need to handle the request properly according to its method
     // called
-    printMessage("Handling request [" + getServerMethodString(request.method) +
-                 "]",
-                 MessageType::INFO);
+    Logger::instance().log(MessageType::DEBUG, LogComponent::GAME, gameID,
+                           "Handling request [", getServerMethodString(request.method), "]");
 
+    // until the response is serialized
+    const ScopedTimer timer(RequestMetrics::instance().duration(request.method));
+    const TraceSpan requestSpan(Tracer::methodName(request.method), "request");
+
+    // any request with a token is a heartbeat of its session
+    if (presence && request.params.contains("token")) {
+        (void) presence->touch(request.params.at("token"));
+    }
+
+    ServerResponse response;
     switch (request.method) {
         case ServerMethods::KEY_STROKE:
-            return handleKeyStrokeRequest(request).serialize();
+            response = handleKeyStrokeRequest(request);
+            break;
         case ServerMethods::GET_GAME_STATE:
-            return handleGetGameStateRequest(request).serialize();
+            response = handleGetGameStateRequest(request);
+            break;
+        case ServerMethods::GET_GAME_OVERVIEW:
+            response = handleGetGameOverviewRequest(request);
+            break;
         case ServerMethods::LEAVE_GAME:
-            return handleLeaveGame(request).serialize();
+            response = handleLeaveGame(request);
+            break;
         default:
             printMessage("Request [" + getServerMethodString(request.method) +
                          "] not implemented",
                          MessageType::ERROR);
-            return ServerResponse::ErrorResponse(request.id,
-                                                 StatusCode::ERROR_NOT_IMPLEMENTED)
-                    .serialize();
+            response = ServerResponse::ErrorResponse(request.id,
+                                                     StatusCode::ERROR_NOT_IMPLEMENTED);
+            break;
     }
+
+    const TraceSpan span("serialize response", "serialization");
+    return response.serialize();
 }
 
 ServerResponse
@@ -531,15 +753,19 @@ Game::handleKeyStroke(const KeyStrokePacket &packet,
     // this function will handle the key stroke
     // it will handle the key stroke and update the game state
 
-    printMessage("Handling key stroke: " +
-                 std::to_string(static_cast<int>(packet.action)) +
-                 " from " + packet.token,
-                 MessageType::INFO);
+    Logger::instance().log(MessageType::DEBUG, LogComponent::GAME, gameID,
+                           "Handling key stroke: ", static_cast<int>(packet.action),
+                           " from ", packet.token);
 
-    // update the action map
+    // queue the action, it will be applied on one of the next ticks
+    const Action action = getActionFromKeyStroke(packet);
     {
         std::lock_guard lock(actionMutex);
-        actionMap[packet.token] = getActionFromKeyStroke(packet);
+        std::deque<QueuedAction> &queue = actionQueues[packet.token];
+        queue.push_back({action, packet.sequence});
+        if (queue.size() > MAX_QUEUED_ACTIONS) {
+            queue.pop_front();
+        }
     }
 
     return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS);
@@ -561,6 +787,23 @@ Game::handleGetGameStateRequest(const ServerRequest &request) {
                    {{"gamestate", gameStateContent}});
 }
 
+ServerResponse
+Game::handleGetGameOverviewRequest(const ServerRequest &request) {
+    // this function will handle the get game overview request, for the
+    // players and the spectators of this game only
+
+    const std::string token = request.params.at("token");
+    if (!isSessionInGame(token)) {
+        printMessage("Unknown token asked for the overview", MessageType::ERROR);
+        return ServerResponse::ErrorResponse(request.id,
+                                             StatusCode::ERROR_GETTING_GAME_STATE);
+    }
+
+    std::lock_guard lock(overviewMutex);
+    return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS,
+                                           {{"overview", overview}});
+}
+
 std::string Game::getGameState(const std::string &token) {
 
     // this function will get the game state
@@ -615,6 +858,23 @@ std::string Game::getPlayerGameState(const std::string &token) {
                                  : std::vector<std::vector<int>>();
     playerState.targetUsername = (target) ? target->getPlayerName() : DEFAULT_NAME;
 
+    // the falling piece, so the client can move it itself before we answer
+    if (const Tetromino *current = game->getGameMatrix().getCurrent()) {
+        playerState.currentTetro = current->getPieceType();
+        playerState.currentPosition = current->getPosition();
+        playerState.currentShape = current->getShape();
+    }
+    playerState.controlsReversed = game->getReverseControlsFlag();
+    playerState.controlsBlocked = game->getBlockControlsFlag();
+
+    {
+        std::lock_guard lock(actionMutex);
+        if (lastInputSequence.contains(token)) {
+            playerState.lastInputSequence = lastInputSequence.at(token);
+        }
+    }
+
+    const TraceSpan span("serialize PlayerState", "serialization");
     return playerState.serialize();
 }
 
@@ -677,11 +937,14 @@ Game::removePlayerFromGame(const ServerRequest& request) {
     }
 
     {
-        // remove the player from the action map
+        // remove the player from the action queues
         std::lock_guard lock(actionMutex);
-        if (actionMap.contains(request.params.at("token"))) {
-            actionMap.erase(request.params.at("token"));
-        }
+        actionQueues.erase(request.params.at("token"));
+        lastInputSequence.erase(request.params.at("token"));
+    }
+
+    if (presence) {
+        presence->leave(request.params.at("token"), gameID);
     }
 
     {
@@ -690,17 +953,23 @@ Game::removePlayerFromGame(const ServerRequest& request) {
         std::shared_ptr<TetrisGame> playerGame = getGame(request.params.at("token"));
         TetrisGame *playerGamePointer = playerGame.get();
 
+        // gone from every game at once, between two ticks (the tick holds
+        // gameMutex) : that's where the replay says it left
+        std::lock_guard lock(gameMutex);
+
         // remove the player from every game it's an opponent in
         for (auto &game : games) {
-            {
-                // remove the player from the game
-                std::lock_guard lock(gameMutex);
-                game.second->removeOpponent(playerGamePointer);
-            }
+            game.second->removeOpponent(playerGamePointer);
+        }
+        effects.forget(playerGamePointer);
+
+        const auto seat = replaySeats.find(request.params.at("token"));
+        if (replay && playerGame && seat != replaySeats.end()) {
+            replay->leave(ticks, updatedThisTick,
+                          {seat->second.player, playerGame->getScore(), playerGame->getLinesCleared()});
         }
 
         // delete the game (at last)
-        std::lock_guard lock(gameMutex);
         games.erase(request.params.at("token"));
 
 
@@ -723,11 +992,13 @@ Game::removeSpectatorFromGame(const ServerRequest& request) {
     }
 
     {
-        // remove the spectator from the action map
+        // remove the spectator from the action queues
         std::lock_guard lock(actionMutex);
-        if (actionMap.contains(request.params.at("token"))) {
-            actionMap.erase(request.params.at("token"));
-        }
+        actionQueues.erase(request.params.at("token"));
+    }
+
+    if (presence) {
+        presence->leave(request.params.at("token"), gameID);
     }
 
     return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS);
@@ -1,9 +1,8 @@
 #include "GameServer.hpp"
 
 GameServer::GameServer(const std::string &ip,
-                       const std::shared_ptr<LobbyServer> &lobbyServer,
-                       const bool debug)
-    : ip(ip), lobbyServer(lobbyServer), debug(debug) {
+                       const std::shared_ptr<LobbyServer> &lobbyServer)
+    : ip(ip), lobbyServer(lobbyServer) {
     // this is the constructor for the GameServer class
     // this will be used to create a new game server instance, using the
     // lobbyServer data to initialize the game server
@@ -89,6 +88,27 @@ GameServer::isSessionInAnyGame(const std::string &token) {
     return false;
 }
 
+void
+GameServer::evictSession(const std::string &token, const std::string &gameID) {
+    // This method is used to take an expired session out of its game.
+    // The game is found under the lock, left without it (leaving takes the
+    // game's own locks).
+
+    std::shared_ptr<Game> game; {
+        std::lock_guard lock(gamesMutex);
+        for (const auto &activeGame: activeGames) {
+            if (activeGame->getGameID() == gameID) {
+                game = activeGame;
+                break;
+            }
+        }
+    }
+
+    if (game && game->isSessionInGame(token)) {
+        game->evictSession(token);
+    }
+}
+
 int
 GameServer::countGames() {
     // This method is used to count the number of games in the game server.
@@ -124,6 +144,9 @@ GameServer::listen() {
             }
         }
 
+        // the games everyone left make room for the new ones
+        reapGames();
+
         // if the game server is still running, we can get the ready lobbies and
         // the empty lobbies
         std::vector<std::shared_ptr<Lobby> > readyLobbies =
@@ -167,7 +190,8 @@ GameServer::startGame(const std::shared_ptr<Lobby> &lobby) {
 
     // create the game
     LobbyState lobbyState = lobby->getState();
-    const auto game = std::make_shared<Game>(ip, lobbyState, debug);
+    const auto game = std::make_shared<Game>(ip, lobbyState);
+    game->setPresenceIndex(lobbyServer->getPresenceIndex());
 
     // close the lobby
     if (lobbyServer->closeLobby(lobbyState.lobbyID) != StatusCode::SUCCESS) {
@@ -184,6 +208,15 @@ GameServer::startGame(const std::shared_ptr<Lobby> &lobby) {
         return;
     }
 
+    // closing the lobby sent everyone back to the menu, they are in the game
+    const std::shared_ptr<PresenceIndex> presence = lobbyServer->getPresenceIndex();
+    for (const auto &[token, username]: lobbyState.players) {
+        presence->enter(token, ClientStatus::IN_GAME, lobbyState.lobbyID);
+    }
+    for (const auto &[token, username]: lobbyState.spectators) {
+        presence->enter(token, ClientStatus::IN_GAME, lobbyState.lobbyID);
+    }
+
     // add the game to the list of active games
     activeGames.push_back(game);
 
@@ -191,42 +224,61 @@ GameServer::startGame(const std::shared_ptr<Lobby> &lobby) {
 }
 
 void
-GameServer::printMessage(const std::string &message, MessageType msgType) const {
-    // This method is used to print a message to the console.
-    // It will print the message with the specified message type
-    // only if the debug flag is set to true.
-
-    if (!debug) {
-        return;
+GameServer::reapGames() {
+    // This method is used to close the games that stopped running (every
+    // player left), so they don't stay in activeGames forever. Their threads
+    // are joined, their socket closed (so the port can be used by another
+    // lobby), and the game is freed once nobody holds it anymore.
+
+    static Counter &finishedGames = MetricsRegistry::instance().counter(
+        "tetris_games_finished_total", "Games that ended and were reaped by the game server");
+
+    // taken out under the lock, closed without it : closing waits for the
+    // game's threads, isSessionInAnyGame shouldn't wait with it
+    std::vector<std::shared_ptr<Game> > finished; {
+        std::lock_guard lock(gamesMutex);
+        std::erase_if(activeGames, [&finished](const std::shared_ptr<Game> &game) {
+            if (game->isRunning()) {
+                return false;
+            }
+            finished.push_back(game);
+            return true;
+        });
     }
 
-    const std::string gameIdentifier = "[Game Server] ";
-    std::string msgtype_str;
-
-    switch (msgType) {
-        case MessageType::INFO:
-            msgtype_str = "INFO";
-            break;
-
-        case MessageType::WARNING:
-            msgtype_str = "WARNING";
-            break;
+    for (const auto &game: finished) {
+        if (game->closeGame() != StatusCode::SUCCESS) {
+            printMessage("Error closing game: " + game->getGameID(),
+                         MessageType::ERROR);
+        }
+        finishedGames.increment();
+        Logger::instance().log(MessageType::INFO, LogComponent::GAME_SERVER, game->getGameID(),
+                               "Game finished after ", game->getTicks(), " ticks");
 
-        case MessageType::ERROR:
-            msgtype_str = "ERROR";
-            break;
+        std::vector<GameFinishedCallback> callbacks; {
+            std::lock_guard lock(callbacksMutex);
+            callbacks = finishedCallbacks;
+        }
+        for (const auto &callback: callbacks) {
+            callback(game->getGameID());
+        }
+    }
+}
 
-        case MessageType::CRITICAL:
-            msgtype_str = "CRITICAL";
-            break;
+void
+GameServer::onGameFinished(GameFinishedCallback callback) {
+    // This method is used to be told about the games reapGames closed (the
+    // lobby server cleans up after them)
 
-        default:
-            msgtype_str = "UNKNOWN | DEBUG";
-            break;
-    }
+    std::lock_guard lock(callbacksMutex);
+    finishedCallbacks.push_back(std::move(callback));
+}
 
-    std::cout << gameIdentifier << "[" << msgtype_str << "] " << message
-            << std::endl;
+void
+GameServer::printMessage(const std::string &message, MessageType msgType) const {
+    // This method is used to print a message to the console.
+    // It will print the message with the specified message type,
+    // if the log level of the game server lets it through.
 
-    return;
+    Logger::instance().log(msgType, LogComponent::GAME_SERVER, "", message);
 }
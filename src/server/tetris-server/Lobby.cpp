@@ -1,18 +1,27 @@
 #include "Lobby.hpp"
 
+// how many Lobby objects there are, whatever their state
+static Gauge &
+lobbiesGauge() {
+    static Gauge &lobbies = MetricsRegistry::instance().gauge("tetris_lobbies", "Lobbies held by the lobby server");
+    return lobbies;
+}
+
 Lobby::Lobby(const std::string &IPAddr, const int port,
              const std::string &lobbyID, const GameMode gameMode,
-             const int maxPlayers, const bool isPublic, const bool debug)
+             const int maxPlayers, const bool isPublic)
     : ip(IPAddr), port(port), lobbyID(lobbyID), gameMode(gameMode),
-      maxPlayers(maxPlayers), isPublic(isPublic), debug(debug) {
+      maxPlayers(maxPlayers), isPublic(isPublic) {
     // this is the constructor for the lobby, I'll leave it blank for now
     // but we might want to do some stuff here later
+    lobbiesGauge().add(1);
 }
 
 Lobby::~Lobby() {
     // close the socket (does that even work if the socket is not open?)
     // std::lock_guard<std::mutex> lock(runningMutex);
     // if (running) { (void) closeLobby(); }
+    lobbiesGauge().add(-1);
 }
 
 StatusCode
@@ -102,6 +111,11 @@ Lobby::addPlayer(const std::string &sessionToken, const std::string &username) {
     players[sessionToken] = username;
     readyPlayers[sessionToken] = false;
 
+    if (presence) {
+        presence->enter(sessionToken, ClientStatus::IN_LOBBY, lobbyID);
+    }
+    markListingDirty();
+
     // if the player is the first one to join, we set the hasEverBeenJoined flag
     if (!getHasEverBeenJoined()) {
         setHasEverBeenJoined(true);
@@ -131,6 +145,11 @@ Lobby::removePlayer(const std::string &sessionToken) {
     players.erase(sessionToken);
     readyPlayers.erase(sessionToken);
 
+    if (presence) {
+        presence->leave(sessionToken, lobbyID);
+    }
+    markListingDirty();
+
     printMessage("Player " + sessionToken + " removed from the lobby",
                  MessageType::INFO);
     return StatusCode::SUCCESS;
@@ -155,6 +174,11 @@ Lobby::addSpectator(const std::string &sessionToken,
     // if we get here, we can add the spectator to the lobby
     spectators[sessionToken] = username;
 
+    if (presence) {
+        presence->enter(sessionToken, ClientStatus::IN_LOBBY, lobbyID);
+    }
+    markListingDirty();
+
     // if the spectator is the first one to join, we set the hasEverBeenJoined flag
     if (!getHasEverBeenJoined()) {
         setHasEverBeenJoined(true);
@@ -183,11 +207,30 @@ Lobby::removeSpectator(const std::string &sessionToken) {
     // remove the spectator from the lobby
     spectators.erase(sessionToken);
 
+    if (presence) {
+        presence->leave(sessionToken, lobbyID);
+    }
+    markListingDirty();
+
     printMessage("Spectator " + sessionToken + " removed from the lobby",
                  MessageType::INFO);
     return StatusCode::SUCCESS;
 }
 
+void
+Lobby::setPresenceIndex(std::shared_ptr<PresenceIndex> index) {
+    // set by the lobby server right after creating the lobby
+    std::lock_guard lock(stateMutex);
+    presence = std::move(index);
+}
+
+void
+Lobby::setLobbyListing(std::shared_ptr<LobbyListing> lobbyListing) {
+    // set by the lobby server right after creating the lobby
+    std::lock_guard lock(stateMutex);
+    listing = std::move(lobbyListing);
+}
+
 LobbyState
 Lobby::getState() {
     // This method is used to get the state of the lobby.
@@ -407,21 +450,30 @@ Lobby::listen() {
         const ssize_t recvLen = recvfrom(
             lobbySocket, buffer, MAX_BUFFER_SIZE, 0,
             reinterpret_cast<struct sockaddr *>(&clientAddr), &clientAddrLen);
+        fragmentReader.expire();
         if (recvLen < 0) {
             continue; // timeout
         }
+        RequestMetrics::instance().received(static_cast<std::size_t>(recvLen));
+
+        // a fragment of a bigger request is kept until the request is whole
+        const std::optional<std::string> requestContent = fragmentReader.feed(
+            FragmentReader::senderKey(clientAddr), buffer, static_cast<std::size_t>(recvLen));
+        if (!requestContent) {
+            continue;
+        }
 
         // handle the request
-        std::string requestContent(buffer, recvLen);
-        std::string responseContent = handleRequest(requestContent);
+        std::string responseContent = handleRequest(*requestContent);
 
-        // send the response
-        const ssize_t sentLen = sendto(
-            lobbySocket, responseContent.c_str(), responseContent.size(), 0,
+        // send the response (in several datagrams if it is too big for one)
+        const StatusCode sent = fragmentWriter.send(
+            lobbySocket, responseContent,
             reinterpret_cast<struct sockaddr *>(&clientAddr), clientAddrLen);
-        if (sentLen < 0) {
+        if (sent != StatusCode::SUCCESS) {
             continue; // ignore this, player will timeout and try again
         }
+        RequestMetrics::instance().sent(responseContent.size());
     }
 
     return StatusCode::SUCCESS;
@@ -431,35 +483,9 @@ void
 Lobby::printMessage(const std::string &message, const MessageType msgtype) const {
     // This method is used to print a message to the console.
     // It will print the message with the specified message type.
-    // this will only print the message if the debug flag is set to true.
-
-    if (!debug) {
-        return;
-    }
-
-    const std::string lobbyIdentifier = "[LOBBY-" + lobbyID + "] ";
-    std::string messageType;
-
-    switch (msgtype) {
-        case MessageType::INFO:
-            messageType = "[INFO] ";
-            break;
-        case MessageType::WARNING:
-            messageType = "[WARNING] ";
-            break;
-        case MessageType::ERROR:
-            messageType = "[ERROR] ";
-            break;
-        case MessageType::CRITICAL:
-            messageType = "[CRITICAL] ";
-            break;
-        default:
-            messageType = "[UNKNOWN | DEBUG] ";
-            break;
-    }
+    // this will only print the message if the log level of the lobby lets it through.
 
-    const std::string messageToPrint = lobbyIdentifier + messageType + message;
-    std::cout << messageToPrint << std::endl;
+    Logger::instance().log(msgtype, LogComponent::LOBBY, lobbyID, message);
 }
 
 std::string
@@ -479,14 +505,23 @@ Lobby::handleRequest(const std::string &requestContent) {
                      MessageType::ERROR);
         // we use the INVALID ID since we have no way of knowing the ID of the
         // request that failed (not a valid deserializable JSON string)
+        RequestMetrics::instance().deserializeFailed();
         return ServerResponse::ErrorResponse(
                     INVALID_ID, StatusCode::ERROR_DESERIALIZING_REQUEST)
                 .serialize();
     }
 
-    printMessage("Handling request [" + getServerMethodString(request.method) +
-                 "]",
-                 MessageType::INFO);
+    Logger::instance().log(MessageType::DEBUG, LogComponent::LOBBY, lobbyID,
+                           "Handling request [", getServerMethodString(request.method), "]");
+
+    // until the response is serialized, whichever case returns it
+    const ScopedTimer timer(RequestMetrics::instance().duration(request.method));
+    const TraceSpan span(Tracer::methodName(request.method), "request");
+
+    // any request with a token is a heartbeat of its session
+    if (presence && request.params.contains("token")) {
+        (void) presence->touch(request.params.at("token"));
+    }
 
     // Then, we need to handle the request properly according to its method
     // called and return the response to the client.
@@ -577,6 +612,7 @@ Lobby::handleReadyRequest(const ServerRequest &request) {
 
     // if we get here, we can set the player as ready
     readyPlayers[request.params.at("token")] = true;
+    markListingDirty();
     printMessage("Player " + request.params.at("token") + " is ready",
                  MessageType::INFO);
     return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS);
@@ -604,12 +640,21 @@ Lobby::handleUnreadyRequest(const ServerRequest &request) {
 
     // if we get here, we can set the player as unready
     readyPlayers[request.params.at("token")] = false;
+    markListingDirty();
     printMessage("Player " + request.params.at("token") + " is unready",
                  MessageType::INFO);
     return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS);
 }
 
 
+void
+Lobby::markListingDirty() const {
+    // the state changed, the public listing has to be rebuilt
+    if (listing) {
+        listing->markDirty();
+    }
+}
+
 void
 Lobby::setHasEverBeenJoined(const bool flag) {
     // This method is used to set the hasEverBeenJoined flag of the lobby.
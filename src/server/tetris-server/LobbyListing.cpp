@@ -0,0 +1,125 @@
+#include "LobbyListing.hpp"
+
+#include <algorithm>
+#include <random>
+
+LobbyListing::LobbyListing() {
+    // the first version is random, so a client that kept the version of a
+    // previous run of the server doesn't take the new listing for its own
+    std::random_device rd;
+    std::mt19937 generator(rd());
+    std::uniform_int_distribution<int> distribution(0, MAX_VERSION - 1);
+    version = distribution(generator);
+}
+
+void
+LobbyListing::markDirty() {
+    // this is called whenever a lobby is created, closed or changes
+    dirty = true;
+}
+
+void
+LobbyListing::refresh(const std::function<std::vector<LobbyState>()> &collect) {
+    // this method is used to rebuild the pages of the listing, if a lobby
+    // changed since the last time
+
+    if (!dirty.exchange(false)) {
+        return;
+    }
+
+    // a change that happens while we collect marks the listing dirty again,
+    // and the next request picks it up
+    std::vector<LobbyState> states = collect();
+    std::sort(states.begin(), states.end(),
+              [](const LobbyState &a, const LobbyState &b) {
+                  return a.lobbyID < b.lobbyID;
+              });
+
+    // the lobbies of every filter, serialized once
+    std::map<int, std::vector<std::string>> lobbies;
+    lobbies[ALL_MODES] = {};
+    for (const LobbyState &state: states) {
+        std::string serialized = state.serialize();
+        lobbies[static_cast<int>(state.gameMode)].push_back(serialized);
+        lobbies[ALL_MODES].push_back(std::move(serialized));
+    }
+
+    std::map<int, std::vector<std::string>> newPages;
+    for (const auto &[filter, serializedLobbies]: lobbies) {
+        newPages[filter] = paginate(serializedLobbies);
+    }
+
+    std::lock_guard lock(listingMutex);
+
+    // nothing visible changed (a private lobby, or the same state again)
+    if (newPages == pages) {
+        return;
+    }
+
+    pages = std::move(newPages);
+    version = (version + 1) % MAX_VERSION;
+}
+
+LobbyListing::Page
+LobbyListing::getPage(const std::optional<GameMode> gameMode, const int page,
+                      const int knownVersion) const {
+    // this method is used to get one page of the listing. a page past the
+    // end is empty (the client asked for it before the listing shrunk)
+
+    std::lock_guard lock(listingMutex);
+
+    Page result;
+    result.version = version;
+
+    if (knownVersion == version) {
+        result.notModified = true;
+        return result;
+    }
+
+    const int filter = gameMode ? static_cast<int>(*gameMode) : ALL_MODES;
+    const auto it = pages.find(filter);
+    if (it == pages.end()) {
+        result.pageCount = 1; // no lobby with this game mode, one empty page
+        return result;
+    }
+
+    result.pageCount = static_cast<int>(it->second.size());
+    if (page >= 0 && page < result.pageCount) {
+        result.lobbies = it->second[static_cast<std::size_t>(page)];
+    }
+
+    return result;
+}
+
+int
+LobbyListing::getVersion() const {
+    std::lock_guard lock(listingMutex);
+    return version;
+}
+
+std::vector<std::string>
+LobbyListing::paginate(const std::vector<std::string> &lobbies) {
+    // this method is used to split serialized lobby states in json arrays of
+    // at most LOBBY_LIST_PAGE_BYTES (except a lobby that is bigger on its
+    // own). an empty listing still has one empty page
+
+    std::vector<std::string> result;
+    std::string current = "[";
+
+    for (const std::string &lobby: lobbies) {
+        const bool empty = current.size() == 1;
+        if (!empty && current.size() + lobby.size() + 2 >
+                      static_cast<std::size_t>(LOBBY_LIST_PAGE_BYTES)) {
+            result.push_back(current + "]");
+            current = "[";
+        }
+
+        if (current.size() > 1) {
+            current += ",";
+        }
+        current += lobby;
+    }
+
+    result.push_back(current + "]");
+    return result;
+}
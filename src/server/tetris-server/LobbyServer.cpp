@@ -1,8 +1,10 @@
 #include "LobbyServer.hpp"
 
 LobbyServer::LobbyServer(const std::string &IPAddr, const int listenPort,
-                         const bool debug)
-    : ip(IPAddr), port(listenPort), debug(debug) {
+                         const int maxSessions)
+    : ip(IPAddr), port(listenPort), maxSessions(maxSessions),
+      presence(std::make_shared<PresenceIndex>()),
+      listing(std::make_shared<LobbyListing>()) {
     // this is the constructor for the lobby server, I'll leave it blank for now
     // but we might want to do some stuff here later
 }
@@ -83,12 +85,10 @@ LobbyServer::closeLobbyServer() {
         lobbies.clear();
         lobbyObjects.clear();
     }
+    listing->markDirty();
 
     // and finally, we clear the client sessions
-    {
-        std::lock_guard lock(clientMutex);
-        clientTokens.clear();
-    }
+    presence->clear();
 
     printMessage("Lobby Server closed", MessageType::INFO);
     return StatusCode::SUCCESS;
@@ -100,59 +100,44 @@ LobbyServer::setGameServer(std::shared_ptr<GameServer> gameServer) {
     this->gameServer = std::move(gameServer);
 }
 
+void
+LobbyServer::handleGameFinished(const std::string &gameID) {
+    // whoever is still in the game (its spectators, or players whose leave
+    // never came) is back to the menu
+
+    presence->leaveAll(gameID, ClientStatus::IN_GAME);
+    Logger::instance().log(MessageType::DEBUG, LogComponent::LOBBY_SERVER, gameID,
+                           "Game finished, its sessions are back to the menu");
+}
+
 StatusCode
 LobbyServer::addClientSession(const std::string &token,
                               const std::string &username) {
     // this method is used to add a client session to the lobby server
 
-    // we check if the maximum number of players is reached
-    if (countPlayers() >= MAX_SESSIONS) {
-        printMessage("Maximum number of players reached", MessageType::ERROR);
-        return StatusCode::ERROR_MAX_PLAYERS_REACHED;
-    }
+    // the index checks that the token is new and that there is room left. if
+    // some session exists with the same username, it is replaced and we get
+    // a slightly different success code
+    const StatusCode status = presence->addSession(
+        token, username, static_cast<std::size_t>(std::max(maxSessions, 0)));
 
-    std::lock_guard lock(clientMutex);
-    const auto it = clientTokens.find(token);
-
-    // we check if the session already exists
-    if (it != clientTokens.end()) {
+    if (status == StatusCode::ERROR_MAX_PLAYERS_REACHED) {
+        printMessage("Maximum number of players reached", MessageType::ERROR);
+    } else if (status == StatusCode::ERROR_SESSION_ALREADY_EXISTS) {
         printMessage("Session already exists", MessageType::ERROR);
-        return StatusCode::ERROR_SESSION_ALREADY_EXISTS;
-    }
-
-    // we also check if some session exists with the same username.
-    // if it does, we remove it and return a slightly different success code
-    bool found = false;
-    // Shadowing - (smart, thx mihai)
-    for (auto it_ = clientTokens.begin(); it_ != clientTokens.end();) {
-        if (it_->second == username) {
-            found = true;
-            it_ = clientTokens.erase(it_);
-        } else {
-            ++it_;
-        }
     }
 
-    // finally, we add the session to the lobby server
-    clientTokens[token] = username;
-
-    return found ? StatusCode::SUCCESS_REPLACED_SESSION : StatusCode::SUCCESS;
+    return status;
 }
 
 StatusCode
 LobbyServer::removeClientSession(const std::string &token) {
-    // we lock the mutex
-    std::lock_guard lock(clientMutex);
-    const auto it = clientTokens.find(token);
-
-    // we check if the session exists
-    if (it == clientTokens.end()) {
+    // we check if the session exists, and remove it if it does
+    if (!presence->removeSession(token)) {
         printMessage("Session not found", MessageType::ERROR);
         return StatusCode::ERROR_SESSION_NOT_FOUND;
     }
 
-    // if it exists, we remove it
-    clientTokens.erase(it);
     return StatusCode::SUCCESS;
 }
 
@@ -161,12 +146,12 @@ LobbyServer::getClientSessionUsername(const std::string &token) const {
     // this is used to get the username of a session using the token
     // will throw an error if the session is not found
 
-    if (!isSessionActive(token)) {
+    const std::optional<std::string> username = presence->getUsername(token);
+    if (!username) {
         throw std::runtime_error("Session [" + token + "] is not active");
     }
 
-    std::lock_guard lock(clientMutex);
-    return clientTokens.at(token);
+    return *username;
 }
 
 std::string
@@ -174,21 +159,19 @@ LobbyServer::getClientSessionToken(const std::string &username) const {
     // this is used to get the token of a session using the username
     // will throw an error if the session is not found
 
-    if (!doesUserHaveSession(username)) {
+    const std::optional<std::string> token = presence->getToken(username);
+    if (!token) {
         throw std::runtime_error("User [" + username +
                                  "] does not have a session");
     }
 
-    std::lock_guard lock(clientMutex);
+    return *token;
+}
 
-    std::string foundToken;
-    for (const auto &[token, name]: clientTokens) {
-        if (name == username) {
-            foundToken = token;
-            break;
-        }
-    }
-    return foundToken;
+std::shared_ptr<PresenceIndex>
+LobbyServer::getPresenceIndex() const {
+    // the lobbies and the games keep it up to date
+    return presence;
 }
 
 std::shared_ptr<Lobby>
@@ -241,6 +224,11 @@ LobbyServer::closeLobby(const std::string &lobbyID) {
         lobbyObjects.erase(lobbyID);
     }
 
+    // whoever is still in there is back to the menu (if the lobby became a
+    // game, the game server moves them to it right after)
+    presence->leaveAll(lobbyID, ClientStatus::IN_LOBBY);
+    listing->markDirty();
+
     // and we close the lobby
     return lobby->closeLobby();
 }
@@ -248,8 +236,12 @@ LobbyServer::closeLobby(const std::string &lobbyID) {
 int
 LobbyServer::countPlayers() const {
     // count players in the lobby server
-    std::lock_guard lock(clientMutex);
-    return static_cast<int>(clientTokens.size());
+    return static_cast<int>(presence->size());
+}
+
+int
+LobbyServer::getMaxSessions() const {
+    return maxSessions;
 }
 
 int
@@ -317,7 +309,8 @@ LobbyServer::getPublicLobbies() const {
 
     // we iterate through the lobbies and add the public ones to the vector
     for (auto &[lobbyID, lobby]: lobbyObjects) {
-        printMessage("Checking lobby [" + lobbyID + "]", MessageType::INFO);
+        Logger::instance().log(MessageType::DEBUG, LogComponent::LOBBY_SERVER, "",
+                               "Checking lobby [", lobbyID, "]");
         if (lobby->isLobbyPublic()) {
             publicLobbies.push_back(lobby);
         }
@@ -351,21 +344,31 @@ LobbyServer::listen() {
         const ssize_t recvLen = recvfrom(
             serverSocket, buffer, MAX_BUFFER_SIZE, 0,
             reinterpret_cast<struct sockaddr *>(&clientAddr), &clientAddrLen);
+        fragmentReader.expire();
+        reapIdleSessions();
         if (recvLen < 0) {
             continue; // timeout
         }
+        RequestMetrics::instance().received(static_cast<std::size_t>(recvLen));
+
+        // a fragment of a bigger request is kept until the request is whole
+        const std::optional<std::string> requestContent = fragmentReader.feed(
+            FragmentReader::senderKey(clientAddr), buffer, static_cast<std::size_t>(recvLen));
+        if (!requestContent) {
+            continue;
+        }
 
         // handle the request
-        std::string requestContent(buffer, recvLen);
-        std::string responseContent = handleRequest(requestContent);
+        std::string responseContent = handleRequest(*requestContent);
 
-        // send the response
-        const ssize_t sentLen = sendto(
-            serverSocket, responseContent.c_str(), responseContent.size(), 0,
+        // send the response (in several datagrams if it is too big for one)
+        const StatusCode sent = fragmentWriter.send(
+            serverSocket, responseContent,
             reinterpret_cast<struct sockaddr *>(&clientAddr), clientAddrLen);
-        if (sentLen < 0) {
+        if (sent != StatusCode::SUCCESS) {
             continue; // ignore this, player will timeout and try again
         }
+        RequestMetrics::instance().sent(responseContent.size());
     }
 
     // bye bye listen thread uwu <3
@@ -438,58 +441,51 @@ LobbyServer::getLobbies() const {
 bool
 LobbyServer::isSessionActive(const std::string &token) const {
     // this is used to check if a session is active
-    std::lock_guard lock(clientMutex);
-    return clientTokens.contains(token);
+    return presence->hasToken(token);
 }
 
 bool
 LobbyServer::doesUserHaveSession(const std::string &username) const {
     // this is used to check if a user has a session
-    std::lock_guard lock(clientMutex);
-    return std::any_of(clientTokens.begin(), clientTokens.end(),
-                       [&username](const auto &pair) { return pair.second == username; });
+    return presence->hasSession(username);
+}
+
+void
+LobbyServer::reapIdleSessions() {
+    // this is called by the listen thread at least once a second (the socket
+    // times out after LOBBY_TIMEOUT_SEC). the presence index only looks at
+    // the sessions whose deadline came since the last call, so it's cheap
+
+    static Counter &expiredSessions = MetricsRegistry::instance().counter(
+        "tetris_sessions_expired_total", "Sessions ended because their client stopped talking");
+
+    for (const PresenceIndex::Expired &session: presence->expire()) {
+        expiredSessions.increment();
+        Logger::instance().log(MessageType::INFO, LogComponent::LOBBY_SERVER, "",
+                               "Session of ", session.username, " expired");
+
+        // the session is already gone from the index, its lobby / game still
+        // has it as a player or a spectator
+        if (session.status == ClientStatus::IN_LOBBY) {
+            if (const std::shared_ptr<Lobby> lobby = getLobby(session.placeID)) {
+                (void) lobby->removePlayer(session.token);
+                (void) lobby->removeSpectator(session.token);
+            }
+        } else if (session.status == ClientStatus::IN_GAME && gameServer) {
+            gameServer->evictSession(session.token, session.placeID);
+        }
+    }
 }
 
 void
 LobbyServer::printMessage(const std::string &message,
                           const MessageType msgtype) const {
     // this method is used to print messages to the console
-    // it will only print if the debug flag is set to true
-    // and will print the message with the appropriate type
-    // and identifier
-
-    if (!debug) {
-        return;
-    }
-
-    const std::string lobbyIdentifier = "[Lobby Server] ";
-    std::string msgtype_str;
-
-    switch (msgtype) {
-        case MessageType::INFO:
-            msgtype_str = "INFO";
-            break;
-
-        case MessageType::WARNING:
-            msgtype_str = "WARNING";
-            break;
-
-        case MessageType::ERROR:
-            msgtype_str = "ERROR";
-            break;
+    // it will only print if the log level of the lobby server
+    // lets it through, and will print the message with the
+    // appropriate type and identifier
 
-        case MessageType::CRITICAL:
-            msgtype_str = "CRITICAL";
-            break;
-
-        default:
-            msgtype_str = "UNKNOWN | DEBUG";
-            break;
-    }
-
-    const std::string messageToPrint =
-            lobbyIdentifier + "[" + msgtype_str + "] " + message;
-    std::cout << messageToPrint << std::endl;
+    Logger::instance().log(msgtype, LogComponent::LOBBY_SERVER, "", message);
 }
 
 std::string
@@ -605,14 +601,23 @@ LobbyServer::handleRequest(const std::string &requestData) {
         request = ServerRequest::deserialize(requestData);
     } catch (std::runtime_error &e) {
         printMessage(std::string(e.what()), MessageType::ERROR);
+        RequestMetrics::instance().deserializeFailed();
         return ServerResponse::ErrorResponse(
                     INVALID_ID, StatusCode::ERROR_DESERIALIZING_REQUEST)
                 .serialize();
     }
 
-    printMessage("Handling request [" + getServerMethodString(request.method) +
-                 "]",
-                 MessageType::INFO);
+    Logger::instance().log(MessageType::DEBUG, LogComponent::LOBBY_SERVER, "",
+                           "Handling request [", getServerMethodString(request.method), "]");
+
+    // until the response is serialized, whichever case returns it
+    const ScopedTimer timer(RequestMetrics::instance().duration(request.method));
+    const TraceSpan span(Tracer::methodName(request.method), "request");
+
+    // any request with a token is a heartbeat of its session
+    if (request.params.contains("token")) {
+        (void) presence->touch(request.params.at("token"));
+    }
 
     // then we handle the request properly according to its method called
     // and return the response to the client
@@ -621,6 +626,9 @@ LobbyServer::handleRequest(const std::string &requestData) {
         case ServerMethods::GET_CLIENT_STATUS:
             return handleGetClientStatusRequest(request).serialize();
 
+        case ServerMethods::GET_CLIENT_STATUSES:
+            return handleGetClientStatusesRequest(request).serialize();
+
         case ServerMethods::START_SESSION:
             return handleStartSessionRequest(request).serialize();
 
@@ -642,6 +650,9 @@ LobbyServer::handleRequest(const std::string &requestData) {
         case ServerMethods::SPECTATE_LOBBY:
             return handleSpectateLobbyRequest(request).serialize();
 
+        case ServerMethods::HEARTBEAT:
+            return handleHeartbeatRequest(request).serialize();
+
         default:
             printMessage("Request [" + getServerMethodString(request.method) +
                          "] not implemented",
@@ -738,19 +749,51 @@ LobbyServer::handleGetPublicLobbiesRequest(const ServerRequest &request) {
     // handle the get public lobbies request
     // return the response to the client
 
-    // First, we get the public lobbies from the lobby server
-    // Then, we return the public lobbies to the client
+    // The listing is only rebuilt if a lobby changed since the last request.
+    // If the client already has the current version, it gets a tiny "not
+    // modified" answer. Otherwise it gets the page it asked for (the first
+    // one by default), for one game mode or for all of them.
+
+    std::optional<GameMode> gameMode;
+    int page = 0;
+    int knownVersion = NO_LOBBY_LIST_VERSION;
+    try {
+        if (request.params.contains("gameMode")) {
+            gameMode = static_cast<GameMode>(std::stoi(request.params.at("gameMode")));
+        }
+        if (request.params.contains("page")) {
+            page = std::stoi(request.params.at("page"));
+        }
+        if (request.params.contains("version")) {
+            knownVersion = std::stoi(request.params.at("version"));
+        }
+    } catch (const std::exception &) {
+        return ServerResponse::ErrorResponse(request.id,
+                                             StatusCode::ERROR_DESERIALIZING_REQUEST);
+    }
+
+    listing->refresh([this] {
+        std::vector<LobbyState> states;
+        for (const auto &lobby: getPublicLobbies()) {
+            states.push_back(lobby->getState());
+        }
+        return states;
+    });
+
+    const LobbyListing::Page listingPage = listing->getPage(gameMode, page, knownVersion);
 
     std::unordered_map<std::string, std::string> data;
-    std::vector<std::shared_ptr<Lobby> > publicLobbies = getPublicLobbies();
+    data["version"] = std::to_string(listingPage.version);
 
-    // we add the public lobbies to the data
-    int i = 0;
-    for (const auto &lobby: publicLobbies) {
-        data[std::to_string(i)] = lobby->getState().serialize();
-        i++;
+    if (listingPage.notModified) {
+        return ServerResponse::SuccessResponse(
+            request.id, StatusCode::SUCCESS_NOT_MODIFIED, data);
     }
 
+    data["page"] = std::to_string(page);
+    data["pageCount"] = std::to_string(listingPage.pageCount);
+    data["lobbies"] = listingPage.lobbies;
+
     // and we return the response to the client
     return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS,
                                            data);
@@ -825,7 +868,9 @@ LobbyServer::handleCreateLobbyRequest(const ServerRequest &request) {
     }
 
     const auto lobby = std::make_shared<Lobby>(ip, port, lobbyID, gameMode,
-                                               maxPlayers, publicLobby, debug);
+                                               maxPlayers, publicLobby);
+    lobby->setPresenceIndex(presence);
+    lobby->setLobbyListing(listing);
 
     // we lock the mutex
     {
@@ -833,6 +878,7 @@ LobbyServer::handleCreateLobbyRequest(const ServerRequest &request) {
         lobbyObjects[lobbyID] = lobby;
         lobbies[lobbyID] = port;
     }
+    listing->markDirty();
 
     // we start the lobby
     startLobby(lobbyID);
@@ -948,50 +994,62 @@ LobbyServer::handleGetClientStatusRequest(const ServerRequest &request) const {
     // handle the get client status request
     // return the response to the client
 
-    // we check if the player is connected to the lobby server. if it is, we
-    // try to see if it is in a lobby, or a game, or if it is just connected.
-    // if it is not connected, we return offline.
+    // the presence index is kept up to date by the lobbies and the games, so
+    // this is a single lookup (offline if the player has no session)
 
     const std::string username = request.params.at("username");
 
-    // we check if the player is connected to the lobby server
-    if (!doesUserHaveSession(username)) {
-        return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS,
-            ClientStatus::OFFLINE);
-    }
+    return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS,
+        presence->getStatus(username));
+}
+
+ServerResponse
+LobbyServer::handleGetClientStatusesRequest(const ServerRequest &request) const {
+    // handle the get client statuses request
+    // return the response to the client
 
-    // if the player is connected, we get the token
-    const std::string token = getClientSessionToken(username);
+    // the usernames come as a json array (the friends list of the client),
+    // and we answer with one entry per username : USERNAME -> STATUS
 
-    // then we check if the player is in a lobby
-    // but first, we need to lock the mutex
+    std::vector<std::string> usernames;
+    try {
+        const nlohmann::json j = nlohmann::json::parse(request.params.at("usernames"));
+        usernames = j.get<std::vector<std::string>>();
+    } catch (const nlohmann::json::exception &) {
+        return ServerResponse::ErrorResponse(request.id,
+                                             StatusCode::ERROR_DESERIALIZING_REQUEST);
+    }
 
-    {
-        std::lock_guard lock(lobbiesMutex);
+    // one datagram has to hold the answer
+    if (usernames.size() > static_cast<std::size_t>(MAX_STATUS_BATCH)) {
+        return ServerResponse::ErrorResponse(request.id,
+                                             StatusCode::ERROR_DESERIALIZING_REQUEST);
+    }
 
-        for (const auto &[lobbyID, lobby]: lobbyObjects) {
-            if (lobby->isPlayerInLobby(token)) {
-                return ServerResponse::SuccessResponse(
-                    request.id, StatusCode::SUCCESS, ClientStatus::IN_LOBBY);
-            }
+    const std::vector<ClientStatus> statuses = presence->getStatuses(usernames);
 
-            if (lobby->isSpectatorInLobby(token)) {
-                return ServerResponse::SuccessResponse(
-                    request.id, StatusCode::SUCCESS, ClientStatus::IN_LOBBY);
-            }
-        }
+    std::unordered_map<std::string, std::string> data;
+    for (std::size_t i = 0; i < usernames.size(); ++i) {
+        data[usernames[i]] = std::to_string(static_cast<int>(statuses[i]));
     }
 
-    // if reached this point, the player is connected and might be in a game
-    // we check if the player is in a game
+    return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS, data);
+}
+
+ServerResponse
+LobbyServer::handleHeartbeatRequest(const ServerRequest &request) const {
+    // handle the heartbeat request
+    // return the response to the client
+
+    // The session was already touched by handleRequest, like for any request
+    // with a token. We only tell the client if its session still exists (it
+    // has to start a new one if it expired)
 
-    if (gameServer->isSessionInAnyGame(token)) {
-        return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS,
-            ClientStatus::IN_GAME);
+    if (!request.params.contains("token") ||
+        !isSessionActive(request.params.at("token"))) {
+        return ServerResponse::ErrorResponse(request.id,
+                                             StatusCode::ERROR_SESSION_NOT_FOUND);
     }
 
-    // if reached this point, the player is connected but not in a lobby or a
-    // game
-    return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS,
-        ClientStatus::IN_MENU);
+    return ServerResponse::SuccessResponse(request.id, StatusCode::SUCCESS);
 }
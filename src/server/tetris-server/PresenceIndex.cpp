@@ -0,0 +1,226 @@
+#include "PresenceIndex.hpp"
+
+PresenceIndex::PresenceIndex(const Clock::duration sessionTimeout)
+    : sessionTimeout(sessionTimeout),
+      deadlines(std::chrono::seconds(1), SESSION_WHEEL_SLOTS) {}
+
+StatusCode
+PresenceIndex::addSession(const std::string &token,
+                          const std::string &username,
+                          const std::size_t maxSessions) {
+    // this is used to register a new session. if the user already had one,
+    // the old token is forgotten and the new one takes its place. the checks
+    // and the insertion happen under the same lock, so two sessions starting
+    // at the same time can't both take the last slot
+
+    std::lock_guard lock(presenceMutex);
+
+    if (usernames.contains(token)) {
+        return StatusCode::ERROR_SESSION_ALREADY_EXISTS;
+    }
+
+    const auto it = presences.find(username);
+    if (it != presences.end()) {
+        usernames.erase(it->second.token);
+        deadlines.cancel(it->second.token);
+        it->second = Presence{token, ClientStatus::IN_MENU, ""};
+        usernames[token] = username;
+        deadlines.schedule(token, Clock::now() + sessionTimeout);
+        return StatusCode::SUCCESS_REPLACED_SESSION;
+    }
+
+    if (presences.size() >= maxSessions) {
+        return StatusCode::ERROR_MAX_PLAYERS_REACHED;
+    }
+
+    presences[username] = Presence{token, ClientStatus::IN_MENU, ""};
+    usernames[token] = username;
+    deadlines.schedule(token, Clock::now() + sessionTimeout);
+    return StatusCode::SUCCESS;
+}
+
+bool
+PresenceIndex::removeSession(const std::string &token) {
+    // this is used when a session ends, the player is offline afterwards
+
+    std::lock_guard lock(presenceMutex);
+
+    const auto it = usernames.find(token);
+    if (it == usernames.end()) {
+        return false;
+    }
+
+    presences.erase(it->second);
+    usernames.erase(it);
+    deadlines.cancel(token);
+    return true;
+}
+
+void
+PresenceIndex::clear() {
+    std::lock_guard lock(presenceMutex);
+    presences.clear();
+    usernames.clear();
+    deadlines.clear();
+}
+
+void
+PresenceIndex::enter(const std::string &token, const ClientStatus status,
+                     const std::string &placeID) {
+    // this is used when a session joins a lobby or a game
+
+    std::lock_guard lock(presenceMutex);
+
+    const auto it = usernames.find(token);
+    if (it == usernames.end()) {
+        return; // no session, nothing to track
+    }
+
+    Presence &presence = presences.at(it->second);
+    presence.status = status;
+    presence.placeID = placeID;
+}
+
+void
+PresenceIndex::leave(const std::string &token, const std::string &placeID) {
+    // this is used when a session leaves a lobby or a game. we check the
+    // place so a late leave doesn't undo a join that happened since
+
+    std::lock_guard lock(presenceMutex);
+
+    const auto it = usernames.find(token);
+    if (it == usernames.end()) {
+        return;
+    }
+
+    Presence &presence = presences.at(it->second);
+    if (presence.placeID == placeID) {
+        presence.status = ClientStatus::IN_MENU;
+        presence.placeID.clear();
+    }
+}
+
+void
+PresenceIndex::leaveAll(const std::string &placeID, const ClientStatus status) {
+    // this is used when a lobby or a game is closed with people still in it.
+    // it goes through every session, but only happens once per lobby / game
+
+    std::lock_guard lock(presenceMutex);
+
+    for (auto &[username, presence]: presences) {
+        if (presence.placeID == placeID && presence.status == status) {
+            presence.status = ClientStatus::IN_MENU;
+            presence.placeID.clear();
+        }
+    }
+}
+
+bool
+PresenceIndex::hasSession(const std::string &username) const {
+    std::lock_guard lock(presenceMutex);
+    return presences.contains(username);
+}
+
+bool
+PresenceIndex::hasToken(const std::string &token) const {
+    std::lock_guard lock(presenceMutex);
+    return usernames.contains(token);
+}
+
+std::optional<std::string>
+PresenceIndex::getUsername(const std::string &token) const {
+    std::lock_guard lock(presenceMutex);
+
+    const auto it = usernames.find(token);
+    if (it == usernames.end()) {
+        return std::nullopt;
+    }
+
+    return it->second;
+}
+
+std::optional<std::string>
+PresenceIndex::getToken(const std::string &username) const {
+    std::lock_guard lock(presenceMutex);
+
+    const auto it = presences.find(username);
+    if (it == presences.end()) {
+        return std::nullopt;
+    }
+
+    return it->second.token;
+}
+
+ClientStatus
+PresenceIndex::getStatus(const std::string &username) const {
+    std::lock_guard lock(presenceMutex);
+    return statusOf(username);
+}
+
+std::vector<ClientStatus>
+PresenceIndex::getStatuses(const std::vector<std::string> &names) const {
+    // same order as the usernames, one lock for the whole batch
+
+    std::lock_guard lock(presenceMutex);
+
+    std::vector<ClientStatus> statuses;
+    statuses.reserve(names.size());
+    for (const std::string &username: names) {
+        statuses.push_back(statusOf(username));
+    }
+
+    return statuses;
+}
+
+std::size_t
+PresenceIndex::size() const {
+    std::lock_guard lock(presenceMutex);
+    return presences.size();
+}
+
+bool
+PresenceIndex::touch(const std::string &token, const Clock::time_point now) {
+    // this is called for every request that has a token, by the lobby server,
+    // the lobbies and the games. it only moves the deadline, the session stays
+    // in its slot of the wheel until then
+
+    std::lock_guard lock(presenceMutex);
+
+    if (!usernames.contains(token)) {
+        return false;
+    }
+
+    deadlines.schedule(token, now + sessionTimeout);
+    return true;
+}
+
+std::vector<PresenceIndex::Expired>
+PresenceIndex::expire(const Clock::time_point now) {
+    // this is called by the lobby server about once a second, it only looks at
+    // the sessions whose deadline came since the last call
+
+    std::lock_guard lock(presenceMutex);
+
+    std::vector<Expired> expired;
+    for (const std::string &token: deadlines.advance(now)) {
+        const auto it = usernames.find(token);
+        if (it == usernames.end()) {
+            continue;
+        }
+
+        const Presence &presence = presences.at(it->second);
+        expired.push_back({token, it->second, presence.status, presence.placeID});
+        presences.erase(it->second);
+        usernames.erase(it);
+    }
+
+    return expired;
+}
+
+ClientStatus
+PresenceIndex::statusOf(const std::string &username) const {
+    // presenceMutex must be held
+
+    const auto it = presences.find(username);
+    return it == presences.end() ? ClientStatus::OFFLINE : it->second.status;
+}
@@ -0,0 +1,133 @@
+#include "ReplaySimulator.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+bool
+ReplayOutcome::matches() const {
+    // nothing recorded is nothing to disagree with
+    return !recorded || (recorded->score == score && recorded->lines == lines);
+}
+
+bool
+ReplayResult::verified() const {
+    return std::ranges::all_of(players, &ReplayOutcome::matches);
+}
+
+std::optional<ReplayResult>
+ReplaySimulator::simulate(const Replay &replay) {
+    // the boards are keyed by their index in the roster, in roster order so
+    // everyone has the same opponents (and the same target) as in the match
+    std::vector<std::string> tokens;
+    for (std::size_t index = 0; index < replay.players.size(); ++index) {
+        tokens.push_back(std::to_string(index));
+    }
+
+    std::unordered_map<std::string, std::shared_ptr<TetrisGame>> games;
+    std::shared_ptr<GameEngine> engine;
+    try {
+        games = GameCreator::createGames(replay.gameMode, tokens);
+        engine = GameCreator::createEngine(replay.gameMode);
+    } catch (std::invalid_argument &) {
+        return std::nullopt;
+    }
+
+    ReplayResult result;
+    std::vector<TetrisGame *> boards;
+    for (std::size_t index = 0; index < replay.players.size(); ++index) {
+        const auto game = games.find(tokens[index]);
+        if (game == games.end()) {
+            return std::nullopt; // endless has a single board
+        }
+        game->second->setPlayerName(replay.players[index].name);
+        game->second->setSeed(replay.players[index].seed);
+        boards.push_back(game->second.get());
+        result.players.emplace_back().name = replay.players[index].name;
+    }
+
+    EffectQueue effects;
+    auto leave = [&boards, &result, &effects](const ReplayEvent &event) {
+        ReplayOutcome &outcome = result.players[event.player];
+        if (outcome.left) {
+            return;
+        }
+        for (std::size_t other = 0; other < boards.size(); ++other) {
+            if (other != event.player && !result.players[other].left) {
+                boards[other]->removeOpponent(boards[event.player]);
+            }
+        }
+        effects.forget(boards[event.player]);
+        outcome.left = true;
+        outcome.recorded = event.scores.front();
+        outcome.score = boards[event.player]->getScore();
+        outcome.lines = boards[event.player]->getLinesCleared();
+        outcome.gameOver = boards[event.player]->isGameOver();
+    };
+
+    // a complete replay stops where the server did, a truncated one after
+    // the last input it has
+    std::uint64_t lastTick = 0;
+    if (!replay.events.empty()) {
+        lastTick = replay.events.back().tick;
+        if (!replay.complete) {
+            ++lastTick;
+        }
+    }
+
+    std::vector<Action> actions(boards.size(), Action::None);
+    auto event = replay.events.begin();
+    for (std::uint64_t tick = 0; tick < lastTick; ++tick) {
+        // the inputs of this tick (a LEAVE stays where it is, it happens
+        // somewhere in the middle of it)
+        std::ranges::fill(actions, Action::None);
+        auto leaves = event;
+        for (; event != replay.events.end() && event->tick == tick; ++event) {
+            if (event->type == ReplayEventType::INPUT) {
+                actions[event->player] = event->action;
+            }
+        }
+
+        for (std::size_t position = 0; position <= replay.tickOrder.size(); ++position) {
+            for (auto pending = leaves; pending != event; ++pending) {
+                if (pending->type == ReplayEventType::LEAVE && pending->after == position) {
+                    leave(*pending);
+                }
+            }
+            if (position == replay.tickOrder.size()) {
+                break;
+            }
+
+            const std::uint32_t player = replay.tickOrder[position];
+            if (!result.players[player].left) {
+                engine->handlingRoutine(*boards[player], actions[player]);
+                effects.collect(*boards[player]);
+            }
+        }
+        effects.apply();
+    }
+    result.ticks = lastTick;
+
+    // left after the last tick, before the server noticed the match was over
+    for (; event != replay.events.end(); ++event) {
+        if (event->type == ReplayEventType::LEAVE) {
+            leave(*event);
+        }
+    }
+
+    // whoever is still there, and what the end of the match recorded for them
+    for (std::size_t index = 0; index < boards.size(); ++index) {
+        ReplayOutcome &outcome = result.players[index];
+        if (!outcome.left) {
+            outcome.score = boards[index]->getScore();
+            outcome.lines = boards[index]->getLinesCleared();
+            outcome.gameOver = boards[index]->isGameOver();
+        }
+    }
+    if (replay.complete) {
+        for (const ReplayScore &score: replay.events.back().scores) {
+            result.players[score.player].recorded = score;
+        }
+    }
+
+    return result;
+}
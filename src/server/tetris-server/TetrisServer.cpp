@@ -1,7 +1,8 @@
 #include "TetrisServer.hpp"
 
-TetrisServer::TetrisServer(const std::string &ip, int listenPort, bool debug)
-    : ip(ip), lobbyPort(listenPort), debug(debug) {
+TetrisServer::TetrisServer(const std::string &ip, int listenPort,
+                           int maxSessions)
+    : ip(ip), lobbyPort(listenPort) {
     // this is the constructor for the TetrisServer class
     // it will create a new lobby server and start it
     // it will also create a new game server and start it
@@ -10,9 +11,16 @@ TetrisServer::TetrisServer(const std::string &ip, int listenPort, bool debug)
     // will handle the lobbies created by the lobby server (on their allocated
     // ports)
 
-    lobbyServer = std::make_shared<LobbyServer>(ip, listenPort, debug);
-    gameServer = std::make_shared<GameServer>(ip, lobbyServer, debug);
+    lobbyServer = std::make_shared<LobbyServer>(ip, listenPort, maxSessions);
+    gameServer = std::make_shared<GameServer>(ip, lobbyServer);
     lobbyServer->setGameServer(gameServer);
+
+    // the lobby server cleans up after the games that ended
+    gameServer->onGameFinished([lobby = std::weak_ptr(lobbyServer)](const std::string &gameID) {
+        if (const std::shared_ptr<LobbyServer> server = lobby.lock()) {
+            server->handleGameFinished(gameID);
+        }
+    });
 }
 
 TetrisServer::~TetrisServer() {
@@ -126,39 +134,8 @@ void
 TetrisServer::printMessage(const std::string &message,
                            const MessageType msgtype) const {
     // This method is used to print a message to the console.
-    // It will print the message with the specified message type
-    // only if the debug flag is set to true.
-
-    if (!debug) {
-        return;
-    }
-
-    const std::string tetrisServerIdentifier = "[Tetris Server] ";
-    std::string msgtype_str;
-
-    switch (msgtype) {
-        case MessageType::INFO:
-            msgtype_str = "INFO";
-            break;
-
-        case MessageType::WARNING:
-            msgtype_str = "WARNING";
-            break;
-
-        case MessageType::ERROR:
-            msgtype_str = "ERROR";
-            break;
-
-        case MessageType::CRITICAL:
-            msgtype_str = "CRITICAL";
-            break;
-
-        default:
-            msgtype_str = "UNKNOWN | DEBUG";
-            break;
-    }
+    // It will print the message with the specified message type,
+    // if the log level of the tetris server lets it through.
 
-    const std::string messageToPrint =
-            tetrisServerIdentifier + "[" + msgtype_str + "] " + message;
-    std::cout << messageToPrint << std::endl;
+    Logger::instance().log(msgtype, LogComponent::TETRIS_SERVER, "", message);
 }
@@ -0,0 +1,108 @@
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+TimerWheel::TimerWheel(const Clock::duration resolution, const std::size_t slotCount,
+                       const Clock::time_point start)
+    : resolution(resolution), start(start), slots(slotCount) {
+    if (resolution <= Clock::duration::zero() || slotCount == 0) {
+        throw std::invalid_argument("[err] TimerWheel needs a resolution and some slots");
+    }
+}
+
+void
+TimerWheel::schedule(const std::string &key, const Clock::time_point deadline) {
+    // a key already in an earlier slot stays there (the usual case, a
+    // deadline pushed back), it is moved on when its slot comes. only an
+    // earlier deadline needs the key in another slot right away
+
+    const std::uint64_t tick = std::max(dueTick(deadline), nextTick);
+
+    const auto it = timers.find(key);
+    if (it != timers.end() && it->second.tick <= tick) {
+        it->second.deadline = deadline;
+        return;
+    }
+
+    Timer &timer = timers[key];
+    timer.deadline = deadline;
+    place(key, timer, tick);
+}
+
+void
+TimerWheel::cancel(const std::string &key) {
+    // its entry stays in the slot until the slot comes, and is skipped then
+    timers.erase(key);
+}
+
+void
+TimerWheel::clear() {
+    timers.clear();
+    for (auto &slot: slots) {
+        slot.clear();
+    }
+}
+
+std::vector<std::string>
+TimerWheel::advance(const Clock::time_point now) {
+    // this goes through the slots of every tick since the last call (every
+    // slot once at most, if the last call was more than a turn ago)
+
+    std::vector<std::string> expired;
+
+    const std::uint64_t lastTick = now <= start
+                                       ? 0
+                                       : static_cast<std::uint64_t>((now - start) / resolution);
+    if (nextTick > lastTick) {
+        return expired;
+    }
+
+    const std::uint64_t lastVisited = std::min<std::uint64_t>(lastTick, nextTick + slots.size() - 1);
+    for (std::uint64_t tick = nextTick; tick <= lastVisited; ++tick) {
+        // the entries put back land in the slot's new vector, not this one
+        const std::vector<Entry> entries = std::exchange(slots[tick % slots.size()], {});
+        nextTick = tick + 1;
+
+        for (const Entry &entry: entries) {
+            const auto it = timers.find(entry.key);
+            if (it == timers.end() || it->second.generation != entry.generation) {
+                continue; // cancelled, or in another slot since
+            }
+
+            if (it->second.deadline <= now) {
+                expired.push_back(entry.key);
+                timers.erase(it);
+            } else {
+                place(entry.key, it->second, std::max(dueTick(it->second.deadline), nextTick));
+            }
+        }
+    }
+    nextTick = lastTick + 1;
+
+    return expired;
+}
+
+std::size_t
+TimerWheel::size() const {
+    return timers.size();
+}
+
+std::uint64_t
+TimerWheel::dueTick(const Clock::time_point deadline) const {
+    // the slot of tick t is looked at once now >= start + t * resolution
+    if (deadline <= start) {
+        return 0;
+    }
+
+    const auto elapsed = (deadline - start).count();
+    return static_cast<std::uint64_t>((elapsed + resolution.count() - 1) / resolution.count());
+}
+
+void
+TimerWheel::place(const std::string &key, Timer &timer, const std::uint64_t tick) {
+    timer.tick = tick;
+    timer.generation = nextGeneration++;
+    slots[tick % slots.size()].push_back({key, timer.generation});
+}
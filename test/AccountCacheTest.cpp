@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+
+#include "AccountCache.hpp"
+
+
+TEST(AccountCacheTest, Empty) {
+    AccountCache cache(4);
+    EXPECT_EQ(cache.size(), 0) << "The cache should be empty after construction.";
+    EXPECT_FALSE(cache.findUserName("1").has_value()) << "Unknown accounts have no name.";
+    EXPECT_FALSE(cache.findAccountID("alice").has_value()) << "Unknown names have no account.";
+}
+
+TEST(AccountCacheTest, BothDirections) {
+    AccountCache cache(4);
+    cache.put("1", "alice");
+
+    EXPECT_EQ(cache.findUserName("1"), "alice") << "The name should be found from the account.";
+    EXPECT_EQ(cache.findAccountID("alice"), "1") << "The account should be found from the name.";
+    EXPECT_EQ(cache.size(), 1) << "A pair is a single entry.";
+}
+
+TEST(AccountCacheTest, EvictsLeastRecentlyUsed) {
+    AccountCache cache(2);
+    cache.put("1", "alice");
+    cache.put("2", "bob");
+    cache.put("3", "carol");
+
+    EXPECT_EQ(cache.size(), 2) << "The cache should not grow past its capacity.";
+    EXPECT_FALSE(cache.findUserName("1").has_value()) << "The oldest pair should go first.";
+    EXPECT_FALSE(cache.findAccountID("alice").has_value()) << "Both sides of the oldest pair should go.";
+    EXPECT_EQ(cache.findUserName("2"), "bob") << "Newer pairs should stay.";
+    EXPECT_EQ(cache.findUserName("3"), "carol") << "Newer pairs should stay.";
+}
+
+TEST(AccountCacheTest, GetRefreshesEntry) {
+    AccountCache cache(2);
+    cache.put("1", "alice");
+    cache.put("2", "bob");
+
+    // alice is now the most recently used, bob goes first
+    EXPECT_EQ(cache.findUserName("1"), "alice");
+    cache.put("3", "carol");
+
+    EXPECT_EQ(cache.findUserName("1"), "alice") << "A looked up pair should not be evicted first.";
+    EXPECT_FALSE(cache.findUserName("2").has_value()) << "The least recently used pair should be evicted.";
+
+    // the other direction refreshes too
+    EXPECT_EQ(cache.findAccountID("carol"), "3");
+    cache.put("4", "dave");
+
+    EXPECT_EQ(cache.findAccountID("carol"), "3") << "A looked up pair should not be evicted first.";
+    EXPECT_FALSE(cache.findAccountID("alice").has_value()) << "The least recently used pair should be evicted.";
+}
+
+TEST(AccountCacheTest, PutRefreshesEntry) {
+    AccountCache cache(2);
+    cache.put("1", "alice");
+    cache.put("2", "bob");
+    cache.put("1", "alice");
+    cache.put("3", "carol");
+
+    EXPECT_EQ(cache.findUserName("1"), "alice") << "A pair put again should be the most recently used.";
+    EXPECT_FALSE(cache.findUserName("2").has_value()) << "The least recently used pair should be evicted.";
+}
+
+TEST(AccountCacheTest, Invalidate) {
+    AccountCache cache(4);
+    cache.put("1", "alice");
+    cache.put("2", "bob");
+    cache.invalidate("1");
+    cache.invalidate("unknown");
+
+    EXPECT_EQ(cache.size(), 1) << "Only the invalidated pair should be removed.";
+    EXPECT_FALSE(cache.findUserName("1").has_value()) << "An invalidated account has no name.";
+    EXPECT_FALSE(cache.findAccountID("alice").has_value()) << "An invalidated name has no account.";
+    EXPECT_EQ(cache.findUserName("2"), "bob") << "Other pairs should stay.";
+}
+
+TEST(AccountCacheTest, RenameDropsStalePairs) {
+    AccountCache cache(4);
+    cache.put("1", "alice");
+    cache.put("1", "alicia");
+
+    EXPECT_EQ(cache.size(), 1) << "A renamed account should still be a single entry.";
+    EXPECT_EQ(cache.findUserName("1"), "alicia") << "The new name should be found.";
+    EXPECT_FALSE(cache.findAccountID("alice").has_value()) << "The old name should be forgotten.";
+
+    // someone else takes the name that was given up
+    cache.put("2", "alicia");
+
+    EXPECT_EQ(cache.findAccountID("alicia"), "2") << "The name should point to its new account.";
+    EXPECT_FALSE(cache.findUserName("1").has_value()) << "The old owner of the name should be forgotten.";
+}
+
+TEST(AccountCacheTest, Clear) {
+    AccountCache cache(4);
+    cache.put("1", "alice");
+    cache.put("2", "bob");
+    cache.clear();
+
+    EXPECT_EQ(cache.size(), 0) << "The cache should be empty after clear.";
+    EXPECT_FALSE(cache.findUserName("1").has_value());
+    EXPECT_FALSE(cache.findAccountID("bob").has_value());
+}
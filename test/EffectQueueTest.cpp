@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "Effect.hpp"
+#include "GameCreator.hpp"
+
+#include <algorithm>
+#include <random>
+#include <thread>
+
+
+// a royale match where everyone always has the energy for a malus, so the
+// boards keep hitting each other. [order] is the order the boards of a tick
+// are simulated in, empty for all of them at the same time
+static std::vector<tetroMat>
+playRoyale(const std::vector<std::size_t> &order) {
+    std::vector<std::string> players = {"alice", "bob", "carol", "dave"};
+    auto games = GameCreator::createGames(GameMode::ROYALE, players);
+    const std::shared_ptr<GameEngine> engine = GameCreator::createEngine(GameMode::ROYALE);
+
+    std::vector<TetrisGame *> boards;
+    for (std::size_t index = 0; index < players.size(); ++index) {
+        boards.push_back(games.at(players[index]).get());
+        boards.back()->setSeed(static_cast<std::uint32_t>(index + 1));
+    }
+
+    std::mt19937 inputs(3);
+    EffectQueue effects;
+    for (int tick = 0; tick < 400; ++tick) {
+        std::vector<Action> actions;
+        for (TetrisGame *board: boards) {
+            board->setEnergy(1000);
+            actions.push_back(static_cast<Action>(1 + inputs() % 9));
+        }
+
+        if (order.empty()) {
+            std::vector<std::thread> workers;
+            for (std::size_t index = 0; index < boards.size(); ++index) {
+                workers.emplace_back([&engine, &boards, &actions, index] {
+                    engine->handlingRoutine(*boards[index], actions[index]);
+                });
+            }
+            for (std::thread &worker: workers) {
+                worker.join();
+            }
+        } else {
+            for (const std::size_t index: order) {
+                engine->handlingRoutine(*boards[index], actions[index]);
+            }
+        }
+
+        // whatever order they are collected in, the queue sorts them
+        for (const std::size_t index: order.empty() ? std::vector<std::size_t>{0, 1, 2, 3} : order) {
+            effects.collect(*boards[index]);
+        }
+        effects.apply();
+    }
+
+    std::vector<tetroMat> result;
+    for (TetrisGame *board: boards) {
+        result.push_back(board->getGameMatrix().getBoard());
+    }
+    return result;
+}
+
+TEST(EffectQueueTest, PenaltyLinesWaitForTheEndOfTheTick) {
+    std::vector<std::string> players = {"alice", "bob"};
+    auto games = GameCreator::createGames(GameMode::CLASSIC, players);
+    TetrisGame &alice = *games.at("alice");
+    TetrisGame &bob = *games.at("bob");
+
+    alice.emitEffect({EffectType::PenaltyLines, &bob, 2});
+    EffectQueue effects;
+    effects.collect(alice);
+    EXPECT_EQ(effects.size(), 1U);
+    EXPECT_TRUE(alice.takeEffects().empty());
+
+    // nothing happened to bob yet
+    const tetroMat &board = bob.getGameMatrix().getBoard();
+    EXPECT_TRUE(std::ranges::all_of(board.back(), [](const int cell) { return cell == 0; }));
+
+    effects.apply();
+    EXPECT_TRUE(effects.empty());
+    EXPECT_EQ(std::ranges::count(board.back(), static_cast<int>(PieceType::Single)), bob.getGameMatrix().getWidth() - 1);
+    EXPECT_EQ(std::ranges::count(board[board.size() - 2], static_cast<int>(PieceType::Single)), bob.getGameMatrix().getWidth() - 1);
+}
+
+TEST(EffectQueueTest, ForgetsWhoLeft) {
+    std::vector<std::string> players = {"alice", "bob", "carol"};
+    auto games = GameCreator::createGames(GameMode::CLASSIC, players);
+    TetrisGame &alice = *games.at("alice");
+    TetrisGame &bob = *games.at("bob");
+    TetrisGame &carol = *games.at("carol");
+
+    alice.emitEffect({EffectType::PenaltyLines, &bob, 1});
+    bob.emitEffect({EffectType::PenaltyLines, &carol, 1});
+    carol.emitEffect({EffectType::PenaltyLines, &alice, 1});
+
+    EffectQueue effects;
+    effects.collect(alice);
+    effects.collect(bob);
+    effects.collect(carol);
+    effects.forget(&bob);
+
+    EXPECT_EQ(effects.size(), 1U);
+}
+
+TEST(EffectQueueTest, OrderOfTheBoardsDoesNotMatter) {
+    const std::vector<tetroMat> inOrder = playRoyale({0, 1, 2, 3});
+    EXPECT_EQ(playRoyale({3, 1, 0, 2}), inOrder);
+    EXPECT_EQ(playRoyale({}), inOrder);
+}
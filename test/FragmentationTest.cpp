@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+
+#include "Fragmentation.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+
+static std::string bigMessage(std::size_t size) {
+    std::string message;
+    for (std::size_t i = 0; i < size; ++i) {
+        message += static_cast<char>('a' + i % 26);
+    }
+    return message;
+}
+
+static std::optional<std::string> feedAll(FragmentReader &reader, const std::vector<std::string> &datagrams) {
+    std::optional<std::string> result;
+    for (const std::string &datagram: datagrams) {
+        result = reader.feed("sender", datagram.data(), datagram.size());
+    }
+    return result;
+}
+
+TEST(FragmentationTest, SmallMessagesAreNotFragmented) {
+    FragmentWriter writer;
+    const std::string message = R"({"id":1,"method":0,"params":{}})";
+
+    const std::vector<std::string> datagrams = writer.split(message);
+    ASSERT_EQ(datagrams.size(), 1u);
+    EXPECT_EQ(datagrams[0], message) << "A message that fits should go as it is.";
+
+    FragmentReader reader;
+    EXPECT_EQ(reader.feed("sender", message.data(), message.size()), message);
+}
+
+TEST(FragmentationTest, BigMessageRoundTrip) {
+    FragmentWriter writer;
+    const std::string message = bigMessage(10 * MAX_DATAGRAM_SIZE);
+
+    const std::vector<std::string> datagrams = writer.split(message);
+    EXPECT_GT(datagrams.size(), 10u);
+    for (const std::string &datagram: datagrams) {
+        EXPECT_LE(datagram.size(), static_cast<std::size_t>(MAX_DATAGRAM_SIZE)) << "No datagram should be bigger than MAX_DATAGRAM_SIZE.";
+    }
+
+    FragmentReader reader;
+    EXPECT_EQ(feedAll(reader, datagrams), message);
+    EXPECT_EQ(reader.pendingCount(), 0u);
+}
+
+TEST(FragmentationTest, OutOfOrderAndDuplicatedFragments) {
+    FragmentWriter writer;
+    const std::string message = bigMessage(3 * MAX_DATAGRAM_SIZE);
+
+    std::vector<std::string> datagrams = writer.split(message);
+    std::reverse(datagrams.begin(), datagrams.end());
+    datagrams.insert(datagrams.begin() + 1, datagrams[0]);
+
+    FragmentReader reader;
+    EXPECT_EQ(feedAll(reader, datagrams), message) << "The order of the fragments should not matter.";
+}
+
+TEST(FragmentationTest, SendersAreKeptApart) {
+    FragmentWriter writer;
+    const std::string message = bigMessage(2 * (MAX_DATAGRAM_SIZE - FragmentHeader::SIZE));
+    const std::vector<std::string> datagrams = writer.split(message);
+    ASSERT_EQ(datagrams.size(), 2u);
+
+    FragmentReader reader;
+    EXPECT_FALSE(reader.feed("alice", datagrams[0].data(), datagrams[0].size()).has_value());
+    EXPECT_FALSE(reader.feed("bob", datagrams[1].data(), datagrams[1].size()).has_value()) << "Fragments from another sender should not complete the message.";
+    EXPECT_EQ(reader.feed("alice", datagrams[1].data(), datagrams[1].size()), message);
+}
+
+TEST(FragmentationTest, TooBigMessage) {
+    FragmentWriter writer;
+    const std::string message = bigMessage((FragmentHeader::MAX_FRAGMENTS + 1) * MAX_DATAGRAM_SIZE);
+    EXPECT_TRUE(writer.split(message).empty()) << "A message over MAX_FRAGMENTS should not be sent.";
+}
+
+TEST(FragmentationTest, InvalidFragmentsAreDropped) {
+    FragmentHeader header;
+    header.messageID = 1;
+    header.index = 3;
+    header.count = 2;
+    const std::string datagram = header.serialize() + "data";
+
+    FragmentReader reader;
+    EXPECT_FALSE(reader.feed("sender", datagram.data(), datagram.size()).has_value());
+    EXPECT_EQ(reader.pendingCount(), 0u) << "A fragment with an index past the count should be ignored.";
+}
+
+TEST(FragmentationTest, IncompleteMessagesExpire) {
+    FragmentWriter writer;
+    const std::vector<std::string> datagrams = writer.split(bigMessage(2 * MAX_DATAGRAM_SIZE));
+
+    FragmentReader reader;
+    EXPECT_FALSE(reader.feed("sender", datagrams[0].data(), datagrams[0].size()).has_value());
+    EXPECT_EQ(reader.pendingCount(), 1u);
+
+    reader.expire();
+    EXPECT_EQ(reader.pendingCount(), 1u) << "It should be kept for a while.";
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    reader.expire();
+    EXPECT_EQ(reader.pendingCount(), 0u) << "It should be dropped once the timeout is over.";
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+
+#include "GameOverview.hpp"
+#include "ServerResponse.hpp"
+
+
+TEST(GameOverviewTest, SkylineOfABoard) {
+    // 4 rows, 3 columns : empty, a block on the bottom row, a block up top
+    // with a hole under it
+    const tetroMat board = {
+        {0, 0, 3},
+        {0, 0, 0},
+        {0, 0, 3},
+        {0, 1, 3},
+    };
+
+    const std::string skyline = GameOverview::encodeSkyline(board);
+    EXPECT_EQ(skyline.size(), 3);
+    EXPECT_EQ(GameOverview::decodeSkyline(skyline), (std::vector<int>{0, 1, 4}));
+}
+
+TEST(GameOverviewTest, EmptyBoard) {
+    EXPECT_EQ(GameOverview::encodeSkyline(tetroMat()), "");
+    EXPECT_EQ(GameOverview::decodeSkyline(GameOverview::encodeSkyline(tetroMat(20, std::vector<int>(10, 0)))),
+              std::vector<int>(10, 0));
+}
+
+TEST(GameOverviewTest, SerializeRoundTrip) {
+    GameOverview overview;
+    overview.boards.push_back({"alice", GameOverview::encodeSkyline({{0, 1}, {1, 1}}), false});
+    overview.boards.push_back({"bob", GameOverview::encodeSkyline({{0, 0}, {0, 0}}), true});
+
+    const GameOverview copy = GameOverview::deserialize(overview.serialize());
+    EXPECT_EQ(copy.boards, overview.boards);
+
+    EXPECT_THROW((void) GameOverview::deserialize("not json"), std::runtime_error);
+}
+
+TEST(GameOverviewTest, FullRoyaleFitsInOneDatagram) {
+    // worst case : every board full and a long name for everybody
+    GameOverview overview;
+    for (int i = 0; i < MAX_LOBBY_SIZE; ++i) {
+        overview.boards.push_back({std::string(64, 'a' + i),
+                                   GameOverview::encodeSkyline(tetroMat(22, std::vector<int>(10, 1))),
+                                   false});
+    }
+
+    const GameOverview copy = GameOverview::deserialize(overview.serialize());
+    EXPECT_EQ(copy.boards.front().username.size(), OVERVIEW_NAME_LENGTH);
+
+    const ServerResponse response = ServerResponse::SuccessResponse(
+        MAX_REQUEST_ID, StatusCode::SUCCESS, {{"overview", overview.serialize()}});
+    EXPECT_LE(response.serialize().size(), MAX_DATAGRAM_SIZE);
+}
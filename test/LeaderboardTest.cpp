@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+
+#include "Leaderboard.hpp"
+
+
+TEST(LeaderboardTest, Empty) {
+    Leaderboard leaderboard = Leaderboard();
+    EXPECT_EQ(leaderboard.size(), 0) << "The leaderboard should be empty after construction.";
+    EXPECT_TRUE(leaderboard.getTop(10).empty()) << "An empty leaderboard has no top players.";
+    EXPECT_FALSE(leaderboard.getEntry("nobody").has_value()) << "Unknown players have no rank.";
+}
+
+TEST(LeaderboardTest, TopIsSortedByScore) {
+    Leaderboard leaderboard = Leaderboard();
+    leaderboard.setPlayer("a", "alice", 100);
+    leaderboard.setPlayer("b", "bob", 300);
+    leaderboard.setPlayer("c", "carol", 200);
+
+    std::vector<LeaderboardEntry> top = leaderboard.getTop(2);
+    ASSERT_EQ(top.size(), 2) << "Only the requested number of players should be returned.";
+    EXPECT_EQ(top[0].userName, "bob") << "The best score should come first.";
+    EXPECT_EQ(top[0].rank, 1) << "The best player should be ranked 1.";
+    EXPECT_EQ(top[1].userName, "carol") << "The second best score should come second.";
+    EXPECT_EQ(top[1].rank, 2) << "The second best player should be ranked 2.";
+}
+
+TEST(LeaderboardTest, ScoreUpdateMovesPlayer) {
+    Leaderboard leaderboard = Leaderboard();
+    leaderboard.setPlayer("a", "alice", 100);
+    leaderboard.setPlayer("b", "bob", 300);
+
+    EXPECT_TRUE(leaderboard.setScore("a", 500)) << "Known players can be updated.";
+    EXPECT_FALSE(leaderboard.setScore("z", 500)) << "Unknown players can't be updated.";
+    EXPECT_EQ(leaderboard.size(), 2) << "Updating a score should not add a player.";
+    EXPECT_EQ(leaderboard.getEntry("a")->rank, 1) << "alice should now be first.";
+    EXPECT_EQ(leaderboard.getEntry("b")->rank, 2) << "bob should now be second.";
+}
+
+TEST(LeaderboardTest, TiesShareRank) {
+    Leaderboard leaderboard = Leaderboard();
+    leaderboard.setPlayer("a", "alice", 200);
+    leaderboard.setPlayer("b", "bob", 200);
+    leaderboard.setPlayer("c", "carol", 100);
+
+    std::vector<LeaderboardEntry> top = leaderboard.getTop(3);
+    ASSERT_EQ(top.size(), 3);
+    EXPECT_EQ(top[0].rank, 1) << "Equal scores should share the same rank.";
+    EXPECT_EQ(top[1].rank, 1) << "Equal scores should share the same rank.";
+    EXPECT_EQ(top[2].rank, 3) << "The rank after a tie should skip the tied places.";
+    EXPECT_EQ(leaderboard.getEntry("c")->rank, 3) << "getEntry should agree with getTop.";
+}
+
+TEST(LeaderboardTest, Around) {
+    Leaderboard leaderboard = Leaderboard();
+    for (int i = 0; i < 10; ++i) {
+        leaderboard.setPlayer(std::to_string(i), "player" + std::to_string(i), i * 10);
+    }
+
+    // player5 has score 50, ranked 5th (90, 80, 70, 60, 50, ...)
+    std::vector<LeaderboardEntry> around = leaderboard.getAround("5", 1);
+    ASSERT_EQ(around.size(), 3) << "There should be one player above and one below.";
+    EXPECT_EQ(around[0].userName, "player6");
+    EXPECT_EQ(around[1].userName, "player5");
+    EXPECT_EQ(around[1].rank, 5);
+    EXPECT_EQ(around[2].userName, "player4");
+
+    // the best player has nobody above it
+    around = leaderboard.getAround("9", 2);
+    ASSERT_EQ(around.size(), 3) << "The window should be cut at the top of the leaderboard.";
+    EXPECT_EQ(around[0].rank, 1);
+}
+
+TEST(LeaderboardTest, RenameAndRemove) {
+    Leaderboard leaderboard = Leaderboard();
+    leaderboard.setPlayer("a", "alice", 100);
+    leaderboard.setUserName("a", "alicia");
+    EXPECT_EQ(leaderboard.getTop(1)[0].userName, "alicia") << "Renaming should be visible right away.";
+
+    leaderboard.removePlayer("a");
+    EXPECT_EQ(leaderboard.size(), 0) << "The leaderboard should be empty after removing its only player.";
+    EXPECT_TRUE(leaderboard.getTop(1).empty());
+}
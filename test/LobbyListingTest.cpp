@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include "LobbyListing.hpp"
+
+#include <nlohmann/json.hpp>
+
+
+static LobbyState makeLobby(const std::string &lobbyID, GameMode gameMode, int players = 0) {
+    LobbyState state;
+    state.lobbyID = lobbyID;
+    state.port = 5051;
+    state.maxPlayers = MAX_LOBBY_SIZE;
+    state.gameMode = gameMode;
+    state.isPublic = true;
+    for (int i = 0; i < players; ++i) {
+        state.players["token-" + lobbyID + "-" + std::to_string(i)] = "player-" + std::to_string(i);
+        state.readyPlayers["token-" + lobbyID + "-" + std::to_string(i)] = false;
+    }
+    return state;
+}
+
+// every lobby of every page, in order
+static std::vector<std::string> allLobbyIDs(const LobbyListing &listing, std::optional<GameMode> gameMode) {
+    std::vector<std::string> ids;
+    const int pageCount = listing.getPage(gameMode, 0, NO_LOBBY_LIST_VERSION).pageCount;
+    for (int page = 0; page < pageCount; ++page) {
+        for (const auto &lobby: nlohmann::json::parse(listing.getPage(gameMode, page, NO_LOBBY_LIST_VERSION).lobbies)) {
+            ids.push_back(LobbyState::deserialize(lobby.dump()).lobbyID);
+        }
+    }
+    return ids;
+}
+
+TEST(LobbyListingTest, EmptyListingHasOneEmptyPage) {
+    LobbyListing listing;
+    listing.refresh([] { return std::vector<LobbyState>{}; });
+
+    const LobbyListing::Page page = listing.getPage(std::nullopt, 0, NO_LOBBY_LIST_VERSION);
+    EXPECT_FALSE(page.notModified);
+    EXPECT_EQ(page.pageCount, 1);
+    EXPECT_EQ(page.lobbies, "[]");
+}
+
+TEST(LobbyListingTest, NotModifiedForTheCurrentVersion) {
+    LobbyListing listing;
+    listing.refresh([] { return std::vector<LobbyState>{makeLobby("1000", GameMode::CLASSIC)}; });
+
+    const int version = listing.getVersion();
+    EXPECT_TRUE(listing.getPage(std::nullopt, 0, version).notModified) << "A client with the current version should get nothing.";
+    EXPECT_FALSE(listing.getPage(std::nullopt, 0, version - 1).notModified);
+}
+
+TEST(LobbyListingTest, OnlyRebuiltWhenDirty) {
+    LobbyListing listing;
+    int collected = 0;
+    auto collect = [&collected] {
+        ++collected;
+        return std::vector<LobbyState>{makeLobby("1000", GameMode::CLASSIC)};
+    };
+
+    listing.refresh(collect);
+    listing.refresh(collect);
+    EXPECT_EQ(collected, 1) << "The listing should not be rebuilt if nothing changed.";
+
+    const int version = listing.getVersion();
+    listing.markDirty();
+    listing.refresh(collect);
+    EXPECT_EQ(collected, 2);
+    EXPECT_EQ(listing.getVersion(), version) << "The same lobbies again should keep the version.";
+
+    listing.markDirty();
+    listing.refresh([] { return std::vector<LobbyState>{makeLobby("1000", GameMode::CLASSIC, 1)}; });
+    EXPECT_NE(listing.getVersion(), version) << "A lobby that changed should give a new version.";
+}
+
+TEST(LobbyListingTest, FilterByGameMode) {
+    LobbyListing listing;
+    listing.refresh([] {
+        return std::vector<LobbyState>{
+            makeLobby("3000", GameMode::ROYALE), makeLobby("1000", GameMode::CLASSIC), makeLobby("2000", GameMode::ROYALE)
+        };
+    });
+
+    EXPECT_EQ(allLobbyIDs(listing, std::nullopt), (std::vector<std::string>{"1000", "2000", "3000"})) << "Every lobby, sorted by ID.";
+    EXPECT_EQ(allLobbyIDs(listing, GameMode::ROYALE), (std::vector<std::string>{"2000", "3000"}));
+    EXPECT_TRUE(allLobbyIDs(listing, GameMode::DUEL).empty());
+    EXPECT_EQ(listing.getPage(GameMode::DUEL, 0, NO_LOBBY_LIST_VERSION).pageCount, 1);
+}
+
+TEST(LobbyListingTest, PagesFitTheBudget) {
+    std::vector<LobbyState> lobbies;
+    for (int i = 0; i < MAX_LOBBIES; ++i) {
+        lobbies.push_back(makeLobby(std::to_string(1000 + i), GameMode::CLASSIC, 3));
+    }
+
+    LobbyListing listing;
+    listing.refresh([&lobbies] { return lobbies; });
+
+    const int pageCount = listing.getPage(std::nullopt, 0, NO_LOBBY_LIST_VERSION).pageCount;
+    EXPECT_GT(pageCount, 1) << "That many lobbies should not fit in one page.";
+    for (int page = 0; page < pageCount; ++page) {
+        EXPECT_LE(listing.getPage(std::nullopt, page, NO_LOBBY_LIST_VERSION).lobbies.size(),
+                  static_cast<std::size_t>(LOBBY_LIST_PAGE_BYTES));
+    }
+    EXPECT_EQ(allLobbyIDs(listing, std::nullopt).size(), lobbies.size()) << "Every lobby should be in some page.";
+    EXPECT_EQ(listing.getPage(std::nullopt, pageCount, NO_LOBBY_LIST_VERSION).lobbies, "[]") << "A page past the end should be empty.";
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include "Logger.hpp"
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// the logger is shared by the whole process : every test sets what it needs
+// and writes to its own stream
+class LoggerTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override {
+        Logger::instance().setOutput(output);
+        Logger::instance().setFormat(LogFormat::TEXT);
+        Logger::instance().setLevel(MessageType::INFO);
+    }
+
+    void TearDown() override {
+        Logger::instance().setOutput(std::cout);
+        Logger::instance().setLevel(MessageType::INFO);
+    }
+
+    std::vector<std::string> lines() {
+        Logger::instance().flush();
+        std::vector<std::string> all;
+        std::istringstream stream(output.str());
+        for (std::string line; std::getline(stream, line);) {
+            all.push_back(line);
+        }
+        return all;
+    }
+
+    std::ostringstream output;
+};
+
+TEST_F(LoggerTest, TextLine) {
+    Logger::instance().log(MessageType::WARNING, LogComponent::GAME, "AB12CD",
+                           "player ", 3, " left");
+
+    const std::vector<std::string> all = lines();
+    ASSERT_EQ(all.size(), 1U);
+    // 2026-01-01T12:00:00.000Z [game-AB12CD] [WARNING] player 3 left
+    EXPECT_EQ(all[0].size(), 24 + std::string(" [game-AB12CD] [WARNING] player 3 left").size());
+    EXPECT_EQ(all[0][23], 'Z');
+    EXPECT_NE(all[0].find(" [game-AB12CD] [WARNING] player 3 left"), std::string::npos);
+}
+
+TEST_F(LoggerTest, LevelsPerComponent) {
+    Logger::instance().setLevel(LogComponent::GAME, MessageType::DEBUG);
+    Logger::instance().setLevel(LogComponent::LOBBY, MessageType::ERROR);
+
+    EXPECT_TRUE(Logger::instance().enabled(MessageType::DEBUG, LogComponent::GAME));
+    EXPECT_FALSE(Logger::instance().enabled(MessageType::DEBUG, LogComponent::LOBBY_SERVER));
+    EXPECT_FALSE(Logger::instance().enabled(MessageType::WARNING, LogComponent::LOBBY));
+    EXPECT_FALSE(Logger::instance().enabled(MessageType::NONE, LogComponent::GAME));
+
+    Logger::instance().log(MessageType::DEBUG, LogComponent::GAME, "", "written");
+    Logger::instance().log(MessageType::DEBUG, LogComponent::LOBBY_SERVER, "", "filtered");
+    Logger::instance().log(MessageType::WARNING, LogComponent::LOBBY, "", "filtered");
+    Logger::instance().log(MessageType::CRITICAL, LogComponent::LOBBY, "", "written");
+
+    const std::vector<std::string> all = lines();
+    ASSERT_EQ(all.size(), 2U);
+    EXPECT_NE(all[0].find("[game] [DEBUG] written"), std::string::npos);
+    EXPECT_NE(all[1].find("[lobby] [CRITICAL] written"), std::string::npos);
+}
+
+TEST_F(LoggerTest, ArgumentsAreCopied) {
+    // the writer formats later : what the caller changes afterwards is not
+    // in the line
+    std::string token = "before";
+    char buffer[] = "mutable";
+    char array[] = "array";
+    Logger::instance().log(MessageType::INFO, LogComponent::LOBBY_SERVER, "",
+                           token, ' ', static_cast<char*>(buffer), ' ', array);
+    token = "after";
+    buffer[0] = 'X';
+    array[0] = 'X'; // not a literal, so not kept as a pointer
+
+    const std::vector<std::string> all = lines();
+    ASSERT_EQ(all.size(), 1U);
+    EXPECT_NE(all[0].find("before mutable array"), std::string::npos);
+
+    // too big for a record : formatted right away, still written
+    const std::string big(300, 'a');
+    Logger::instance().log(MessageType::INFO, LogComponent::GAME, "", big, big, big, big, big, big);
+    EXPECT_NE(lines().back().find(big + big + big + big + big + big), std::string::npos);
+}
+
+TEST_F(LoggerTest, JsonLine) {
+    Logger::instance().setFormat(LogFormat::JSON);
+    Logger::instance().log(MessageType::ERROR, LogComponent::LOBBY, "XY",
+                           "quote \" and ", 1.5);
+
+    const std::vector<std::string> all = lines();
+    ASSERT_EQ(all.size(), 1U);
+    EXPECT_NE(all[0].find("\"component\":\"lobby\""), std::string::npos);
+    EXPECT_NE(all[0].find("\"context\":\"XY\""), std::string::npos);
+    EXPECT_NE(all[0].find("\"level\":\"ERROR\""), std::string::npos);
+    EXPECT_NE(all[0].find("\"message\":\"quote \\\" and 1.5\""), std::string::npos);
+}
+
+TEST_F(LoggerTest, ManyProducersKeepTheirOrder) {
+    // less than the capacity of the buffer : nothing lost, and each thread's
+    // lines come out in the order it logged them
+    constexpr int THREADS = 4;
+    constexpr int RECORDS = 500;
+    const std::uint64_t dropped = Logger::instance().droppedRecords();
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < THREADS; ++thread) {
+        threads.emplace_back([thread] {
+            for (int record = 0; record < RECORDS; ++record) {
+                Logger::instance().log(MessageType::INFO, LogComponent::GAME,
+                                       std::to_string(thread), record);
+                if (record % 100 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    std::vector<int> next(THREADS, 0);
+    int total = 0;
+    for (const std::string &line: lines()) {
+        const size_t context = line.find("[game-") + 6;
+        const int thread = line[context] - '0';
+        const int record = std::stoi(line.substr(line.find("[INFO] ") + 7));
+        EXPECT_EQ(record, next[static_cast<size_t>(thread)]);
+        next[static_cast<size_t>(thread)] = record + 1;
+        ++total;
+    }
+    EXPECT_EQ(total, THREADS * RECORDS);
+    EXPECT_EQ(Logger::instance().droppedRecords(), dropped);
+}
+
+TEST_F(LoggerTest, ParseNames) {
+    EXPECT_EQ(Logger::parseLevel("debug"), MessageType::DEBUG);
+    EXPECT_EQ(Logger::parseLevel("off"), MessageType::NONE);
+    EXPECT_FALSE(Logger::parseLevel("loud").has_value());
+    EXPECT_EQ(Logger::parseComponent("lobby-server"), LogComponent::LOBBY_SERVER);
+    EXPECT_FALSE(Logger::parseComponent("client").has_value());
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include "Metrics.hpp"
+
+#include <thread>
+#include <vector>
+
+
+TEST(MetricsTest, CounterFromManyThreads) {
+    Counter counter;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&counter] {
+            for (int j = 0; j < 10000; ++j) {
+                counter.increment();
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.value(), 40000);
+}
+
+TEST(MetricsTest, HistogramQuantiles) {
+    // 1 to 1000 us, each once : the quantiles are the values themselves,
+    // give or take the width of a bucket (1/16 of the magnitude)
+    Histogram histogram;
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(histogram.count(), 1000);
+    EXPECT_EQ(histogram.sum(), 500500);
+    EXPECT_NEAR(static_cast<double>(histogram.quantile(0.5)), 500.0, 500.0 / 16);
+    EXPECT_NEAR(static_cast<double>(histogram.quantile(0.99)), 990.0, 990.0 / 16);
+    EXPECT_GE(histogram.quantile(1.0), 1000);
+
+    // small values are exact
+    Histogram small;
+    small.record(3);
+    EXPECT_EQ(small.quantile(0.5), 3);
+}
+
+TEST(MetricsTest, HistogramHugeValues) {
+    Histogram histogram;
+    EXPECT_EQ(histogram.quantile(0.5), 0);
+
+    histogram.record(std::chrono::hours(24 * 365));
+    EXPECT_EQ(histogram.count(), 1);
+    EXPECT_GT(histogram.quantile(0.5), 0);
+}
+
+TEST(MetricsTest, RegistryRender) {
+    MetricsRegistry &registry = MetricsRegistry::instance();
+
+    Counter &requests = registry.counter("test_requests_total", "Requests", "method=\"A\"");
+    EXPECT_EQ(&requests, &registry.counter("test_requests_total", "Requests", "method=\"A\""));
+    requests.increment(3);
+
+    registry.gauge("test_players", "Players").set(-2);
+    registry.histogram("test_duration_seconds", "Duration").record(std::uint64_t{1500});
+    (void) registry.histogram("test_empty_seconds", "Nothing yet");
+
+    const std::string text = registry.render();
+    EXPECT_NE(text.find("# TYPE test_requests_total counter\n"), std::string::npos);
+    EXPECT_NE(text.find("test_requests_total{method=\"A\"} 3\n"), std::string::npos);
+    EXPECT_NE(text.find("test_players -2\n"), std::string::npos);
+    EXPECT_NE(text.find("# TYPE test_duration_seconds summary\n"), std::string::npos);
+    EXPECT_NE(text.find("test_duration_seconds_sum 0.0015\n"), std::string::npos);
+    EXPECT_NE(text.find("test_duration_seconds_count 1\n"), std::string::npos);
+    EXPECT_NE(text.find("test_empty_seconds{quantile=\"0.5\"} NaN\n"), std::string::npos);
+}
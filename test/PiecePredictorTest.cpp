@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+
+#include "GameMatrix.hpp"
+#include "PiecePredictor.hpp"
+#include "Tetromino.hpp"
+
+
+// what the server would send for this matrix
+static PlayerState stateFromMatrix(const GameMatrix &matrix, int lastInputSequence = 0) {
+    PlayerState state = PlayerState::generateEmptyState();
+    state.playerGrid = matrix.getBoardWithCurrentPiece();
+    state.currentTetro = matrix.getCurrent()->getPieceType();
+    state.currentPosition = matrix.getCurrent()->getPosition();
+    state.currentShape = matrix.getCurrent()->getShape();
+    state.lastInputSequence = lastInputSequence;
+    return state;
+}
+
+TEST(PiecePredictorTest, NoStateNoPrediction) {
+    PiecePredictor predictor;
+    EXPECT_FALSE(predictor.applyLocal(1, Action::MoveLeft)) << "Nothing can be predicted before the first state.";
+    EXPECT_FALSE(predictor.getPredictedGrid().has_value()) << "There should be no predicted grid yet.";
+}
+
+TEST(PiecePredictorTest, ReconcileWithoutPendingInputs) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::T));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+    ASSERT_TRUE(predictor.getPredictedGrid().has_value());
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "The prediction should be the server state.";
+}
+
+TEST(PiecePredictorTest, MovesMatchTheServer) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::L));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+
+    EXPECT_TRUE(predictor.applyLocal(1, Action::MoveLeft));
+    EXPECT_TRUE(predictor.applyLocal(2, Action::RotateRight));
+    EXPECT_TRUE(predictor.applyLocal(3, Action::MoveDown));
+
+    EXPECT_TRUE(server.tryMoveLeft());
+    EXPECT_TRUE(server.tryRotateRight());
+    EXPECT_TRUE(server.tryMoveDown());
+
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "The prediction should match what the server does.";
+}
+
+TEST(PiecePredictorTest, ReplaysUnacknowledgedInputs) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::I));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+    EXPECT_TRUE(predictor.applyLocal(1, Action::MoveRight));
+    EXPECT_TRUE(predictor.applyLocal(2, Action::MoveRight));
+
+    // the server only applied the first one, and its gravity moved the piece
+    EXPECT_TRUE(server.tryMoveRight());
+    EXPECT_TRUE(server.tryMoveDown());
+    predictor.reconcile(stateFromMatrix(server, 1));
+    EXPECT_EQ(predictor.pendingCount(), 1u) << "Only the second input should still be pending.";
+
+    EXPECT_TRUE(server.tryMoveRight());
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "The second input should be replayed on top of the server state.";
+
+    predictor.reconcile(stateFromMatrix(server, 2));
+    EXPECT_EQ(predictor.pendingCount(), 0u) << "Every input should be acknowledged.";
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece());
+}
+
+TEST(PiecePredictorTest, BlockedByTheBoard) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({0, 0}, PieceType::O));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+    EXPECT_FALSE(predictor.applyLocal(1, Action::MoveLeft)) << "The piece is against the wall, it should not move.";
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece());
+}
+
+TEST(PiecePredictorTest, ReversedControls) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::O));
+
+    PlayerState state = stateFromMatrix(server);
+    state.controlsReversed = true;
+
+    PiecePredictor predictor;
+    predictor.reconcile(state);
+    EXPECT_TRUE(predictor.applyLocal(1, Action::MoveLeft));
+
+    EXPECT_TRUE(server.tryMoveRight());
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "Left should move the piece right when the controls are reversed.";
+}
+
+TEST(PiecePredictorTest, StopsAfterUnpredictableInput) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::T));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+    EXPECT_FALSE(predictor.applyLocal(1, Action::UseBag)) << "The bag is only handled by the server.";
+    EXPECT_FALSE(predictor.applyLocal(2, Action::MoveLeft)) << "The piece may have changed, nothing should be predicted.";
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece());
+}
+
+TEST(PiecePredictorTest, GameOverClearsThePrediction) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::T));
+
+    PlayerState state = stateFromMatrix(server);
+    state.isGameOver = true;
+
+    PiecePredictor predictor;
+    predictor.reconcile(state);
+    EXPECT_FALSE(predictor.getPredictedGrid().has_value()) << "Nothing should be predicted once the game is over.";
+}
+
+TEST(PiecePredictorTest, InstantFallLocksThePiece) {
+    GameMatrix server = GameMatrix(10, 20);
+    server.setCurrent(Tetromino({4, 0}, PieceType::O));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+    EXPECT_TRUE(predictor.applyLocal(1, Action::InstantFall));
+
+    // what the server does once gravity finds the piece can't fall anymore
+    EXPECT_TRUE(server.tryInstantFall());
+    EXPECT_TRUE(server.tryPlaceCurrentPiece());
+    server.deleteCurrent();
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "The piece should be placed at the bottom.";
+
+    EXPECT_FALSE(predictor.applyLocal(2, Action::MoveLeft)) << "The next piece is unknown, nothing should be predicted.";
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "The placed piece should not move.";
+
+    // the server sends the next piece, the move is replayed on it
+    server.setCurrent(Tetromino({4, 0}, PieceType::T));
+    predictor.reconcile(stateFromMatrix(server, 1));
+    EXPECT_TRUE(server.tryMoveLeft());
+    EXPECT_EQ(*predictor.getPredictedGrid(), server.getBoardWithCurrentPiece()) << "The prediction should start again on the new piece.";
+}
+
+TEST(PiecePredictorTest, InstantFallClearsLines) {
+    GameMatrix server = GameMatrix(4, 6);
+    for (int x = 0; x < 2; ++x) {
+        server.getBoard()[4][x] = static_cast<int>(PieceType::I);
+        server.getBoard()[5][x] = static_cast<int>(PieceType::I);
+    }
+    server.setCurrent(Tetromino({2, 0}, PieceType::O));
+
+    PiecePredictor predictor;
+    predictor.reconcile(stateFromMatrix(server));
+    EXPECT_TRUE(predictor.applyLocal(1, Action::InstantFall));
+
+    const tetroMat predicted = *predictor.getPredictedGrid();
+    for (const auto &row: predicted) {
+        for (const int cell: row) {
+            EXPECT_EQ(cell, static_cast<int>(PieceType::None)) << "The two full lines should be cleared.";
+        }
+    }
+}
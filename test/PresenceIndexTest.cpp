@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+
+#include "PresenceIndex.hpp"
+
+
+TEST(PresenceIndexTest, UnknownUserIsOffline) {
+    PresenceIndex presence;
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::OFFLINE) << "A user without a session should be offline.";
+    EXPECT_FALSE(presence.hasSession("alice"));
+    EXPECT_FALSE(presence.getToken("alice").has_value());
+}
+
+TEST(PresenceIndexTest, SessionLifecycle) {
+    PresenceIndex presence;
+    EXPECT_EQ(presence.addSession("token-a", "alice", 10), StatusCode::SUCCESS);
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::IN_MENU) << "A new session should be in the menu.";
+    EXPECT_EQ(presence.getToken("alice"), "token-a");
+    EXPECT_EQ(presence.getUsername("token-a"), "alice");
+
+    EXPECT_TRUE(presence.removeSession("token-a"));
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::OFFLINE) << "A closed session should be offline.";
+    EXPECT_EQ(presence.size(), 0u);
+}
+
+TEST(PresenceIndexTest, ReplacedSessionForgetsOldToken) {
+    PresenceIndex presence;
+    EXPECT_EQ(presence.addSession("old", "alice", 10), StatusCode::SUCCESS);
+    EXPECT_EQ(presence.addSession("new", "alice", 10), StatusCode::SUCCESS_REPLACED_SESSION);
+    EXPECT_EQ(presence.getToken("alice"), "new");
+
+    presence.enter("old", ClientStatus::IN_LOBBY, "lobby");
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::IN_MENU) << "The old token should not move the user anymore.";
+
+    EXPECT_FALSE(presence.removeSession("old"));
+    EXPECT_TRUE(presence.hasSession("alice")) << "Removing the old token should not end the new session.";
+}
+
+TEST(PresenceIndexTest, EnterAndLeave) {
+    PresenceIndex presence;
+    ASSERT_EQ(presence.addSession("token-a", "alice", 10), StatusCode::SUCCESS);
+
+    presence.enter("token-a", ClientStatus::IN_LOBBY, "1234");
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::IN_LOBBY);
+
+    presence.enter("token-a", ClientStatus::IN_LOBBY, "5678");
+    presence.leave("token-a", "1234");
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::IN_LOBBY) << "Leaving an older lobby should not undo the newer join.";
+
+    presence.leave("token-a", "5678");
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::IN_MENU);
+}
+
+TEST(PresenceIndexTest, LeaveAllOnlyTouchesThatPlace) {
+    PresenceIndex presence;
+    ASSERT_EQ(presence.addSession("token-a", "alice", 10), StatusCode::SUCCESS);
+    ASSERT_EQ(presence.addSession("token-b", "bob", 10), StatusCode::SUCCESS);
+    ASSERT_EQ(presence.addSession("token-c", "carol", 10), StatusCode::SUCCESS);
+
+    presence.enter("token-a", ClientStatus::IN_GAME, "1234");
+    presence.enter("token-b", ClientStatus::IN_GAME, "1234");
+    presence.enter("token-c", ClientStatus::IN_GAME, "5678");
+
+    presence.leaveAll("1234", ClientStatus::IN_GAME);
+    EXPECT_EQ(presence.getStatus("alice"), ClientStatus::IN_MENU);
+    EXPECT_EQ(presence.getStatus("bob"), ClientStatus::IN_MENU);
+    EXPECT_EQ(presence.getStatus("carol"), ClientStatus::IN_GAME) << "Another game should not be touched.";
+}
+
+TEST(PresenceIndexTest, BatchStatusesKeepTheOrder) {
+    PresenceIndex presence;
+    ASSERT_EQ(presence.addSession("token-a", "alice", 10), StatusCode::SUCCESS);
+    ASSERT_EQ(presence.addSession("token-b", "bob", 10), StatusCode::SUCCESS);
+    presence.enter("token-b", ClientStatus::IN_LOBBY, "1234");
+
+    const std::vector<ClientStatus> statuses = presence.getStatuses({"bob", "nobody", "alice"});
+    ASSERT_EQ(statuses.size(), 3u);
+    EXPECT_EQ(statuses[0], ClientStatus::IN_LOBBY);
+    EXPECT_EQ(statuses[1], ClientStatus::OFFLINE);
+    EXPECT_EQ(statuses[2], ClientStatus::IN_MENU);
+}
+
+TEST(PresenceIndexTest, SessionLimit) {
+    PresenceIndex presence;
+    ASSERT_EQ(presence.addSession("token-a", "alice", 2), StatusCode::SUCCESS);
+    ASSERT_EQ(presence.addSession("token-b", "bob", 2), StatusCode::SUCCESS);
+    EXPECT_EQ(presence.addSession("token-c", "carol", 2), StatusCode::ERROR_MAX_PLAYERS_REACHED) << "The limit should be enforced.";
+    EXPECT_EQ(presence.addSession("token-a2", "alice", 2), StatusCode::SUCCESS_REPLACED_SESSION) << "Replacing a session should not count against the limit.";
+    EXPECT_EQ(presence.addSession("token-b", "dave", 2), StatusCode::ERROR_SESSION_ALREADY_EXISTS);
+    EXPECT_EQ(presence.size(), 2u);
+}
+
+TEST(PresenceIndexTest, QuietSessionsExpire) {
+    using namespace std::chrono_literals;
+    PresenceIndex presence(10s);
+    ASSERT_EQ(presence.addSession("token-a", "alice", 10), StatusCode::SUCCESS);
+    ASSERT_EQ(presence.addSession("token-b", "bob", 10), StatusCode::SUCCESS);
+    presence.enter("token-b", ClientStatus::IN_LOBBY, "1234");
+
+    const auto now = PresenceIndex::Clock::now();
+    EXPECT_TRUE(presence.touch("token-a", now + 5s));
+    EXPECT_FALSE(presence.touch("nobody", now + 5s));
+    EXPECT_TRUE(presence.expire(now + 5s).empty());
+
+    const std::vector<PresenceIndex::Expired> expired = presence.expire(now + 12s);
+    ASSERT_EQ(expired.size(), 1u) << "Only the session nothing was heard from should expire.";
+    EXPECT_EQ(expired[0].token, "token-b");
+    EXPECT_EQ(expired[0].username, "bob");
+    EXPECT_EQ(expired[0].status, ClientStatus::IN_LOBBY);
+    EXPECT_EQ(expired[0].placeID, "1234");
+    EXPECT_EQ(presence.getStatus("bob"), ClientStatus::OFFLINE);
+    EXPECT_TRUE(presence.hasSession("alice"));
+
+    EXPECT_EQ(presence.expire(now + 17s).size(), 1u) << "The touched session should expire 10s after its last touch.";
+    EXPECT_EQ(presence.size(), 0u);
+}
+
+TEST(PresenceIndexTest, EndedSessionsDoNotExpire) {
+    using namespace std::chrono_literals;
+    PresenceIndex presence(10s);
+    ASSERT_EQ(presence.addSession("token-a", "alice", 10), StatusCode::SUCCESS);
+    ASSERT_EQ(presence.addSession("token-a2", "alice", 10), StatusCode::SUCCESS_REPLACED_SESSION);
+    ASSERT_TRUE(presence.removeSession("token-a2"));
+
+    EXPECT_TRUE(presence.expire(PresenceIndex::Clock::now() + 20s).empty());
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include "Replay.hpp"
+#include "ReplaySimulator.hpp"
+
+#include <random>
+
+
+// three boards, a few hundred ticks of random inputs (malus and bonus
+// included, they are what uses the boards' random numbers)
+static std::string
+encodeMatch(const GameMode gameMode, const ReplayScore &leaveScore = {1, 0, 0},
+            const std::vector<ReplayScore> &endScores = {}) {
+    const std::vector<ReplayPlayer> players = {{"alice", 11}, {"bob", 22}, {"carol", 33}};
+    ReplayEncoder encoder(gameMode, 1700000000000, players, {2, 0, 1});
+
+    std::mt19937 inputs(7);
+    for (std::uint64_t tick = 0; tick < 600; ++tick) {
+        for (std::uint32_t player = 0; player < 3; ++player) {
+            if (player == 1 && tick >= 300) {
+                continue; // bob is gone
+            }
+            if (inputs() % 3 == 0) {
+                encoder.input(tick, player, static_cast<Action>(1 + inputs() % 11));
+            }
+        }
+        if (tick == 300) {
+            encoder.leave(tick, 1, leaveScore);
+        }
+    }
+    encoder.end(600, endScores);
+    return encoder.take();
+}
+
+TEST(ReplayTest, EncodeAndParse) {
+    ReplayEncoder encoder(GameMode::DUEL, 1700000000000, {{"alice", 1}, {"bob", 4000000000}}, {1, 0});
+    encoder.input(0, 0, Action::MoveLeft);
+    encoder.input(0, 1, Action::InstantFall);
+    encoder.input(130, 1, Action::UseBag);
+    encoder.leave(131, 1, {0, 1200, 14});
+    encoder.end(200, {{1, 40, 1}});
+
+    const std::optional<Replay> replay = Replay::parse(encoder.take());
+    ASSERT_TRUE(replay.has_value());
+    EXPECT_EQ(replay->gameMode, GameMode::DUEL);
+    EXPECT_EQ(replay->startTime, 1700000000000U);
+    ASSERT_EQ(replay->players.size(), 2U);
+    EXPECT_EQ(replay->players[1].name, "bob");
+    EXPECT_EQ(replay->players[1].seed, 4000000000U);
+    EXPECT_EQ(replay->tickOrder, (std::vector<std::uint32_t>{1, 0}));
+    EXPECT_TRUE(replay->complete);
+
+    ASSERT_EQ(replay->events.size(), 5U);
+    EXPECT_EQ(replay->events[1].action, Action::InstantFall);
+    EXPECT_EQ(replay->events[2].tick, 130U);
+    EXPECT_EQ(replay->events[3].type, ReplayEventType::LEAVE);
+    EXPECT_EQ(replay->events[3].after, 1U);
+    EXPECT_EQ(replay->events[3].scores[0].score, 1200);
+    EXPECT_EQ(replay->events[4].tick, 200U);
+    EXPECT_EQ(replay->events[4].scores[0].lines, 1);
+
+    // the encoder only gives what is new
+    EXPECT_TRUE(encoder.take().empty());
+}
+
+TEST(ReplayTest, TruncatedFileKeepsItsWholeRecords) {
+    const std::string bytes = encodeMatch(GameMode::CLASSIC);
+    const std::optional<Replay> whole = Replay::parse(bytes);
+    ASSERT_TRUE(whole.has_value());
+
+    const std::optional<Replay> truncated = Replay::parse(std::string_view(bytes).substr(0, bytes.size() - 7));
+    ASSERT_TRUE(truncated.has_value());
+    EXPECT_FALSE(truncated->complete);
+    EXPECT_LT(truncated->events.size(), whole->events.size());
+    EXPECT_EQ(truncated->events.back().tick, whole->events[truncated->events.size() - 1].tick);
+
+    EXPECT_FALSE(Replay::parse("not a replay").has_value());
+    EXPECT_FALSE(Replay::parse(std::string_view(bytes).substr(0, 10)).has_value());
+}
+
+TEST(ReplayTest, SimulationIsDeterministic) {
+    const std::optional<Replay> replay = Replay::parse(encodeMatch(GameMode::ROYALE));
+    ASSERT_TRUE(replay.has_value());
+
+    const std::optional<ReplayResult> first = ReplaySimulator::simulate(*replay);
+    const std::optional<ReplayResult> second = ReplaySimulator::simulate(*replay);
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(first->ticks, 600U);
+    EXPECT_TRUE(first->players[1].left);
+
+    for (std::size_t player = 0; player < 3; ++player) {
+        EXPECT_EQ(first->players[player].score, second->players[player].score);
+        EXPECT_EQ(first->players[player].lines, second->players[player].lines);
+        EXPECT_EQ(first->players[player].gameOver, second->players[player].gameOver);
+    }
+}
+
+TEST(ReplayTest, RecordedScoresAreVerified) {
+    const std::optional<Replay> unchecked = Replay::parse(encodeMatch(GameMode::ROYALE));
+    ASSERT_TRUE(unchecked.has_value());
+    const std::optional<ReplayResult> played = ReplaySimulator::simulate(*unchecked);
+    ASSERT_TRUE(played.has_value());
+
+    const ReplayScore left = {1, played->players[1].score, played->players[1].lines};
+    std::vector<ReplayScore> scores;
+    for (const std::uint32_t player: {0U, 2U}) {
+        scores.push_back({player, played->players[player].score, played->players[player].lines});
+    }
+    const std::optional<ReplayResult> good =
+        ReplaySimulator::simulate(*Replay::parse(encodeMatch(GameMode::ROYALE, left, scores)));
+    ASSERT_TRUE(good.has_value());
+    EXPECT_TRUE(good->verified());
+
+    scores[1].score += 40;
+    const std::optional<ReplayResult> bad =
+        ReplaySimulator::simulate(*Replay::parse(encodeMatch(GameMode::ROYALE, left, scores)));
+    ASSERT_TRUE(bad.has_value());
+    EXPECT_FALSE(bad->verified());
+    EXPECT_FALSE(bad->players[2].matches());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include "TimerWheel.hpp"
+
+#include <algorithm>
+
+using namespace std::chrono_literals;
+
+
+TEST(TimerWheelTest, ExpiresOnceTheDeadlineIsPassed) {
+    const auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(1s, 8, start);
+    wheel.schedule("a", start + 3s);
+    wheel.schedule("b", start + 5500ms);
+    EXPECT_EQ(wheel.size(), 2u);
+
+    EXPECT_TRUE(wheel.advance(start + 2s).empty());
+    EXPECT_EQ(wheel.advance(start + 3s), std::vector<std::string>{"a"});
+    EXPECT_TRUE(wheel.advance(start + 5s).empty());
+    EXPECT_EQ(wheel.advance(start + 6s), std::vector<std::string>{"b"}) << "A deadline should be seen at most one resolution late.";
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheelTest, PushedBackDeadlinesWait) {
+    const auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(1s, 8, start);
+    wheel.schedule("a", start + 2s);
+    wheel.schedule("a", start + 4s);
+
+    EXPECT_TRUE(wheel.advance(start + 3s).empty()) << "The old deadline should not count anymore.";
+    EXPECT_EQ(wheel.advance(start + 4s), std::vector<std::string>{"a"});
+}
+
+TEST(TimerWheelTest, EarlierDeadlinesAreSeenEarlier) {
+    const auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(1s, 8, start);
+    wheel.schedule("a", start + 6s);
+    wheel.schedule("a", start + 2s);
+
+    EXPECT_EQ(wheel.advance(start + 2s), std::vector<std::string>{"a"});
+    EXPECT_TRUE(wheel.advance(start + 7s).empty()) << "A key should expire only once.";
+}
+
+TEST(TimerWheelTest, DeadlinesFurtherThanOneTurn) {
+    const auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(1s, 4, start);
+    wheel.schedule("a", start + 10s);
+
+    for (int second = 1; second < 10; ++second) {
+        EXPECT_TRUE(wheel.advance(start + std::chrono::seconds(second)).empty()) << "at " << second << "s";
+    }
+    EXPECT_EQ(wheel.advance(start + 10s), std::vector<std::string>{"a"});
+}
+
+TEST(TimerWheelTest, LateAdvanceSeesEverything) {
+    const auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(1s, 4, start);
+    wheel.schedule("a", start + 1s);
+    wheel.schedule("b", start + 3s);
+    wheel.schedule("c", start + 30s);
+
+    std::vector<std::string> expired = wheel.advance(start + 20s);
+    std::ranges::sort(expired);
+    EXPECT_EQ(expired, (std::vector<std::string>{"a", "b"}));
+    EXPECT_EQ(wheel.advance(start + 30s), std::vector<std::string>{"c"});
+}
+
+TEST(TimerWheelTest, CancelledKeysNeverExpire) {
+    const auto start = TimerWheel::Clock::now();
+    TimerWheel wheel(1s, 8, start);
+    wheel.schedule("a", start + 2s);
+    wheel.cancel("a");
+    EXPECT_EQ(wheel.size(), 0u);
+    EXPECT_TRUE(wheel.advance(start + 3s).empty());
+
+    wheel.schedule("a", start + 5s);
+    wheel.clear();
+    EXPECT_TRUE(wheel.advance(start + 6s).empty());
+}
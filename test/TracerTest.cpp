@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include "Tracer.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <thread>
+
+
+TEST(TracerTest, NothingRecordedWhenOff) {
+    Tracer::instance().start();
+    Tracer::instance().stop();
+
+    {
+        const TraceSpan span("ignored", "test");
+    }
+
+    EXPECT_EQ(Tracer::instance().spanCount(), 0U);
+}
+
+TEST(TracerTest, ChromeTraceOfSeveralThreads) {
+    Tracer::instance().start();
+
+    {
+        const TraceSpan outer("outer", "test");
+        const TraceSpan inner("inner", "test");
+    }
+    std::thread worker([] {
+        Tracer::instance().setThreadName("worker \"1\"");
+        const TraceSpan span("work", "test");
+    });
+    worker.join();
+
+    Tracer::instance().stop();
+    EXPECT_EQ(Tracer::instance().spanCount(), 3U);
+
+    const nlohmann::json trace = nlohmann::json::parse(Tracer::instance().toChromeJson());
+    int complete = 0;
+    int workerThread = -1;
+    int workThread = -2;
+    for (const nlohmann::json &event: trace.at("traceEvents")) {
+        if (event.at("ph") == "M") {
+            EXPECT_EQ(event.at("args").at("name"), "worker \"1\"");
+            workerThread = event.at("tid").get<int>();
+        } else {
+            EXPECT_EQ(event.at("ph"), "X");
+            EXPECT_EQ(event.at("cat"), "test");
+            EXPECT_GE(event.at("ts").get<double>(), 0.0);
+            EXPECT_GE(event.at("dur").get<double>(), 0.0);
+            if (event.at("name") == "work") {
+                workThread = event.at("tid").get<int>();
+            }
+            ++complete;
+        }
+    }
+    EXPECT_EQ(complete, 3);
+    EXPECT_EQ(workerThread, workThread);
+
+    // a new trace starts empty
+    Tracer::instance().start();
+    Tracer::instance().stop();
+    EXPECT_EQ(Tracer::instance().spanCount(), 0U);
+}
+
+TEST(TracerTest, MethodNames) {
+    EXPECT_STREQ(Tracer::methodName(ServerMethods::KEY_STROKE), "KEY_STROKE");
+    // always the same pointer, the spans keep it
+    EXPECT_EQ(Tracer::methodName(ServerMethods::KEY_STROKE),
+              Tracer::methodName(ServerMethods::KEY_STROKE));
+}
+
+TEST(TracerTest, ThreadsThatAreGoneAreForgotten) {
+    // the game threads are named even when nobody traces : a thread that
+    // recorded nothing must not stay in the trace once it's gone
+    std::thread gone([] { Tracer::instance().setThreadName("gone"); });
+    gone.join();
+    std::thread next([] { Tracer::instance().setThreadName("next"); });
+    next.join();
+
+    const std::string trace = Tracer::instance().toChromeJson();
+    EXPECT_EQ(trace.find("\"gone\""), std::string::npos);
+    EXPECT_NE(trace.find("\"next\""), std::string::npos);
+}